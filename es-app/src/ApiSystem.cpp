@@ -14,6 +14,7 @@
 #include "utils/ThreadPool.h"
 #include "RetroAchievements.h"
 #include "utils/ZipFile.h"
+#include "utils/md5.h"
 #include "Paths.h"
 
 #include <stdlib.h>
@@ -22,6 +23,7 @@
 #include <fstream>
 #include <chrono>
 #include <thread>
+#include <atomic>
 #include <stdio.h>
 #include <string.h>
 #include <sys/types.h>
@@ -927,75 +929,176 @@ std::pair<std::string, int> ApiSystem::uninstallBatoceraBezel(std::string bezels
 	return executeScript("batocera-es-thebezelproject remove " + bezelsystem, func);
 }
 
-std::string ApiSystem::getMD5(const std::string fileName, bool fromZipContents)
+// Returns the single rom of a zip archive, ignoring .txt files. Empty if there are several files
+static std::string getZipRomName(Utils::Zip::ZipFile& file)
 {
-	LOG(LogDebug) << "getMD5 >> " << fileName;
+	std::string romName;
 
-	// 7za x -so test.7z | md5sum
-	std::string ext = Utils::String::toLower(Utils::FileSystem::getExtension(fileName));
-	if (ext == ".zip" && fromZipContents)
+	for (auto name : file.namelist())
 	{
-		Utils::Zip::ZipFile file;
-		if (file.load(fileName))
+		if (Utils::FileSystem::getExtension(name) != ".txt" && !Utils::String::endsWith(name, "/"))
 		{
-			std::string romName;
+			if (!romName.empty())
+				return "";
 
-			for (auto name : file.namelist())
+			romName = name;
+		}
+	}
+
+	return romName;
+}
+
+// Returns the single rom of a 7z archive, ignoring .txt files. Empty if there are several files
+std::string ApiSystem::getSevenZipRomName(const std::string& fileName)
+{
+	std::string romName;
+	std::string path;
+	bool entries = false;
+
+	auto lines = executeEnumerationScript(getSevenZipCommand() + " l -slt \"" + fileName + "\"");
+	lines.push_back("");
+
+	for (auto line : lines)
+	{
+		// The properties of the archive come before the separator, then each entry is a block ended by an empty line
+		if (!entries)
+		{
+			entries = Utils::String::startsWith(line, "----------");
+			continue;
+		}
+
+		if (Utils::String::startsWith(line, "Path = "))
+			path = line.substr(7);
+		else if (line == "Folder = +" || (Utils::String::startsWith(line, "Attributes = ") && line.find('D') != std::string::npos))
+			path.clear();
+		else if (Utils::String::trim(line).empty() && !path.empty())
+		{
+			if (Utils::FileSystem::getExtension(path) != ".txt")
 			{
-				if (Utils::FileSystem::getExtension(name) != ".txt" && !Utils::String::endsWith(name, "/"))
-				{
-					if (!romName.empty())
-					{
-						romName = "";
-						break;
-					}
+				if (!romName.empty())
+					return "";
 
-					romName = name;
-				}
+				romName = path;
 			}
 
-			if (!romName.empty())
-				return file.getFileMd5(romName);
+			path.clear();
 		}
 	}
 
-#if !WIN32
-	if (fromZipContents && ext == ".7z")
+	return romName;
+}
+
+bool ApiSystem::readArchivedRom(const std::string& fileName, const std::function<bool(const void* data, size_t size)>& onData)
+{
+	std::string ext = Utils::String::toLower(Utils::FileSystem::getExtension(fileName));
+
+	if (ext == ".zip")
+	{
+		Utils::Zip::ZipFile file;
+		if (!file.load(fileName))
+			return false;
+
+		std::string romName = getZipRomName(file);
+		if (romName.empty())
+			return false;
+
+		Utils::Zip::zip_callback func = [](void *pOpaque, unsigned long long ofs, const void *pBuf, size_t n) -> size_t
+		{
+			auto onData = (const std::function<bool(const void* data, size_t size)>*) pOpaque;
+			return (*onData)(pBuf, n) ? n : 0;
+		};
+
+		return file.readBuffered(romName, func, (void*) &onData);
+	}
+
+	if (ext != ".7z")
+		return false;
+
+	// "x -so" writes all the files of the archive one after the other : the rom is selected by its name
+	std::string romName = getSevenZipRomName(fileName);
+	if (romName.empty())
+		return false;
+
+	// The name comes from the archive : it's given in a list file, never on the command line, and without wildcard matching
+	static std::atomic<unsigned int> listFileId(0);
+	std::string listFile = Utils::FileSystem::combine(Utils::FileSystem::getTempPath(), "7zlist_" + std::to_string(++listFileId) + ".txt");
+	Utils::FileSystem::writeAllText(listFile, romName + "\n");
+
+	auto cmd = getSevenZipCommand() + " x -so -spd -scsUTF-8 \"" + fileName + "\" \"@" + listFile + "\"";
+
+	LOG(LogDebug) << "ApiSystem::readArchivedRom -> " << cmd;
+
+#if WIN32
+	FILE* pipe = popen(cmd.c_str(), "rb");
+#else
+	FILE* pipe = popen(cmd.c_str(), "r");
+#endif
+	if (pipe == NULL)
+	{
+		Utils::FileSystem::removeFile(listFile);
+		return false;
+	}
+
+	std::vector<char> buffer(256 * 1024);
+
+	bool result = true;
+	size_t total = 0;
+	size_t read;
+
+	while ((read = fread(buffer.data(), 1, buffer.size(), pipe)) > 0)
 	{
-		auto cmd = getSevenZipCommand() + " x -so \"" + fileName + "\" | md5sum";
-		auto ret = executeEnumerationScript(cmd);
-		if (ret.size() == 1 && ret.cbegin()->length() >= 32)
-			return ret.cbegin()->substr(0, 32);
+		total += read;
+
+		if (!onData(buffer.data(), read))
+		{
+			result = false;
+			break;
+		}
 	}
+
+	int exitCode = pclose(pipe);
+	Utils::FileSystem::removeFile(listFile);
+
+#if WIN32
+	return result && total > 0 && exitCode == 0;
+#else
+	return result && total > 0 && WIFEXITED(exitCode) && WEXITSTATUS(exitCode) == 0;
 #endif
+}
+
+std::string ApiSystem::getMD5(const std::string fileName, bool fromZipContents)
+{
+	LOG(LogDebug) << "getMD5 >> " << fileName;
+
+	std::string ext = Utils::String::toLower(Utils::FileSystem::getExtension(fileName));
+	if (ext == ".zip" && fromZipContents)
+	{
+		Utils::Zip::ZipFile file;
+		if (file.load(fileName))
+		{
+			std::string romName = getZipRomName(file);
+			if (!romName.empty())
+				return file.getFileMd5(romName);
+		}
+	}
 
-	std::string contentFile = fileName;
 	std::string ret;
-	std::string tmpZipDirectory;
 
+	// The rom is decompressed straight into the hash, nothing is written to disk
 	if (fromZipContents && ext == ".7z")
 	{
-		tmpZipDirectory = Utils::FileSystem::combine(Utils::FileSystem::getTempPath(), Utils::FileSystem::getStem(fileName));
-		Utils::FileSystem::deleteDirectoryFiles(tmpZipDirectory);
+		MD5 md5;
 
-		if (unzipFile(fileName, tmpZipDirectory))
+		if (readArchivedRom(fileName, [&md5](const void* data, size_t size) { md5.update((const char*) data, size); return true; }))
 		{
-			auto fileList = Utils::FileSystem::getDirContent(tmpZipDirectory, true);
-
-			std::vector<std::string> res;
-			std::copy_if(fileList.cbegin(), fileList.cend(), std::back_inserter(res), [](const std::string file) { return Utils::FileSystem::getExtension(file) != ".txt";  });
-		
-			if (res.size() == 1)
-				contentFile = *res.cbegin();
+			md5.finalize();
+			ret = md5.hexdigest();
 		}
-
-		// if there's no file or many files ? get md5 of archive
 	}
 
-	ret = Utils::FileSystem::getFileMd5(contentFile);
-
-	if (!tmpZipDirectory.empty())
-		Utils::FileSystem::deleteDirectoryFiles(tmpZipDirectory, true);
+	// if there's no file or many files ? get md5 of archive
+	if (ret.empty())
+		ret = Utils::FileSystem::getFileMd5(fileName);
 
 	LOG(LogDebug) << "getMD5 << " << ret;
 
@@ -1031,22 +1134,7 @@ std::string ApiSystem::getCRC32(std::string fileName, bool fromZipContents)
 		Utils::Zip::ZipFile file;
 		if (file.load(fileName))
 		{
-			std::string romName;
-
-			for (auto name : file.namelist())
-			{
-				if (Utils::FileSystem::getExtension(name) != ".txt" && !Utils::String::endsWith(name, "/"))
-				{
-					if (!romName.empty())
-					{
-						romName = "";
-						break;
-					}
-
-					romName = name;
-				}
-			}
-
+			std::string romName = getZipRomName(file);
 			if (!romName.empty())
 				return file.getFileCrc(romName);
 		}
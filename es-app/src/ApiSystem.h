@@ -202,6 +202,10 @@ public:
 
 	virtual bool unzipFile(const std::string fileName, const std::string destFolder = "", const std::function<bool(const std::string)>& shouldExtract = nullptr);
 
+	// Streams the decompressed rom of a zip or 7z archive to onData, without writing it to disk. onData returns false to abort.
+	// Fails when the archive doesn't hold a single rom (.txt files are ignored)
+	virtual bool readArchivedRom(const std::string& fileName, const std::function<bool(const void* data, size_t size)>& onData);
+
 	virtual int getPdfPageCount(const std::string& fileName);
 	virtual std::vector<std::string> extractPdfImages(const std::string& fileName, int pageIndex = -1, int pageCount = 1, int quality = 0);
 
@@ -250,6 +254,8 @@ protected:
 	virtual bool executeScript(const std::string command);  
 	virtual std::pair<std::string, int> executeScript(const std::string command, const std::function<void(const std::string)>& func);
 	virtual std::vector<std::string> executeEnumerationScript(const std::string command);
+
+	std::string getSevenZipRomName(const std::string& fileName);
 	
 	void getBatoceraThemesImages(std::vector<BatoceraTheme>& items);
 	std::string getUpdateUrl();
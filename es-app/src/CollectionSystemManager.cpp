@@ -22,11 +22,268 @@
 #include "utils/ThreadPool.h"
 #include "Genres.h"
 #include "Paths.h"
+#include <mutex>
 
 std::string myCollectionsName = "collections";
 
 #define LAST_PLAYED_MAX	50
 
+static bool hasPlayers(std::string players, int val)
+{
+	if (players.empty())
+		return false;
+
+	int min = -1;
+
+	auto split = players.rfind("+");
+	if (split != std::string::npos)
+		players = Utils::String::replace(players, "+", "-999");
+
+	split = players.rfind("-");
+	if (split != std::string::npos)
+	{
+		min = atoi(players.substr(0, split).c_str());
+		players = players.substr(split + 1);
+	}
+
+	int max = atoi(players.c_str());
+	return min <= 0 ? (val == max) : (min <= val && val <= max);
+}
+
+// Auto collection memberships, computed with a single walk of the game systems instead of one walk per collection.
+// Each game is classified once into all the auto collection types it belongs to, then updated when its metadata changes
+class AutoCollectionIndex
+{
+public:
+	AutoCollectionIndex() : mBuilt(false) { }
+
+	std::vector<FileData*> getGames(int type)
+	{
+		std::unique_lock<std::mutex> lock(mLock);
+		build();
+
+		auto it = mGames.find(type);
+		if (it == mGames.cend())
+			return std::vector<FileData*>();
+
+		return it->second;
+	}
+
+	bool isMember(FileData* game, int type)
+	{
+		std::unique_lock<std::mutex> lock(mLock);
+		build();
+
+		auto it = mMemberships.find(game);
+		if (it == mMemberships.cend())
+			return false;
+
+		return std::find(it->second.cbegin(), it->second.cend(), type) != it->second.cend();
+	}
+
+	// Only the lists of the collection types the game joins or leaves are changed
+	void update(FileData* game)
+	{
+		std::unique_lock<std::mutex> lock(mLock);
+		if (!mBuilt)
+			return;
+
+		std::vector<int> types;
+		if (std::find(SystemData::sSystemVector.cbegin(), SystemData::sSystemVector.cend(), game->getSystem()) != SystemData::sSystemVector.cend())
+			types = getTypes(game, getSystemInfo(game->getSystem()));
+
+		auto& current = mMemberships[game];
+		if (types == current)
+			return;
+
+		for (auto type : current)
+			if (std::find(types.cbegin(), types.cend(), type) == types.cend())
+				removeGame(type, game);
+
+		for (auto type : types)
+			if (std::find(current.cbegin(), current.cend(), type) == current.cend())
+				mGames[type].push_back(game);
+
+		if (types.empty())
+			mMemberships.erase(game);
+		else
+			current = types;
+	}
+
+	// Settings or systems have changed : memberships are computed again when a collection needs to be populated
+	void reset()
+	{
+		std::unique_lock<std::mutex> lock(mLock);
+
+		mBuilt = false;
+		mArcadeSystemTypes.clear();
+		mSystemInfos.clear();
+		mGames.clear();
+		mMemberships.clear();
+	}
+
+	void remove(FileData* game)
+	{
+		std::unique_lock<std::mutex> lock(mLock);
+
+		auto it = mMemberships.find(game);
+		if (it == mMemberships.cend())
+			return;
+
+		for (auto type : it->second)
+			removeGame(type, game);
+
+		mMemberships.erase(it);
+	}
+
+private:
+	struct SystemInfo
+	{
+		bool isHidden;
+		bool isArcade;
+		std::vector<std::string> hiddenExts;
+	};
+
+	SystemInfo& getSystemInfo(SystemData* system)
+	{
+		auto it = mSystemInfos.find(system);
+		if (it != mSystemInfos.cend())
+			return it->second;
+
+		SystemInfo& info = mSystemInfos[system];
+
+		info.isHidden = !system->isGameSystem() || system->isCollection() ||
+			(!mHiddenSystemsShowGames && std::find(mHiddenSystems.cbegin(), mHiddenSystems.cend(), system->getName()) != mHiddenSystems.cend());
+
+		info.isArcade = system->hasPlatformId(PlatformIds::ARCADE);
+
+		for (auto ext : Utils::String::split(Settings::getInstance()->getString(system->getName() + ".HiddenExt"), ';'))
+			info.hiddenExts.push_back("." + Utils::String::toLower(ext));
+
+		return info;
+	}
+
+	std::vector<int> getTypes(FileData* game, SystemInfo& info)
+	{
+		std::vector<int> types;
+
+		if (info.isHidden || !CollectionSystemManager::get()->includeFileInAutoCollections(game))
+			return types;
+
+		if (info.hiddenExts.size() > 0)
+		{
+			std::string extlow = Utils::String::toLower(Utils::FileSystem::getExtension(game->getFileName()));
+			if (std::find(info.hiddenExts.cbegin(), info.hiddenExts.cend(), extlow) != info.hiddenExts.cend())
+				return types;
+		}
+
+		bool allGames = true;
+#ifdef _ENABLEEMUELEC
+		allGames = !(game->getSystemName() == "setup") && !(game->getSystemName() == "imageviewer") && !(game->getSystemName() == "mediaplayer");
+#endif
+		if (allGames)
+			types.push_back(AUTO_ALL_GAMES);
+
+		if (game->isVerticalArcadeGame())
+			types.push_back(AUTO_VERTICALARCADE);
+
+		if (game->isLightGunGame())
+			types.push_back(AUTO_LIGHTGUN);
+
+		if (game->hasCheevos())
+			types.push_back(AUTO_RETROACHIEVEMENTS);
+
+		if (game->getMetadata(MetaDataId::PlayCount) > "0")
+			types.push_back(AUTO_LAST_PLAYED);
+		else
+			types.push_back(AUTO_NEVER_PLAYED);
+
+		if (game->getFavorite())
+			types.push_back(AUTO_FAVORITES);
+
+		std::string players = game->getMetadata(MetaDataId::Players);
+		if (hasPlayers(players, 2))
+			types.push_back(AUTO_AT2PLAYERS);
+
+		if (hasPlayers(players, 4))
+			types.push_back(AUTO_AT4PLAYERS);
+
+		if (info.isArcade)
+		{
+			types.push_back(AUTO_ARCADE);
+
+			auto arcade = mArcadeSystemTypes.find(game->getMetadata(MetaDataId::ArcadeSystemName));
+			if (arcade != mArcadeSystemTypes.cend())
+				types.push_back(arcade->second);
+		}
+
+		for (auto id : Utils::String::split(game->getMetadata(MetaDataId::GenreIds), ',', true))
+		{
+			int genreId = atoi(id.c_str());
+			if (std::to_string(genreId) == id && std::find(types.cbegin(), types.cend(), 10000 + genreId) == types.cend())
+				types.push_back(10000 + genreId);
+		}
+
+		return types;
+	}
+
+	void build()
+	{
+		if (mBuilt)
+			return;
+
+		mBuilt = true;
+
+		mHiddenSystemsShowGames = Settings::HiddenSystemsShowGames();
+		mHiddenSystems = Utils::String::split(Settings::getInstance()->getString("HiddenSystems"), ';');
+
+		for (auto arcade : PlatformIds::ArcadeSystems)
+			mArcadeSystemTypes[arcade.second.first] = 1000 + arcade.first;
+
+		for (auto& system : SystemData::sSystemVector)
+		{
+			SystemInfo& info = getSystemInfo(system);
+			if (info.isHidden)
+				continue;
+
+			for (auto& game : system->getRootFolder()->getFilesRecursive(GAME))
+			{
+				if (system->isGroupSystem() && game->getSystem() != system)
+					continue;
+
+				auto types = getTypes(game, info);
+				if (types.empty())
+					continue;
+
+				for (auto type : types)
+					mGames[type].push_back(game);
+
+				mMemberships[game] = types;
+			}
+		}
+	}
+
+	void removeGame(int type, FileData* game)
+	{
+		auto& games = mGames[type];
+
+		auto it = std::find(games.begin(), games.end(), game);
+		if (it != games.end())
+			games.erase(it);
+	}
+
+	std::mutex mLock;
+	bool mBuilt;
+
+	bool mHiddenSystemsShowGames;
+	std::vector<std::string> mHiddenSystems;
+	std::map<std::string, int> mArcadeSystemTypes;
+	std::unordered_map<SystemData*, SystemInfo> mSystemInfos;
+
+	std::unordered_map<int, std::vector<FileData*>> mGames;
+	std::unordered_map<FileData*, std::vector<int>> mMemberships;
+};
+
 /* Handling the getting, initialization, deinitialization, saving and deletion of
  * a CollectionSystemManager Instance */
 CollectionSystemManager* CollectionSystemManager::sInstance = NULL;
@@ -104,6 +361,8 @@ std::vector<CollectionSystemDecl> CollectionSystemManager::getSystemDecls()
 
 CollectionSystemManager::CollectionSystemManager(Window* window) : mWindow(window)
 {
+	mAutoCollectionIndex = new AutoCollectionIndex();
+
 	// create a map
 	std::vector<CollectionSystemDecl> tempSystemDecl = getSystemDecls();
 
@@ -153,6 +412,8 @@ CollectionSystemManager::~CollectionSystemManager()
 		mCollectionEnvData = nullptr;
 	}
 
+	delete mAutoCollectionIndex;
+
 	sInstance = NULL;
 }
 
@@ -330,6 +591,8 @@ void CollectionSystemManager::updateSystemsList()
 	// remove all Collection Systems
 	removeCollectionsFromDisplayedSystems();
 
+	mAutoCollectionIndex->reset();
+
 	std::unordered_map<std::string, FileData*> map;
 	getAllGamesCollection()->getRootFolder()->createChildrenByFilenameMap(map);
 
@@ -378,6 +641,8 @@ void CollectionSystemManager::refreshCollectionSystems(FileData* file)
 	if (!file->getSystem()->isGameSystem() || file->getType() != GAME)
 		return;
 
+	mAutoCollectionIndex->update(file);
+
 	std::map<std::string, CollectionSystemData> allCollections;
 	allCollections.insert(mAutoCollectionSystemsData.cbegin(), mAutoCollectionSystemsData.cend());
 	allCollections.insert(mCustomCollectionSystemsData.cbegin(), mCustomCollectionSystemsData.cend());
@@ -406,16 +671,16 @@ void CollectionSystemManager::updateCollectionSystem(FileData* file, CollectionS
 		curSys->removeFromIndex(collectionEntry);
 
 		// found and we are removing
-		if (name == "favorites" && !file->getFavorite())
+		if (!sysData.decl.isCustom && !mAutoCollectionIndex->isMember(file, sysData.decl.type))
 		{
-			// need to check if still marked as favorite, if not remove
+			// need to check if still a member, if not remove
 			auto view = ViewController::get()->getGameListView(curSys, false);
 			if (view != nullptr)
 				view.get()->remove(collectionEntry);
 			else
 				delete collectionEntry;
 
-			// Send an event when removing from favorites
+			// Send an event when removing from an auto collection
 			ViewController::get()->onFileChanged(file, FILE_METADATA_CHANGED);
 		}
 		else
@@ -428,8 +693,7 @@ void CollectionSystemManager::updateCollectionSystem(FileData* file, CollectionS
 	else
 	{
 		// we didn't find it here - we need to check if we should add it
-		if (name == "recent" && file->getMetadata(MetaDataId::PlayCount) > "0" && includeFileInAutoCollections(file) ||
-			name == "favorites" && file->getFavorite())
+		if (!sysData.decl.isCustom && mAutoCollectionIndex->isMember(file, sysData.decl.type))
 		{
 			CollectionFileData* newGame = new CollectionFileData(file, curSys);
 			rootFolder->addChild(newGame);
@@ -485,6 +749,8 @@ void CollectionSystemManager::trimCollectionCount(FolderData* rootFolder, int li
 // deletes all collection files from collection systems related to the source file
 void CollectionSystemManager::deleteCollectionFiles(FileData* file)
 {
+	mAutoCollectionIndex->remove(file);
+
 	// collection files use the full path as key, to avoid clashes
 	std::string key = file->getFullPath();
 
@@ -924,118 +1190,11 @@ void CollectionSystemManager::populateAutoCollection(CollectionSystemData* sysDa
 	CollectionSystemDecl sysDecl = sysData->decl;
 	FolderData* rootFolder = newSys->getRootFolder();
 
-	bool hiddenSystemsShowGames = Settings::HiddenSystemsShowGames();
-	auto hiddenSystems = Utils::String::split(Settings::getInstance()->getString("HiddenSystems"), ';');
-
-	for (auto& system : SystemData::sSystemVector)
+	for (auto game : mAutoCollectionIndex->getGames(sysDecl.type))
 	{
-		// we won't iterate all collections
-		if (!system->isGameSystem() || system->isCollection())
-			continue;
-
-		if (!hiddenSystemsShowGames && std::find(hiddenSystems.cbegin(), hiddenSystems.cend(), system->getName()) != hiddenSystems.cend())
-			continue;
-
-		std::vector<PlatformIds::PlatformId> platforms = system->getPlatformIds();
-		bool isArcade = std::find(platforms.begin(), platforms.end(), PlatformIds::ARCADE) != platforms.end();
-
-		std::vector<std::string> hiddenExts;
-		for (auto ext : Utils::String::split(Settings::getInstance()->getString(system->getName() + ".HiddenExt"), ';'))
-			hiddenExts.push_back("." + Utils::String::toLower(ext));
-
-		std::vector<FileData*> files = system->getRootFolder()->getFilesRecursive(GAME);
-		for (auto& game : files)
-		{
-			if (system->isGroupSystem() && game->getSystem() != system)
-				continue;
-
-			bool include = includeFileInAutoCollections(game);
-			if (!include)
-				continue;
-
-			if (hiddenExts.size() > 0 && game->getType() == GAME)
-			{
-				std::string extlow = Utils::String::toLower(Utils::FileSystem::getExtension(game->getFileName()));
-				if (std::find(hiddenExts.cbegin(), hiddenExts.cend(), extlow) != hiddenExts.cend())
-					continue;
-			}
-
-			switch (sysDecl.type)
-			{
-			case AUTO_ALL_GAMES:
-#ifdef _ENABLEEMUELEC
-				include = !(game->getSystemName() == "setup") && !(game->getSystemName() == "imageviewer") && !(game->getSystemName() == "mediaplayer");
-#endif
-            break;
-			case AUTO_VERTICALARCADE:
-				include = game->isVerticalArcadeGame();
-				break;
-			case AUTO_LIGHTGUN:
-				include = game->isLightGunGame();
-				break;
-			case AUTO_RETROACHIEVEMENTS:
-				include = game->hasCheevos();
-				break;
-			case AUTO_LAST_PLAYED:
-				include = game->getMetadata(MetaDataId::PlayCount) > "0";
-				break;
-			case AUTO_NEVER_PLAYED:
-				include = !(game->getMetadata(MetaDataId::PlayCount) > "0");
-				break;
-			case AUTO_FAVORITES:
-				// we may still want to add files we don't want in auto collections in "favorites"
-				include = game->getFavorite();
-				break;
-			case AUTO_ARCADE:
-				include = isArcade;
-				break;
-			case AUTO_AT2PLAYERS: 
-			case AUTO_AT4PLAYERS:
-			{
-				std::string players = game->getMetadata(MetaDataId::Players);
-				if (players.empty())
-					include = false;
-				else
-				{
-					int min = -1;
-
-					auto split = players.rfind("+");
-					if (split != std::string::npos)
-						players = Utils::String::replace(players, "+", "-999");
-
-					split = players.rfind("-");
-					if (split != std::string::npos)
-					{
-						min = atoi(players.substr(0, split).c_str());
-						players = players.substr(split + 1);
-					}
-
-					int max = atoi(players.c_str());
-					int val = (sysDecl.type == AUTO_AT2PLAYERS ? 2 : 4);
-					include = min <= 0 ? (val == max) : (min <= val && val <= max);
-				}
-			}
-			break;
-
-			default:
-				if (!sysDecl.isCustom && !sysDecl.displayIfEmpty)
-				{
-					if (sysDecl.isGenreCollection())
-						include = Genres::genreExists(&game->getMetadata(), ((int)sysDecl.type) - 10000);
-					else if (sysDecl.isArcadeSubSystem())
-						include = isArcade && game->getMetadata(MetaDataId::ArcadeSystemName) == sysDecl.themeFolder;
-				}
-
-				break;
-			}
-
-			if (include)
-			{
-				CollectionFileData* newGame = new CollectionFileData(game, newSys);
-				rootFolder->addChild(newGame);
-				newSys->addToIndex(newGame);
-			}
-		}
+		CollectionFileData* newGame = new CollectionFileData(game, newSys);
+		rootFolder->addChild(newGame);
+		newSys->addToIndex(newGame);
 	}
 
 	if (sysDecl.type == AUTO_LAST_PLAYED)
@@ -1170,7 +1329,8 @@ void CollectionSystemManager::removeCollectionsFromDisplayedSystems()
 	// clear index
 	mCustomCollectionsBundle->resetIndex();
 	// remove view so it's re-created as needed
-	ViewController::get()->removeGameListView(mCustomCollectionsBundle);
+	if (ViewController::get() != nullptr)
+		ViewController::get()->removeGameListView(mCustomCollectionsBundle);
 }
 
 void CollectionSystemManager::addEnabledCollectionsToDisplayedSystems(std::map<std::string, CollectionSystemData>* colSystemData, std::unordered_map<std::string, FileData*>* pMap)
@@ -12,6 +12,7 @@ class FolderData;
 class SystemData;
 class Window;
 class CollectionFilter;
+class AutoCollectionIndex;
 struct SystemEnvironmentData;
 
 enum CollectionSystemType
@@ -135,6 +136,9 @@ private:
 	bool includeFileInAutoCollections(FileData* file);
 
 	SystemData* mCustomCollectionsBundle;
+	AutoCollectionIndex* mAutoCollectionIndex;
+
+	friend class AutoCollectionIndex;
 };
 
 std::string getCustomCollectionConfigPath(std::string collectionName);
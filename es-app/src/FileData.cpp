@@ -23,6 +23,7 @@
 #include "ApiSystem.h"
 #include <time.h>
 #include <algorithm>
+#include <atomic>
 #include "LangParser.h"
 #include "resources/ResourceManager.h"
 #include "RetroAchievements.h"
@@ -34,8 +35,14 @@
 #include "Paths.h"
 #include "resources/TextureData.h"
 
+// Above this number of changed games, a display list is computed again instead of being updated
+#define DISPLAY_LIST_MAX_UPDATES 64
+
 FileData* FileData::mRunningGame = nullptr;
 
+// Changed each time a folder gains or loses a child : display lists computed before are obsolete
+static std::atomic<unsigned int> sChildrenVersion(0);
+
 FileData::FileData(FileType type, const std::string& path, SystemData* system)
 	: mPath(path), mType(type), mSystem(system), mParent(nullptr), mDisplayName(nullptr), mMetadata(type == GAME ? GAME_METADATA : FOLDER_METADATA) // metadata is REALLY set in the constructor!
 {
@@ -696,7 +703,7 @@ bool FileData::launchGame(Window* window, LaunchGameOptions options)
 	if (SaveStateRepository::isEnabled(this))
 	{
 		options.saveStateInfo.onGameEnded(this);
-		getSourceFileData()->getSystem()->getSaveStateRepository()->refresh();
+		getSourceFileData()->getSystem()->getSaveStateRepository()->refresh(this);
 	}
 
 	if (!p2kConv.empty()) // delete .keys file if it has been converted from p2k
@@ -959,9 +966,137 @@ const std::string& CollectionFileData::getName()
 	return mSourceFileData->getName();
 }
 
+// A display list keeps the inputs it was computed with, and is computed again when one of them changes.
+// Metadata changes to a few games are patched in the list instead
+class DisplayListCache
+{
+public:
+	unsigned int settingsGeneration;
+	bool isKiosk;
+	bool isKid;
+	SystemData* system;
+	unsigned int sortId;
+	FileFilterIndex* filterIndex;
+	unsigned int filterVersion;
+	unsigned int childrenVersion;
+	unsigned int metadataVersion;
+
+	bool showHiddenFiles;
+	bool filterKidGame;
+	std::vector<std::string> hiddenExts;
+	bool canUpdate;
+
+	std::vector<FileData*> flatGameList;
+	std::vector<FileData*> displayList;
+
+	bool isDisplayed(FileData* file)
+	{
+		if (!showHiddenFiles && file->getHidden())
+			return false;
+
+		if (filterKidGame && file->getType() == GAME && !file->getKidGame())
+			return false;
+
+		if (hiddenExts.size() > 0 && file->getType() == GAME)
+		{
+			std::string extlow = Utils::String::toLower(Utils::FileSystem::getExtension(file->getFileName(), false));
+			if (std::find(hiddenExts.cbegin(), hiddenExts.cend(), extlow) != hiddenExts.cend())
+				return false;
+		}
+
+		return filterIndex == nullptr || filterIndex->showFile(file) != 0;
+	}
+};
+
 const std::vector<FileData*> FolderData::getChildrenListToDisplay() 
 {
-	std::vector<FileData*> ret;
+	// Read before anything is computed : a change made meanwhile makes the list computed again on next call
+	unsigned int metadataVersion = MetaDataList::getLastVersion();
+	unsigned int childrenVersion = sChildrenVersion;
+
+	auto sys = CollectionSystemManager::get()->getSystemToView(mSystem);
+
+	FileFilterIndex* idx = sys->getIndex(false);
+	if (idx != nullptr && !idx->isFiltered())
+		idx = nullptr;
+
+	unsigned int currentSortId = sys->getSortId();
+	if (currentSortId > FileSorts::getSortTypes().size())
+		currentSortId = 0;
+
+	const FileSorts::SortType& sort = FileSorts::getSortTypes().at(currentSortId);
+
+	bool isKiosk = UIModeController::getInstance()->isUIModeKiosk();
+	bool isKid = UIModeController::getInstance()->isUIModeKid();
+
+	DisplayListCache* cache = mDisplayListCache;
+	if (cache != nullptr && cache->settingsGeneration == Settings::getGeneration() && cache->isKiosk == isKiosk && cache->isKid == isKid &&
+		cache->system == sys && cache->sortId == currentSortId && cache->filterIndex == idx && (idx == nullptr || cache->filterVersion == idx->getFilterVersion()) &&
+		cache->childrenVersion == childrenVersion)
+	{
+		if (cache->metadataVersion == metadataVersion)
+			return cache->displayList;
+
+		if (cache->canUpdate)
+		{
+			std::vector<FileData*>& items = cache->flatGameList.size() > 0 ? cache->flatGameList : mChildren;
+
+			std::vector<FileData*> changed;
+			for (auto item : items)
+			{
+				if (item->getMetadata().getVersion() <= cache->metadataVersion)
+					continue;
+
+				changed.push_back(item);
+				if (changed.size() > DISPLAY_LIST_MAX_UPDATES)
+					break;
+			}
+
+			if (changed.size() <= DISPLAY_LIST_MAX_UPDATES)
+			{
+				auto& list = cache->displayList;
+				list.erase(std::remove_if(list.begin(), list.end(), [&changed](FileData* file) { return std::find(changed.cbegin(), changed.cend(), file) != changed.cend(); }), list.end());
+
+				auto compf = sort.comparisonFunction;
+
+				for (auto file : changed)
+				{
+					if (!cache->isDisplayed(file))
+						continue;
+
+					// The list is sorted in reverse order when the sort is descending
+					auto it = sort.ascending ?
+						std::upper_bound(list.begin(), list.end(), file, compf) :
+						std::upper_bound(list.begin(), list.end(), file, [compf](const FileData* file1, const FileData* file2) { return compf(file2, file1); });
+
+					list.insert(it, file);
+				}
+
+				cache->metadataVersion = metadataVersion;
+				return list;
+			}
+		}
+	}
+
+	if (cache == nullptr)
+	{
+		cache = new DisplayListCache();
+		mDisplayListCache = cache;
+	}
+
+	cache->settingsGeneration = Settings::getGeneration();
+	cache->isKiosk = isKiosk;
+	cache->isKid = isKid;
+	cache->system = sys;
+	cache->sortId = currentSortId;
+	cache->filterIndex = idx;
+	cache->filterVersion = idx == nullptr ? 0 : idx->getFilterVersion();
+	cache->childrenVersion = childrenVersion;
+	cache->metadataVersion = metadataVersion;
+	cache->flatGameList.clear();
+	cache->displayList.clear();
+
+	std::vector<FileData*>& ret = cache->displayList;
 
 	std::string showFoldersMode = getSystem()->getFolderViewMode();
 	
@@ -973,38 +1108,42 @@ const std::vector<FileData*> FolderData::getChildrenListToDisplay()
 
 	bool filterKidGame = false;
 
-	if (!Settings::getInstance()->getBool("ForceDisableFilters"))
+	if (!Settings::ForceDisableFilters())
 	{
-		if (UIModeController::getInstance()->isUIModeKiosk())
+		if (isKiosk)
 			showHiddenFiles = false;
 
-		if (UIModeController::getInstance()->isUIModeKid())
+		if (isKid)
 			filterKidGame = true;
 	}
 
-	auto sys = CollectionSystemManager::get()->getSystemToView(mSystem);
-
 	std::vector<std::string> hiddenExts;
 	if (mSystem->isGameSystem() && !mSystem->isCollection())
 		hiddenExts = Utils::String::split(Utils::String::toLower(Settings::getInstance()->getString(mSystem->getName() + ".HiddenExt")), ';');
 
-	FileFilterIndex* idx = sys->getIndex(false);
-	if (idx != nullptr && !idx->isFiltered())
-		idx = nullptr;
-
   	std::vector<FileData*>* items = &mChildren;
 	
-	std::vector<FileData*> flatGameList;
 	if (showFoldersMode == "never")
 	{
-		flatGameList = getFlatGameList(false, sys);
-		items = &flatGameList;		
+		cache->flatGameList = getFlatGameList(false, sys);
+		items = &cache->flatGameList;		
 	}
 
 	std::map<FileData*, int> scoringBoard;
 
 	bool refactorUniqueGameFolders = (showFoldersMode == "having multiple games");
 
+	cache->showHiddenFiles = showHiddenFiles;
+	cache->filterKidGame = filterKidGame;
+	cache->hiddenExts = hiddenExts;
+
+	// A folder showing its unique game depends on the metadata of the games it contains, a relevancy score on the other games,
+	// and a filtered folder is shown depending on the games it contains
+	cache->canUpdate = !refactorUniqueGameFolders && (idx == nullptr || !idx->hasRelevency());
+
+	if (cache->canUpdate && idx != nullptr)
+		cache->canUpdate = std::none_of(items->cbegin(), items->cend(), [](FileData* file) { return file->getType() == FOLDER; });
+
 	for (auto it = items->cbegin(); it != items->cend(); it++)
 	{
 		if (!showHiddenFiles && (*it)->getHidden())
@@ -1062,12 +1201,6 @@ const std::vector<FileData*> FolderData::getChildrenListToDisplay()
 		ret.push_back(*it);
 	}
 
-	unsigned int currentSortId = sys->getSortId();
-	if (currentSortId > FileSorts::getSortTypes().size())
-		currentSortId = 0;
-
-	const FileSorts::SortType& sort = FileSorts::getSortTypes().at(currentSortId);
-
 	if (idx != nullptr && idx->hasRelevency())
 	{
 		auto compf = sort.comparisonFunction;
@@ -1128,20 +1261,17 @@ FileData* FolderData::findUniqueGameForFolder()
 
 	FileData* found = nullptr;
 
+	bool showHiddenFiles = Settings::ShowHiddenFiles() && !UIModeController::getInstance()->isUIModeKiosk();
+
+	auto shv = Settings::getInstance()->getString(getSystem()->getName() + ".ShowHiddenFiles");
+	if (shv == "1") showHiddenFiles = true;
+	else if (shv == "0") showHiddenFiles = false;
+
 	int count = 0;
 	for (auto game : games)
 	{
-		if (game->getHidden())
-		{
-			bool showHiddenFiles = Settings::ShowHiddenFiles() && !UIModeController::getInstance()->isUIModeKiosk();
-
-			auto shv = Settings::getInstance()->getString(getSystem()->getName() + ".ShowHiddenFiles");
-			if (shv == "1") showHiddenFiles = true;
-			else if (shv == "0") showHiddenFiles = false;
-
-			if (!showHiddenFiles)
-				continue;
-		}
+		if (game->getHidden() && !showHiddenFiles)
+			continue;
 
 		found = game;
 		count++;
@@ -1263,6 +1393,7 @@ void FolderData::addChild(FileData* file, bool assignParent)
 #endif
 
 	mChildren.push_back(file);
+	sChildrenVersion++;
 
 	if (assignParent)
 		file->setParent(this);	
@@ -1281,6 +1412,7 @@ void FolderData::removeChild(FileData* file)
 		{
 			file->setParent(NULL);
 			mChildren.erase(it);
+			sChildrenVersion++;
 			return;
 		}
 	}
@@ -1554,6 +1686,43 @@ void FileData::checkCheevosHash(bool force)
 	saveToGamelistRecovery(this);
 }
 
+// Netplay & cheevos hashes share the same read of the rom whenever the rom file is hashed directly
+void FileData::checkCrc32AndCheevosHash(bool force)
+{
+	if (getSourceFileData() != this && getSourceFileData() != nullptr)
+	{
+		getSourceFileData()->checkCrc32AndCheevosHash(force);
+		return;
+	}
+
+	if (!force && !getMetadata(MetaDataId::Crc32).empty())
+	{
+		checkCheevosHash(force);
+		return;
+	}
+
+	if (!force && !getMetadata(MetaDataId::CheevosHash).empty())
+	{
+		checkCrc32(force);
+		return;
+	}
+
+	SystemData* system = getSystem();
+	if (system == nullptr)
+		return;
+
+	std::string crc;
+	auto hash = RetroAchievements::getCheevosHash(system, getPath(), &crc);
+	if (crc.empty())
+		crc = ApiSystem::getInstance()->getCRC32(getPath(), system->shouldExtractHashesFromArchives());
+
+	if (!crc.empty())
+		getMetadata().set(MetaDataId::Crc32, Utils::String::toUpper(crc));
+
+	getMetadata().set(MetaDataId::CheevosHash, Utils::String::toUpper(hash));
+	saveToGamelistRecovery(this);
+}
+
 std::string FileData::getKeyboardMappingFilePath()
 {
 	if (Utils::FileSystem::isDirectory(getSourceFileData()->getPath()))
@@ -1681,11 +1850,18 @@ FolderData::FolderData(const std::string& startpath, SystemData* system, bool ow
 {
 	mIsDisplayableAsVirtualFolder = false;
 	mOwnsChildrens = ownsChildrens;
+	mDisplayListCache = nullptr;
 }
 
 FolderData::~FolderData()
 {
 	clear();
+
+	if (mDisplayListCache != nullptr)
+	{
+		delete mDisplayListCache;
+		mDisplayListCache = nullptr;
+	}
 }
 
 void FolderData::clear()
@@ -1697,6 +1873,12 @@ void FolderData::clear()
 	}
 
 	mChildren.clear();
+	sChildrenVersion++;
+}
+
+unsigned int FolderData::getChildrenVersion()
+{
+	return sChildrenVersion;
 }
 
 void FolderData::removeFromVirtualFolders(FileData* game)
@@ -1712,6 +1894,7 @@ void FolderData::removeFromVirtualFolders(FileData* game)
 		if ((*it) == game)
 		{
 			mChildren.erase(it);
+			sChildrenVersion++;
 			return;
 		}
 	}
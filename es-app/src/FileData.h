@@ -61,6 +61,7 @@ struct LaunchGameOptions
 };
 
 class FolderData;
+class DisplayListCache;
 
 // A tree node that holds information for a file.
 class FileData : public IKeyboardMapContainer
@@ -151,6 +152,7 @@ public:
 	void checkCrc32(bool force = false);
 	void checkMd5(bool force = false);
 	void checkCheevosHash(bool force = false);
+	void checkCrc32AndCheevosHash(bool force = false);
 
 	void importP2k(const std::string& p2k);
 	std::string convertP2kFile();
@@ -248,6 +250,9 @@ public:
 	void removeVirtualFolders();
 	void removeFromVirtualFolders(FileData* game);
 
+	// Changed each time a folder gains or loses a child, or is cleared
+	static unsigned int getChildrenVersion();
+
 private:
 	void getFilesRecursiveWithContext(std::vector<FileData*>& out, unsigned int typeMask, GetFileContext* filter, bool displayedOnly, SystemData* system, bool includeVirtualStorage) const;
 
@@ -255,6 +260,8 @@ private:
 	std::vector<FileData*> mChildren;
 	bool	mOwnsChildrens;
 	bool	mIsDisplayableAsVirtualFolder;
+
+	DisplayListCache* mDisplayListCache;
 };
 
 #endif // ES_APP_FILE_DATA_H
@@ -14,12 +14,229 @@
 #include "CollectionSystemManager.h"
 #include "Genres.h"
 
+#include <algorithm>
+#include <atomic>
+
 #define UNKNOWN_LABEL "UNKNOWN"
 #define INCLUDE_UNKNOWN false;
 
+// Filter versions are unique across indexes, an index allocated at the address of a deleted one can't reuse its version
+static std::atomic<unsigned int> sFilterVersion(0);
+
+// Shorter texts have no trigram, the candidates can't be taken from the index
+#define TEXT_INDEX_MIN_LENGTH 3
+
+// Words of a name, as compared by the relevancy mode of the text filter
+static std::vector<std::string> getSimplifiedWords(const std::string& text)
+{
+	auto s = Utils::String::toLower(text);
+	s = Utils::String::replace(s, ":", "");
+	s = Utils::String::replace(s, ".", "");
+	s = Utils::String::replace(s, " - ", " ");
+	s = Utils::String::replace(s, "- ", " ");
+
+	std::vector<std::string> ret;
+
+	for (auto v : Utils::String::split(s, ' '))
+	{
+		if (v.empty() || v.length() <= 2 || v == "and" || v == "not" || v == "for" || v == "the" || v == "les" || v == "des")
+			continue;
+
+		ret.push_back(v);
+	}
+
+	return ret;
+}
+
+// Inverted indexes over the game names : byte trigrams of the uppercased name for substring matches, and simplified words
+// for the relevancy mode. They give the games a text filter can match, so that only those have to be scored by showFile
+class TextFilterIndex
+{
+public:
+	void add(FileData* game, const std::string& name)
+	{
+		int id;
+		if (mFreeIds.empty())
+		{
+			id = (int)mNames.size();
+			mNames.push_back(name);
+		}
+		else
+		{
+			id = mFreeIds.back();
+			mFreeIds.pop_back();
+			mNames[id] = name;
+		}
+
+		mIds[game] = id;
+
+		for (auto trigram : getTrigrams(name))
+			insertId(mTrigrams[trigram], id);
+
+		for (auto& word : getSimplifiedWords(name))
+			insertId(mWords[word], id);
+	}
+
+	void remove(FileData* game)
+	{
+		auto it = mIds.find(game);
+		if (it == mIds.cend())
+			return;
+
+		int id = it->second;
+		std::string& name = mNames[id];
+
+		for (auto trigram : getTrigrams(name))
+			removeId(mTrigrams, trigram, id);
+
+		for (auto& word : getSimplifiedWords(name))
+			removeId(mWords, word, id);
+
+		name.clear();
+		mFreeIds.push_back(id);
+		mIds.erase(it);
+	}
+
+	void update(FileData* game, const std::string& name)
+	{
+		auto it = mIds.find(game);
+		if (it != mIds.cend() && mNames[it->second] == name)
+			return;
+
+		remove(game);
+		add(game, name);
+	}
+
+	int getId(FileData* game)
+	{
+		auto it = mIds.find(game);
+		if (it == mIds.cend())
+			return -1;
+
+		return it->second;
+	}
+
+	// Returns false if the text is too short to give candidates : every game must then be evaluated
+	bool getCandidates(const std::string& text, bool useRelevancy, std::vector<bool>& candidates)
+	{
+		candidates.assign(mNames.size(), false);
+
+		// Names must contain the text, or one of the comma separated texts
+		if (!useRelevancy && text.find(',') != std::string::npos)
+		{
+			for (auto token : Utils::String::split(text, ',', true))
+				if (!addSubstringCandidates(Utils::String::trim(token), candidates))
+					return false;
+		}
+		else if (!addSubstringCandidates(text, candidates))
+			return false;
+
+		// Relevancy mode also accepts names having a word in common with the text
+		if (useRelevancy && text.find(' ') != std::string::npos)
+		{
+			for (auto& word : getSimplifiedWords(text))
+			{
+				auto it = mWords.find(word);
+				if (it != mWords.cend())
+					for (auto id : it->second)
+						candidates[id] = true;
+			}
+		}
+
+		return true;
+	}
+
+private:
+	bool addSubstringCandidates(const std::string& text, std::vector<bool>& candidates)
+	{
+		if (text.length() < TEXT_INDEX_MIN_LENGTH)
+			return false;
+
+		// Intersect the posting lists, smallest first
+		std::vector<const std::vector<int>*> lists;
+
+		for (auto trigram : getTrigrams(text))
+		{
+			auto it = mTrigrams.find(trigram);
+			if (it == mTrigrams.cend())
+				return true;
+
+			lists.push_back(&it->second);
+		}
+
+		std::sort(lists.begin(), lists.end(), [](const std::vector<int>* a, const std::vector<int>* b) { return a->size() < b->size(); });
+
+		std::vector<int> ids = *lists[0];
+		std::vector<int> tmp;
+
+		for (size_t i = 1; i < lists.size() && !ids.empty(); i++)
+		{
+			tmp.clear();
+			std::set_intersection(ids.cbegin(), ids.cend(), lists[i]->cbegin(), lists[i]->cend(), std::back_inserter(tmp));
+			ids.swap(tmp);
+		}
+
+		for (auto id : ids)
+			candidates[id] = true;
+
+		return true;
+	}
+
+	// Uppercasing matches both the ascii folding of containsIgnoreCase and the unicode folding of the relevancy mode
+	static std::vector<unsigned int> getTrigrams(const std::string& text)
+	{
+		std::vector<unsigned int> ret;
+
+		auto upper = Utils::String::toUpper(text);
+		if (upper.length() < 3)
+			return ret;
+
+		ret.reserve(upper.length() - 2);
+
+		for (size_t i = 0; i + 2 < upper.length(); i++)
+			ret.push_back(((unsigned char)upper[i] << 16) | ((unsigned char)upper[i + 1] << 8) | (unsigned char)upper[i + 2]);
+
+		std::sort(ret.begin(), ret.end());
+		ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+		return ret;
+	}
+
+	static void insertId(std::vector<int>& ids, int id)
+	{
+		auto it = std::lower_bound(ids.begin(), ids.end(), id);
+		if (it == ids.end() || *it != id)
+			ids.insert(it, id);
+	}
+
+	template<typename T>
+	static void removeId(std::unordered_map<T, std::vector<int>>& index, const T& key, int id)
+	{
+		auto it = index.find(key);
+		if (it == index.end())
+			return;
+
+		auto& ids = it->second;
+
+		auto pos = std::lower_bound(ids.begin(), ids.end(), id);
+		if (pos != ids.end() && *pos == id)
+			ids.erase(pos);
+
+		if (ids.empty())
+			index.erase(it);
+	}
+
+	std::unordered_map<FileData*, int> mIds;
+	std::vector<std::string> mNames;
+	std::vector<int> mFreeIds;
+
+	std::unordered_map<unsigned int, std::vector<int>> mTrigrams;
+	std::unordered_map<std::string, std::vector<int>> mWords;
+};
+
 FileFilterIndex::FileFilterIndex()
 	: filterByFavorites(false), filterByGenre(false), filterByKidGame(false), filterByPlayers(false), filterByPubDev(false), filterByRatings(false), filterByYear(false)
 	, filterByLightGun(false), filterByVertical(false), filterByCheevos(false), filterByPlayed(false), filterByRegion(false), filterByLang(false), filterByFamily(false), filterByHasMedia(false)
+	, mImported(false), mTextIndex(nullptr), mTextCandidatesRelevancy(false), mTextCandidatesValid(false), mHasTextCandidates(false)
 {
 	clearAllFilters();
 	FilterDataDecl filterDecls[] = 
@@ -54,6 +271,37 @@ FileFilterIndex::~FileFilterIndex()
 	resetIndex();
 }
 
+// The text index is built the first time a text filter is evaluated, then maintained with the filter index
+bool FileFilterIndex::isTextFilterCandidate(FileData* game)
+{
+	if (mIndexedGames.empty())
+		return true;
+
+	if (mTextIndex == nullptr)
+	{
+		mTextIndex = new TextFilterIndex();
+
+		for (auto& it : mIndexedGames)
+			mTextIndex->add(it.first, it.first->getSourceFileData()->getName());
+
+		mTextCandidatesValid = false;
+	}
+
+	if (!mTextCandidatesValid || mTextCandidatesFilter != mTextFilter || mTextCandidatesRelevancy != mUseRelevency)
+	{
+		mHasTextCandidates = mTextIndex->getCandidates(mTextFilter, mUseRelevency, mTextCandidates);
+		mTextCandidatesFilter = mTextFilter;
+		mTextCandidatesRelevancy = mUseRelevency;
+		mTextCandidatesValid = true;
+	}
+
+	if (!mHasTextCandidates)
+		return true;
+
+	int id = mTextIndex->getId(game);
+	return id < 0 || mTextCandidates[id];
+}
+
 std::vector<FilterDataDecl> FileFilterIndex::getFilterDataDecls()
 {
 	std::vector<FilterDataDecl> ret;
@@ -72,6 +320,7 @@ void FileFilterIndex::copyFrom(FileFilterIndex* indexToImport)
 
 	mTextFilter = indexToImport->mTextFilter;
 	mUseRelevency = indexToImport->mUseRelevency;
+	mImported = true;
 
 	for (auto decl : indexToImport->mFilterDecl)
 	{
@@ -87,6 +336,8 @@ void FileFilterIndex::copyFrom(FileFilterIndex* indexToImport)
 
 		*src->second.filteredByRef = *decl.second.filteredByRef;
 	}
+
+	filtersChanged();
 }
 
 void FileFilterIndex::importIndex(FileFilterIndex* indexToImport)
@@ -115,6 +366,8 @@ void FileFilterIndex::importIndex(FileFilterIndex* indexToImport)
 		{ &hasMediasIndexAllKeys, &(indexToImport->hasMediasIndexAllKeys) }
 	};
 
+	mImported = true;
+
 	std::vector<IndexImportStructure> indexImportDecl = std::vector<IndexImportStructure>(indexStructDecls, indexStructDecls + sizeof(indexStructDecls) / sizeof(indexStructDecls[0]));
 
 	for (std::vector<IndexImportStructure>::const_iterator indexesIt = indexImportDecl.cbegin(); indexesIt != indexImportDecl.cend(); ++indexesIt )
@@ -140,6 +393,17 @@ void FileFilterIndex::resetIndex()
 	mTextFilter = "";
 	clearAllFilters();
 
+	mIndexedGames.clear();
+	mImported = false;
+
+	if (mTextIndex != nullptr)
+	{
+		delete mTextIndex;
+		mTextIndex = nullptr;
+	}
+
+	mTextCandidatesValid = false;
+
 	clearIndex(genreIndexAllKeys);
 	clearIndex(familyIndexAllKeys);
 	clearIndex(playersIndexAllKeys);
@@ -351,26 +615,123 @@ std::string FileFilterIndex::getIndexableKey(FileData* game, FilterIndexType typ
 
 void FileFilterIndex::addToIndex(FileData* game)
 {
+	if (mIndexedGames.find(game) != mIndexedGames.cend())
+	{
+		updateIndex(game);
+		return;
+	}
+
 	game->detectLanguageAndRegion(false);
 
-	manageGenreEntryInIndex(game);
-	manageFamilyEntryInIndex(game);
-	managePlayerEntryInIndex(game);
-	managePubDevEntryInIndex(game);	
-	manageYearEntryInIndex(game);
-	manageLangEntryInIndex(game);
-	manageRegionEntryInIndex(game);		
+	auto entries = getIndexEntries(game);
+	for (auto& entry : entries)
+		manageIndexEntry(entry.index, entry.key, false, true);
+
+	mIndexedGames[game] = std::move(entries);
+
+	if (mTextIndex != nullptr)
+	{
+		mTextIndex->add(game, game->getSourceFileData()->getName());
+		mTextCandidatesValid = false;
+	}
 }
 
 void FileFilterIndex::removeFromIndex(FileData* game)
 {
-	manageGenreEntryInIndex(game, true);
-	manageFamilyEntryInIndex(game, true);
-	managePlayerEntryInIndex(game, true);
-	managePubDevEntryInIndex(game, true);	
-	manageYearEntryInIndex(game, true);
-	manageLangEntryInIndex(game, true);
-	manageRegionEntryInIndex(game, true);	
+	auto it = mIndexedGames.find(game);
+	if (it == mIndexedGames.cend())
+	{
+		// Imported counts have no entries to rely on : use the current metadata
+		if (mImported)
+			for (auto& entry : getIndexEntries(game))
+				manageIndexEntry(entry.index, entry.key, true, true);
+
+		return;
+	}
+
+	// Remove the keys the game was counted with, its metadata may have changed since
+	for (auto& entry : it->second)
+		manageIndexEntry(entry.index, entry.key, true, true);
+
+	mIndexedGames.erase(it);
+
+	if (mTextIndex != nullptr)
+	{
+		mTextIndex->remove(game);
+		mTextCandidatesValid = false;
+	}
+}
+
+// Only the keys that changed since the game was indexed are updated
+void FileFilterIndex::updateIndex(FileData* game)
+{
+	auto it = mIndexedGames.find(game);
+	if (it == mIndexedGames.cend())
+	{
+		addToIndex(game);
+		return;
+	}
+
+	game->detectLanguageAndRegion(false);
+
+	if (mTextIndex != nullptr)
+	{
+		mTextIndex->update(game, game->getSourceFileData()->getName());
+		mTextCandidatesValid = false;
+	}
+
+	auto entries = getIndexEntries(game);
+	if (entries == it->second)
+		return;
+
+	std::vector<IndexEntry> removed = it->second;
+
+	for (auto& entry : entries)
+	{
+		auto old = std::find(removed.begin(), removed.end(), entry);
+		if (old != removed.end())
+			removed.erase(old);
+		else
+			manageIndexEntry(entry.index, entry.key, false, true);
+	}
+
+	for (auto& entry : removed)
+		manageIndexEntry(entry.index, entry.key, true, true);
+
+	it->second = std::move(entries);
+}
+
+// Compares the counts of two indexes. Used to check the incremental updates against a full rebuild
+bool FileFilterIndex::isIndexEqual(FileFilterIndex* index)
+{
+	bool ret = true;
+
+	for (auto decl : mFilterDecl)
+	{
+		auto other = index->mFilterDecl.find(decl.first);
+		if (other == index->mFilterDecl.cend())
+			continue;
+
+		auto& keys = *decl.second.allIndexKeys;
+		auto& otherKeys = *other->second.allIndexKeys;
+		if (keys == otherKeys)
+			continue;
+
+		for (auto key : keys)
+		{
+			auto otherKey = otherKeys.find(key.first);
+			if (otherKey == otherKeys.cend() || otherKey->second != key.second)
+				LOG(LogError) << "FileFilterIndex mismatch in " << decl.second.primaryKey << " for " << key.first << " : " << key.second << " / " << (otherKey == otherKeys.cend() ? 0 : otherKey->second);
+		}
+
+		for (auto otherKey : otherKeys)
+			if (keys.find(otherKey.first) == keys.cend())
+				LOG(LogError) << "FileFilterIndex mismatch in " << decl.second.primaryKey << " for " << otherKey.first << " : 0 / " << otherKey.second;
+
+		ret = false;
+	}
+
+	return ret;
 }
 
 void FileFilterIndex::setFilter(FilterIndexType type, std::vector<std::string>* values)
@@ -389,6 +750,7 @@ void FileFilterIndex::setFilter(FilterIndexType type, std::vector<std::string>*
 	FilterDataDecl& filterData = it->second;
 	*(filterData.filteredByRef) = values != nullptr && values->size() > 0;
 	filterData.currentFilteredKeys->clear();
+	filtersChanged();
 
 	if (values == nullptr)
 		return;
@@ -423,7 +785,13 @@ void FileFilterIndex::clearAllFilters()
 		*(filterData.filteredByRef) = false;
 		filterData.currentFilteredKeys->clear();
 	}
-	return;
+
+	filtersChanged();
+}
+
+void FileFilterIndex::filtersChanged()
+{
+	mFilterVersion = ++sFilterVersion;
 }
 
 void FileFilterIndex::resetFilters()
@@ -449,6 +817,7 @@ void FileFilterIndex::setTextFilter(const std::string text, bool useRelevancy)
 { 
 	mTextFilter = text;
 	mUseRelevency = useRelevancy;
+	filtersChanged();
 }
 
 float jw_distance(std::string s1, std::string s2, bool caseSensitive = true) {
@@ -565,6 +934,9 @@ int FileFilterIndex::showFile(FileData* game)
 
 	if (!mTextFilter.empty())
 	{
+		if (!isTextFilterCandidate(game))
+			return 0;
+
 		auto name = game->getSourceFileData()->getName();
 
 		if (!mUseRelevency)
@@ -609,29 +981,8 @@ int FileFilterIndex::showFile(FileData* game)
 			}
 			else if (mTextFilter.find(' ') != std::string::npos)
 			{
-				auto simplify = [](const std::string& text)
-				{
-					auto s = Utils::String::toLower(text);
-					s = Utils::String::replace(s, ":", "");
-					s = Utils::String::replace(s, ".", "");
-					s = Utils::String::replace(s, " - ", " ");
-					s = Utils::String::replace(s, "- ", " ");				
-
-					std::vector<std::string> ret;
-
-					for (auto v : Utils::String::split(s, ' '))
-					{
-						if (v.empty() || v.length() <= 2 || v == "and" || v == "not" || v == "for" || v == "the" || v == "les" || v == "des")
-							continue;
-
-						ret.push_back(v);
-					}
-
-					return ret;
-				};
-
-				auto filters = simplify(mTextFilter);
-				auto words = simplify(name);
+				auto filters = getSimplifiedWords(mTextFilter);
+				auto words = getSimplifiedWords(name);
 
 				int totalWords = 0;
 				int commonWords = 0;
@@ -790,114 +1141,94 @@ bool FileFilterIndex::isKeyBeingFilteredBy(std::string key, FilterIndexType type
 	return keys->find(key) != keys->cend();
 }
 
-void FileFilterIndex::manageLangEntryInIndex(FileData* game, bool remove)
+void FileFilterIndex::addIndexEntry(std::vector<IndexEntry>& entries, std::map<std::string, int>* index, const std::string& key, bool forceUnknown)
+{
+	bool includeUnknown = INCLUDE_UNKNOWN;
+	if (!includeUnknown && key == UNKNOWN_LABEL && !forceUnknown)
+		return;
+
+	entries.push_back({ index, key });
+}
+
+void FileFilterIndex::getLangIndexEntries(FileData* game, std::vector<IndexEntry>& entries)
 {
 	std::string key = getIndexableKey(game, LANG_FILTER, false);
 	if (key.empty() || key == UNKNOWN_LABEL)
-		manageIndexEntry(&langIndexAllKeys, UNKNOWN_LABEL, remove, true);
+		addIndexEntry(entries, &langIndexAllKeys, UNKNOWN_LABEL, true);
 	else
 		for(auto val : Utils::String::split(key, ','))
-			manageIndexEntry(&langIndexAllKeys, val, remove);
+			addIndexEntry(entries, &langIndexAllKeys, val);
 }
 
-void FileFilterIndex::manageRegionEntryInIndex(FileData* game, bool remove)
+void FileFilterIndex::getRegionIndexEntries(FileData* game, std::vector<IndexEntry>& entries)
 {
 	std::string key = getIndexableKey(game, REGION_FILTER, false);
 	if (key.empty() || key == UNKNOWN_LABEL)
-		manageIndexEntry(&regionIndexAllKeys, UNKNOWN_LABEL, remove, true);
+		addIndexEntry(entries, &regionIndexAllKeys, UNKNOWN_LABEL, true);
 	else
 		for (auto val : Utils::String::split(key, ','))
-			manageIndexEntry(&regionIndexAllKeys, val, remove);
+			addIndexEntry(entries, &regionIndexAllKeys, val);
 }
 
-void FileFilterIndex::manageFamilyEntryInIndex(FileData* game, bool remove)
+void FileFilterIndex::getFamilyIndexEntries(FileData* game, std::vector<IndexEntry>& entries)
 {
 	std::string key = getIndexableKey(game, FAMILY_FILTER, false);
 	if (!key.empty() && key != UNKNOWN_LABEL)
-		manageIndexEntry(&familyIndexAllKeys, key, remove);
+		addIndexEntry(entries, &familyIndexAllKeys, key);
 }
 
-void FileFilterIndex::manageGenreEntryInIndex(FileData* game, bool remove)
+void FileFilterIndex::getGenreIndexEntries(FileData* game, std::vector<IndexEntry>& entries)
 {
 	for (auto key : Genres::getGenreFiltersNames(&game->getMetadata()))
-		manageIndexEntry(&genreIndexAllKeys, key, remove);
-
-	/*
-
-	std::string key = getIndexableKey(game, GENRE_FILTER, false);
-
-	// flag for including unknowns
-	bool includeUnknown = INCLUDE_UNKNOWN;
-
-	// only add unknown in pubdev IF both dev and pub are empty
-	if (!includeUnknown && (key == UNKNOWN_LABEL || key == "BIOS"))		
-		return;	 // no valid genre info found
-
-	manageIndexEntry(&genreIndexAllKeys, key, remove);
-
-	auto subkey = getIndexableKey(game, GENRE_FILTER, true);
-	if (!includeUnknown && (subkey == UNKNOWN_LABEL || subkey == "BIOS"))
-		return;	 // no valid genre info found
-
-	manageIndexEntry(&genreIndexAllKeys, subkey, remove);*/
+		addIndexEntry(entries, &genreIndexAllKeys, key);
 }
 
-void FileFilterIndex::managePlayerEntryInIndex(FileData* game, bool remove)
+void FileFilterIndex::getPlayerIndexEntries(FileData* game, std::vector<IndexEntry>& entries)
 {
-	// flag for including unknowns
-	bool includeUnknown = INCLUDE_UNKNOWN;
-	std::string key = getIndexableKey(game, PLAYER_FILTER, false);
-
-	// only add unknown in pubdev IF both dev and pub are empty
-	if (!includeUnknown && key == UNKNOWN_LABEL) {
-		// no valid player info found
-		return;
-	}
-
-	manageIndexEntry(&playersIndexAllKeys, key, remove);
+	// unknown players are not indexed
+	addIndexEntry(entries, &playersIndexAllKeys, getIndexableKey(game, PLAYER_FILTER, false));
 }
 
-void FileFilterIndex::managePubDevEntryInIndex(FileData* game, bool remove)
+void FileFilterIndex::getPubDevIndexEntries(FileData* game, std::vector<IndexEntry>& entries)
 {
 	std::string pub = getIndexableKey(game, PUBDEV_FILTER, false);
 	std::string dev = getIndexableKey(game, PUBDEV_FILTER, true);
 
-	// flag for including unknowns
-	bool includeUnknown = INCLUDE_UNKNOWN;
-	bool unknownPub = false;
-	bool unknownDev = false;
-
-	if (pub == UNKNOWN_LABEL)
-		unknownPub = true;
+	bool unknownPub = (pub == UNKNOWN_LABEL);
+	bool unknownDev = (dev == UNKNOWN_LABEL);
 
-	if (dev == UNKNOWN_LABEL)
-		unknownDev = true;
-
-	if (!includeUnknown && unknownDev && unknownPub) {
-		// no valid rating info found
+	if (unknownDev && unknownPub)
+	{
+		// if no info at all
+		addIndexEntry(entries, &pubDevIndexAllKeys, pub);
 		return;
 	}
 
-	if (unknownDev && unknownPub) {
-		// if no info at all
-		manageIndexEntry(&pubDevIndexAllKeys, pub, remove);
-	}
-	else
-	{
-		if (!unknownDev) {
-			// if no info at all
-			manageIndexEntry(&pubDevIndexAllKeys, dev, remove);
-		}
-		if (!unknownPub) {
-			// if no info at all
-			manageIndexEntry(&pubDevIndexAllKeys, pub, remove);
-		}
-	}
+	if (!unknownDev)
+		addIndexEntry(entries, &pubDevIndexAllKeys, dev);
+
+	if (!unknownPub)
+		addIndexEntry(entries, &pubDevIndexAllKeys, pub);
 }
 
-void FileFilterIndex::manageYearEntryInIndex(FileData* game, bool remove)
+void FileFilterIndex::getYearIndexEntries(FileData* game, std::vector<IndexEntry>& entries)
 {
-	manageIndexEntry(&yearIndexAllKeys, getIndexableKey(game, YEAR_FILTER, false), remove);
+	addIndexEntry(entries, &yearIndexAllKeys, getIndexableKey(game, YEAR_FILTER, false));
+}
+
+std::vector<FileFilterIndex::IndexEntry> FileFilterIndex::getIndexEntries(FileData* game)
+{
+	std::vector<IndexEntry> entries;
+
+	getGenreIndexEntries(game, entries);
+	getFamilyIndexEntries(game, entries);
+	getPlayerIndexEntries(game, entries);
+	getPubDevIndexEntries(game, entries);
+	getYearIndexEntries(game, entries);
+	getLangIndexEntries(game, entries);
+	getRegionIndexEntries(game, entries);
+
+	return entries;
 }
 
 void FileFilterIndex::manageIndexEntry(std::map<std::string, int>* index, const std::string& key, bool remove, bool forceUnknown)
@@ -931,7 +1262,7 @@ void FileFilterIndex::manageIndexEntry(std::map<std::string, int>* index, const
 		(index->at(key))++;
 }
 
-void FileFilterIndex::clearIndex(std::map<std::string, int> indexMap)
+void FileFilterIndex::clearIndex(std::map<std::string, int>& indexMap)
 {
 	indexMap.clear();
 }
@@ -965,6 +1296,8 @@ bool CollectionFilter::createFromSystem(const std::string name, SystemData* syst
 		*(filterData.filteredByRef) = (filterData.currentFilteredKeys->size() > 0);
 	}
 
+	filtersChanged();
+
 	mName = name;
 	mPath = getCollectionsFolder() + "/" + mName + ".xcc";
 	
@@ -1053,6 +1386,7 @@ bool CollectionFilter::load(const std::string file)
 		*(filterData.filteredByRef) = (filterData.currentFilteredKeys->size() > 0);
 	}
 
+	filtersChanged();
 	return true;
 }
 
@@ -1164,11 +1498,14 @@ void CollectionFilter::setSystemSelected(const std::string name, bool value)
 	}
 	else if (!value)			
 		mSystemFilter.erase(sys);	
+
+	filtersChanged();
 }
 
 void CollectionFilter::resetSystemFilter()
 {
 	mSystemFilter.clear();
+	filtersChanged();
 }
 
 std::string FileFilterIndex::getDisplayLabel(bool includeText)
@@ -5,10 +5,12 @@
 #include <map>
 #include <vector>
 #include <unordered_set>
+#include <unordered_map>
 #include <string>
 
 class FileData;
 class SystemData;
+class TextFilterIndex;
 
 enum FilterIndexType
 {
@@ -57,6 +59,8 @@ public:
 
 	void addToIndex(FileData* game);
 	void removeFromIndex(FileData* game);
+	void updateIndex(FileData* game);
+	bool isIndexEqual(FileFilterIndex* index);
 	void setFilter(FilterIndexType type, std::vector<std::string>* values);
 	std::unordered_set<std::string>* getFilter(FilterIndexType type);
 
@@ -80,6 +84,9 @@ public:
 	inline const std::string getTextFilter() { return mTextFilter; }
 	inline bool hasRelevency() { return !mTextFilter.empty() && mUseRelevency; }
 
+	// Changes each time the filters are changed : lists computed with the filters can be kept until it changes
+	inline unsigned int getFilterVersion() { return mFilterVersion; }
+
 	std::string getDisplayLabel(bool includeText = false);
 
 protected:
@@ -88,17 +95,41 @@ protected:
 
 	std::string getIndexableKey(FileData* game, FilterIndexType type, bool getSecondary);
 
-	void manageGenreEntryInIndex(FileData* game, bool remove = false);
-	void manageFamilyEntryInIndex(FileData* game, bool remove = false);
-	void managePlayerEntryInIndex(FileData* game, bool remove = false);
-	void managePubDevEntryInIndex(FileData* game, bool remove = false);	
-	void manageYearEntryInIndex(FileData* game, bool remove = false);
+	// A key counted for a game, kept so the game can be updated or removed without rebuilding the index
+	struct IndexEntry
+	{
+		std::map<std::string, int>* index;
+		std::string key;
+
+		bool operator==(const IndexEntry& other) const { return index == other.index && key == other.key; }
+	};
+
+	std::vector<IndexEntry> getIndexEntries(FileData* game);
+
+	void getGenreIndexEntries(FileData* game, std::vector<IndexEntry>& entries);
+	void getFamilyIndexEntries(FileData* game, std::vector<IndexEntry>& entries);
+	void getPlayerIndexEntries(FileData* game, std::vector<IndexEntry>& entries);
+	void getPubDevIndexEntries(FileData* game, std::vector<IndexEntry>& entries);
+	void getYearIndexEntries(FileData* game, std::vector<IndexEntry>& entries);
+	void getLangIndexEntries(FileData* game, std::vector<IndexEntry>& entries);
+	void getRegionIndexEntries(FileData* game, std::vector<IndexEntry>& entries);
+	void addIndexEntry(std::vector<IndexEntry>& entries, std::map<std::string, int>* index, const std::string& key, bool forceUnknown = false);
+
 	void manageIndexEntry(std::map<std::string, int>* index, const std::string& key, bool remove, bool forceUnknown = false);
 
-	void manageLangEntryInIndex(FileData* game, bool remove = false);
-	void manageRegionEntryInIndex(FileData* game, bool remove = false);
+	void clearIndex(std::map<std::string, int>& indexMap);
+
+	std::unordered_map<FileData*, std::vector<IndexEntry>> mIndexedGames;
+	bool mImported;
 
-	void clearIndex(std::map<std::string, int> indexMap);
+	bool isTextFilterCandidate(FileData* game);
+
+	TextFilterIndex* mTextIndex;
+	std::vector<bool> mTextCandidates;
+	std::string mTextCandidatesFilter;
+	bool mTextCandidatesRelevancy;
+	bool mTextCandidatesValid;
+	bool mHasTextCandidates;
 
 	bool filterByGenre;
 	bool filterByFamily;
@@ -150,6 +181,9 @@ protected:
 
 	std::string mTextFilter;
 	bool		mUseRelevency;
+
+	unsigned int mFilterVersion;
+	void filtersChanged();
 };
 
 class CollectionFilter : public FileFilterIndex
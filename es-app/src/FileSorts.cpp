@@ -113,10 +113,9 @@ namespace FileSorts
 
 	bool _compareNames(std::string name1, std::string name2)
 	{
-		const bool ignoreArticles = Settings::getInstance()->getBool("IgnoreLeadingArticles");
-		if (ignoreArticles)
+		if (Settings::IgnoreLeadingArticles())
 		{
-			const auto articles = Utils::String::commaStringToVector(_("A,AN,THE"));
+			static auto articles = Utils::String::commaStringToVector(_("A,AN,THE"));
 			name1 = stripLeadingArticle(name1, articles);
 			name2 = stripLeadingArticle(name2, articles);
 		}
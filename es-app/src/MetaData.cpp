@@ -11,6 +11,7 @@
 #include "ImageIO.h"
 
 std::vector<MetaDataDecl> MetaDataList::mMetaDataDecls;
+std::atomic<unsigned int> MetaDataList::sVersion(0);
 
 static std::map<MetaDataId, int> mMetaDataIndexes;
 static std::string* mDefaultGameMap = nullptr;
@@ -142,7 +143,7 @@ MetaDataId MetaDataList::getId(const std::string& key) const
 	return mGameIdMap[key];
 }
 
-MetaDataList::MetaDataList(MetaDataListType type) : mType(type), mWasChanged(false), mRelativeTo(nullptr)
+MetaDataList::MetaDataList(MetaDataListType type) : mType(type), mWasChanged(false), mVersion(0), mRelativeTo(nullptr)
 {
 
 }
@@ -151,6 +152,7 @@ void MetaDataList::loadFromXML(MetaDataListType type, pugi::xml_node& node, Syst
 {
 	mType = type;
 	mRelativeTo = system;	
+	mVersion = ++sVersion;
 
 	mUnKnownElements.clear();
 	mScrapeDates.clear();
@@ -360,6 +362,7 @@ void MetaDataList::set(MetaDataId id, const std::string& value)
 
 		mName = value;
 		mWasChanged = true;
+		mVersion = ++sVersion;
 		return;
 	}
 
@@ -367,6 +370,7 @@ void MetaDataList::set(MetaDataId id, const std::string& value)
 	if (mType == GAME_METADATA && id == MetaDataId::Players && Utils::String::startsWith(value, "1-")) // "players"
 	{
 		mMap[id] = Utils::String::replace(value, "1-", "");
+		mVersion = ++sVersion;
 		return;
 	}
 
@@ -380,6 +384,7 @@ void MetaDataList::set(MetaDataId id, const std::string& value)
 		mMap[id] = Utils::String::trim(value);
 
 	mWasChanged = true;
+	mVersion = ++sVersion;
 }
 
 const std::string MetaDataList::get(MetaDataId id, bool resolveRelativePaths) const
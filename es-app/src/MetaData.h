@@ -6,6 +6,7 @@
 #include <vector>
 #include <functional>
 #include <string>
+#include <atomic>
 
 #include "utils/TimeUtil.h"
 
@@ -163,6 +164,10 @@ public:
 		mWasChanged = true; 
 	}
 
+	// Stamp of the last change, taken from a global counter : a list changed after a stamp has a greater version
+	inline unsigned int getVersion() const { return mVersion; }
+	static unsigned int getLastVersion() { return sVersion; }
+
 	inline MetaDataListType getType() const { return mType; }
 	static const std::vector<MetaDataDecl>& getMDD() { return mMetaDataDecls; }
 	inline const std::string& getName() const { return mName; }
@@ -181,8 +186,11 @@ private:
 	MetaDataListType mType;
 	std::map<MetaDataId, std::string> mMap;
 	bool mWasChanged;
+	unsigned int mVersion;
 	SystemData*		mRelativeTo;
 
+	static std::atomic<unsigned int> sVersion;
+
 	static std::vector<MetaDataDecl> mMetaDataDecls;
 
 	std::vector<std::tuple<std::string, std::string, bool>> mUnKnownElements;
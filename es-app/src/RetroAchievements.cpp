@@ -15,6 +15,9 @@
 
 #include "LocaleES.h"
 
+// rcheevos doesn't hash more than 64MB of a rom. Larger roms are extracted to the temp folder
+#define CHEEVOS_MAX_BUFFERED_ROM_SIZE	(64 * 1024 * 1024)
+
 using namespace PlatformIds;
 
 const std::map<PlatformId, unsigned short> cheevosConsoleID
@@ -502,7 +505,7 @@ std::string RetroAchievements::getCheevosHashFromFile(int consoleId, const std::
 	return "00000000000000000000000000000000";	
 }
 
-std::string RetroAchievements::getCheevosHash( SystemData* system, const std::string fileName)
+std::string RetroAchievements::getCheevosHash( SystemData* system, const std::string fileName, std::string* crc32)
 {
 	bool fromZipContents = system->shouldExtractHashesFromArchives();
 
@@ -521,13 +524,61 @@ std::string RetroAchievements::getCheevosHash( SystemData* system, const std::st
 	if (consoleId == RC_CONSOLE_ARCADE)
 		return getCheevosHashFromFile(consoleId, fileName);
 
-	if (consoleId == 0 || consolesWithmd5hashes.find(consoleId) != consolesWithmd5hashes.cend())
+	std::string ext = Utils::String::toLower(Utils::FileSystem::getExtension(fileName));
+	bool isArchive = (ext == ".zip" || ext == ".7z");
+	bool isMd5Console = (consoleId == 0 || consolesWithmd5hashes.find(consoleId) != consolesWithmd5hashes.cend());
+
+	// When the rom file itself is hashed, the crc32 is computed from the same read. It is left empty otherwise
+	if (crc32 != nullptr && (!isArchive || !fromZipContents))
+	{
+		if (isMd5Console)
+		{
+			std::string md5;
+			if (Utils::FileSystem::getFileHashes(fileName, crc32, &md5))
+				return md5;
+		}
+		else if (!isArchive && ext != ".m3u" && ext != ".cue" && ext != ".chd" && canGenerateHashFromBuffer(consoleId) && Utils::FileSystem::getFileSize(fileName) <= CHEEVOS_MAX_BUFFERED_ROM_SIZE)
+		{
+			std::vector<unsigned char> buffer;
+			buffer.reserve((size_t)Utils::FileSystem::getFileSize(fileName));
+
+			bool read = Utils::FileSystem::getFileHashes(fileName, crc32, nullptr, [&buffer](const void* data, size_t size)
+			{
+				buffer.insert(buffer.end(), (const unsigned char*)data, (const unsigned char*)data + size);
+				return true;
+			});
+
+			char hash[33];
+			if (read && !buffer.empty() && generateHashFromBuffer(hash, consoleId, buffer.data(), buffer.size()))
+				return hash;
+		}
+	}
+
+	if (isMd5Console)
 		return ApiSystem::getInstance()->getMD5(fileName, fromZipContents);
 
-	std::string ext = Utils::String::toLower(Utils::FileSystem::getExtension(fileName));
-	if (ext != ".zip" && ext != ".7z")
+	if (!isArchive)
 		return getCheevosHashFromFile(consoleId, fileName);
 
+	// Cartridge roms are hashed from memory, streamed out of the archive. Disc images still need the files
+	if (fromZipContents && canGenerateHashFromBuffer(consoleId))
+	{
+		std::vector<unsigned char> buffer;
+
+		bool read = ApiSystem::getInstance()->readArchivedRom(fileName, [&buffer](const void* data, size_t size)
+		{
+			if (buffer.size() + size > CHEEVOS_MAX_BUFFERED_ROM_SIZE)
+				return false;
+
+			buffer.insert(buffer.end(), (const unsigned char*)data, (const unsigned char*)data + size);
+			return true;
+		});
+
+		char hash[33];
+		if (read && generateHashFromBuffer(hash, consoleId, buffer.data(), buffer.size()))
+			return hash;
+	}
+
 	std::string contentFile = fileName;
 	std::string ret;
 	std::string tmpZipDirectory;
@@ -198,7 +198,7 @@ public:
 
 	static std::map<std::string, std::string>	getCheevosHashes();
 
-	static std::string				getCheevosHash(SystemData* pSystem, const std::string fileName);
+	static std::string				getCheevosHash(SystemData* pSystem, const std::string fileName, std::string* crc32 = nullptr);
 	static bool						testAccount(const std::string& username, const std::string& password, std::string& error);
 
 private:
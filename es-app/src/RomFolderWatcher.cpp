@@ -0,0 +1,281 @@
+#include "RomFolderWatcher.h"
+#include "Window.h"
+#include "SystemData.h"
+#include "ThreadedHasher.h"
+#include "scrapers/ThreadedScraper.h"
+#include "views/ViewController.h"
+#include "utils/FileSystemUtil.h"
+#include "utils/StringUtil.h"
+#include "Log.h"
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+// Time without event before a batch of changes is applied
+#define WATCHER_QUIET_DELAY		2000
+// A batch is applied after this time, even if events keep coming (large copies)
+#define WATCHER_MAX_DELAY		10000
+#define WATCHER_POLL_DELAY		250
+// Delay before applying again changes that could not be applied
+#define WATCHER_RETRY_DELAY		15000
+
+RomFolderWatcher* RomFolderWatcher::mInstance = nullptr;
+
+void RomFolderWatcher::start(Window* window)
+{
+#if defined(__linux__)
+	if (mInstance != nullptr)
+		return;
+
+	std::map<std::string, std::string> paths;
+
+	for (auto system : SystemData::sSystemVector)
+	{
+		if (system->isCollection() || !system->isGameSystem() || system->getSystemEnvData() == nullptr)
+			continue;
+
+		auto path = system->getSystemEnvData()->mStartPath;
+		if (!path.empty() && paths.find(path) == paths.cend())
+			paths[path] = system->getName();
+	}
+
+	if (paths.size() > 0)
+		mInstance = new RomFolderWatcher(window, paths);
+#endif
+}
+
+void RomFolderWatcher::stop()
+{
+	if (mInstance == nullptr)
+		return;
+
+	delete mInstance;
+	mInstance = nullptr;
+}
+
+RomFolderWatcher::RomFolderWatcher(Window* window, const std::map<std::string, std::string>& paths)
+	: mWindow(window), mThread(nullptr), mExit(false), mFd(-1), mRootPaths(paths)
+{
+#if defined(__linux__)
+	mFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (mFd < 0)
+	{
+		LOG(LogError) << "RomFolderWatcher : inotify is not available";
+		return;
+	}
+
+	LOG(LogDebug) << "RomFolderWatcher : Starting";
+	mThread = new std::thread(&RomFolderWatcher::run, this);
+#endif
+}
+
+RomFolderWatcher::~RomFolderWatcher()
+{
+	if (mThread != nullptr)
+	{
+		LOG(LogDebug) << "RomFolderWatcher : Exit";
+
+		mExit = true;
+		mThread->join();
+		delete mThread;
+		mThread = nullptr;
+	}
+
+#if defined(__linux__)
+	if (mFd >= 0)
+		close(mFd);
+#endif
+
+	mFd = -1;
+}
+
+void RomFolderWatcher::run()
+{
+#if defined(__linux__)
+	// Watching the sub folders needs to list them : it's done here, not to slow down the startup
+	for (auto root : mRootPaths)
+	{
+		if (mExit)
+			return;
+
+		addWatch(root.first, root.second);
+	}
+
+	LOG(LogInfo) << "RomFolderWatcher : " << mWatches.size() << " folders watched";
+
+	while (!mExit)
+	{
+		struct pollfd pfd;
+		pfd.fd = mFd;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+
+		if (poll(&pfd, 1, WATCHER_POLL_DELAY) > 0 && (pfd.revents & POLLIN))
+			readEvents();
+
+		flush();
+	}
+#endif
+}
+
+void RomFolderWatcher::addWatch(const std::string& path, const std::string& systemName)
+{
+#if defined(__linux__)
+	int wd = inotify_add_watch(mFd, path.c_str(), IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR);
+	if (wd < 0)
+	{
+		LOG(LogWarning) << "RomFolderWatcher : Unable to watch " << path << " (" << errno << ")";
+		return;
+	}
+
+	// Already watched : a symlink to a folder we know
+	if (mWatches.find(wd) != mWatches.cend())
+		return;
+
+	mWatches[wd] = std::pair<std::string, std::string>(path, systemName);
+
+	for (auto fileInfo : Utils::FileSystem::getDirectoryFiles(path))
+		if (fileInfo.directory && !SystemData::isIgnoredFolder(systemName, Utils::FileSystem::getFileName(fileInfo.path)))
+			addWatch(fileInfo.path, systemName);
+#endif
+}
+
+void RomFolderWatcher::removeWatches(const std::string& path)
+{
+#if defined(__linux__)
+	for (auto it = mWatches.begin(); it != mWatches.end(); )
+	{
+		if (it->second.first == path || Utils::String::startsWith(it->second.first, path + "/"))
+		{
+			inotify_rm_watch(mFd, it->first);
+			it = mWatches.erase(it);
+		}
+		else
+			++it;
+	}
+#endif
+}
+
+void RomFolderWatcher::readEvents()
+{
+#if defined(__linux__)
+	char buffer[16384] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+	std::set<std::string> paths;
+
+	while (!mExit)
+	{
+		ssize_t length = read(mFd, buffer, sizeof(buffer));
+		if (length <= 0)
+			break;
+
+		for (char* ptr = buffer; ptr < buffer + length; ptr += sizeof(struct inotify_event) + ((struct inotify_event*)ptr)->len)
+		{
+			const struct inotify_event* event = (const struct inotify_event*)ptr;
+
+			if (event->mask & IN_Q_OVERFLOW)
+			{
+				LOG(LogWarning) << "RomFolderWatcher : Too many changes, some games won't be updated until the next reload";
+				continue;
+			}
+
+			auto watch = mWatches.find(event->wd);
+			if (watch == mWatches.cend())
+				continue;
+
+			if (event->mask & IN_IGNORED)
+			{
+				mWatches.erase(watch);
+				continue;
+			}
+
+			if (event->len == 0)
+				continue;
+
+			std::string path = watch->second.first + "/" + event->name;
+			std::string systemName = watch->second.second;
+
+			if (event->mask & IN_ISDIR)
+			{
+				if (SystemData::isIgnoredFolder(systemName, event->name))
+					continue;
+
+				if (event->mask & (IN_CREATE | IN_MOVED_TO))
+					addWatch(path, systemName);
+				else if (event->mask & IN_MOVED_FROM)
+					removeWatches(path);
+			}
+			else if (event->mask & IN_CREATE)
+				continue; // Files are taken when they are closed after being written
+
+			paths.insert(path);
+		}
+	}
+
+	if (paths.size() == 0)
+		return;
+
+	std::unique_lock<std::mutex> lock(mLock);
+
+	auto now = std::chrono::steady_clock::now();
+	if (mPendingPaths.size() == 0)
+		mFirstEventTime = now;
+
+	mLastEventTime = now;
+
+	for (auto path : paths)
+		mPendingPaths.insert(path);
+#endif
+}
+
+void RomFolderWatcher::flush()
+{
+	std::set<std::string> paths;
+
+	{
+		std::unique_lock<std::mutex> lock(mLock);
+		if (mPendingPaths.size() == 0)
+			return;
+
+		auto now = std::chrono::steady_clock::now();
+		if (now < mNextFlushTime)
+			return;
+
+		if (std::chrono::duration_cast<std::chrono::milliseconds>(now - mLastEventTime).count() < WATCHER_QUIET_DELAY &&
+			std::chrono::duration_cast<std::chrono::milliseconds>(now - mFirstEventTime).count() < WATCHER_MAX_DELAY)
+			return;
+
+		paths = mPendingPaths;
+		mPendingPaths.clear();
+	}
+
+	LOG(LogDebug) << "RomFolderWatcher : " << paths.size() << " changes";
+	mWindow->postToUiThread([paths]() { RomFolderWatcher::applyChanges(paths); });
+}
+
+void RomFolderWatcher::applyChanges(std::set<std::string> paths)
+{
+	if (mInstance == nullptr)
+		return;
+
+	// Games can't be removed while a menu or a background task may use them : the changes are kept for the next batch
+	if (ThreadedScraper::isRunning() || ThreadedHasher::isRunning() || mInstance->mWindow->peekGui() != ViewController::get())
+	{
+		std::unique_lock<std::mutex> lock(mInstance->mLock);
+
+		mInstance->mNextFlushTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(WATCHER_RETRY_DELAY);
+
+		for (auto path : paths)
+			mInstance->mPendingPaths.insert(path);
+
+		return;
+	}
+
+	std::vector<std::string> changes(paths.cbegin(), paths.cend());
+
+	for (auto system : SystemData::sSystemVector)
+		system->updateFiles(changes);
+}
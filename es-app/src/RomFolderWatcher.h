@@ -0,0 +1,50 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+class Window;
+
+// Watches the rom folders of the systems with inotify (linux only), and adds or removes the games created, deleted or renamed
+// Events are batched : the games are updated once the folders have been quiet for a while, without reloading the systems
+class RomFolderWatcher
+{
+public:
+	static void start(Window* window);
+	static void stop();
+	static bool isRunning() { return mInstance != nullptr; }
+
+private:
+	RomFolderWatcher(Window* window, const std::map<std::string, std::string>& paths);
+	~RomFolderWatcher();
+
+	void run();
+
+	void addWatch(const std::string& path, const std::string& systemName);
+	void removeWatches(const std::string& path);
+	void readEvents();
+	void flush();
+
+	static void applyChanges(std::set<std::string> paths);
+
+	Window*			mWindow;
+	std::thread*	mThread;
+	bool			mExit;
+
+	int				mFd;
+	std::map<int, std::pair<std::string, std::string>>	mWatches; // watch descriptor -> folder path, system name
+	std::map<std::string, std::string>	mRootPaths; // rom folder -> system name
+
+	std::mutex				mLock;
+	std::set<std::string>	mPendingPaths;
+	std::chrono::steady_clock::time_point	mLastEventTime;
+	std::chrono::steady_clock::time_point	mFirstEventTime;
+	std::chrono::steady_clock::time_point	mNextFlushTime;
+
+	static RomFolderWatcher* mInstance;
+};
@@ -10,10 +10,16 @@
 #include "Win32ApiSystem.h"
 #endif
 
+std::thread* SaveStateRepository::mIndexingThread = nullptr;
+bool SaveStateRepository::mIndexingExit = false;
+
 SaveStateRepository::SaveStateRepository(SystemData* system)
 {
 	mSystem = system;
-	refresh();
+	mLoaded = false;
+	mStale = false;
+	mFolderTime = 0;
+	mListingTime = 0;
 }
 
 SaveStateRepository::~SaveStateRepository()
@@ -28,21 +34,59 @@ void SaveStateRepository::clear()
 			delete state;
 
 	mStates.clear();
+	mDatedRoms.clear();
 }
 
 std::string SaveStateRepository::getSavesPath()
 {
 	return Utils::FileSystem::combine(Paths::getSavesPath(), mSystem->getName());
 }
-	
-void SaveStateRepository::refresh()
+
+void SaveStateRepository::refresh(FileData* game)
+{
+	std::unique_lock<std::mutex> lock(mLock);
+
+	mStale = true;
+
+	if (game != nullptr)
+		mDatedRoms.erase(Utils::FileSystem::getStem(game->getPath()));
+}
+
+// Must be called with mLock held
+void SaveStateRepository::ensureIndex()
+{
+	if (mLoaded && !mStale)
+		return;
+
+	if (mLoaded)
+	{
+		mStale = false;
+
+		// Adding, removing or renaming a state changes the folder time. The folder is listed again only in that case, 
+		// or if it was modified during the second it was listed, as its time can't tell if it has changed since then
+		time_t folderTime = Utils::FileSystem::getFileModificationDate(getSavesPath()).getTime();
+		if (folderTime == mFolderTime && mFolderTime < mListingTime)
+			return;
+	}
+
+	loadIndex();
+}
+
+void SaveStateRepository::loadIndex()
 {
 	clear();
 
+	mLoaded = true;
+	mStale = false;
+	mListingTime = time(NULL);
+	mFolderTime = 0;
+
 	auto path = getSavesPath();
 	if (!Utils::FileSystem::exists(path))
 		return;
-	
+
+	mFolderTime = Utils::FileSystem::getFileModificationDate(path).getTime();
+
 	auto files = Utils::FileSystem::getDirectoryFiles(path);
 	for (auto file : files)
 	{
@@ -78,21 +122,44 @@ void SaveStateRepository::refresh()
 
 #if WIN32
 		state->creationDate.setTime(file.lastWriteTime);
-#else
-		state->creationDate = Utils::FileSystem::getFileModificationDate(state->fileName);
 #endif
 
 		mStates[stem].push_back(state);
 	}
+
+#if WIN32
+	// The dates are given by the folder listing
+	for (auto item : mStates)
+		mDatedRoms.insert(item.first);
+#endif
+}
+
+// The dates are only needed to display the states of a game : they are not read when the folder is listed
+void SaveStateRepository::readDates(const std::string& rom)
+{
+	if (mDatedRoms.find(rom) != mDatedRoms.cend())
+		return;
+
+	mDatedRoms.insert(rom);
+
+	auto it = mStates.find(rom);
+	if (it == mStates.cend())
+		return;
+
+	for (auto state : it->second)
+		state->creationDate = Utils::FileSystem::getFileModificationDate(state->fileName);
 }
 
 bool SaveStateRepository::hasSaveStates(FileData* game)
 {
+	if (game->getSourceFileData()->getSystem() != mSystem)
+		return false;
+
+	std::unique_lock<std::mutex> lock(mLock);
+	ensureIndex();
+
 	if (mStates.size())
 	{
-		if (game->getSourceFileData()->getSystem() != mSystem)
-			return false;
-
 		auto it = mStates.find(Utils::FileSystem::getStem(game->getPath()));
 		if (it != mStates.cend())
 			return true;
@@ -100,18 +167,71 @@ bool SaveStateRepository::hasSaveStates(FileData* game)
 
 	return false;
 }
+
 std::vector<SaveState*> SaveStateRepository::getSaveStates(FileData* game)
 {
 	if (isEnabled(game) && game->getSourceFileData()->getSystem() == mSystem)
 	{
-		auto it = mStates.find(Utils::FileSystem::getStem(game->getPath()));
+		std::unique_lock<std::mutex> lock(mLock);
+		ensureIndex();
+
+		auto rom = Utils::FileSystem::getStem(game->getPath());
+
+		auto it = mStates.find(rom);
 		if (it != mStates.cend())
+		{
+			readDates(rom);
 			return it->second;
+		}
 	}
 
 	return std::vector<SaveState*>();
 }
 
+void SaveStateRepository::startIndexing()
+{
+	if (mIndexingThread != nullptr)
+		return;
+
+	// Repositories are created here, the thread only fills them
+	std::vector<SaveStateRepository*> repositories;
+
+	for (auto system : SystemData::sSystemVector)
+		if (system->isGameSystem() && !system->isCollection() && system->getRootFolder()->getChildren().size() > 0)
+			repositories.push_back(system->getSaveStateRepository());
+
+	if (repositories.size() == 0)
+		return;
+
+	mIndexingExit = false;
+	mIndexingThread = new std::thread([repositories]()
+	{
+		for (auto repository : repositories)
+		{
+			if (mIndexingExit)
+				break;
+
+			std::unique_lock<std::mutex> lock(repository->mLock);
+
+			// An index loaded meanwhile may have been given to the UI : it can't be reloaded from here
+			if (!repository->mLoaded)
+				repository->loadIndex();
+		}
+	});
+}
+
+void SaveStateRepository::stopIndexing()
+{
+	if (mIndexingThread == nullptr)
+		return;
+
+	mIndexingExit = true;
+	mIndexingThread->join();
+
+	delete mIndexingThread;
+	mIndexingThread = nullptr;
+}
+
 bool SaveStateRepository::isEnabled(FileData* game)
 {
 	auto emulatorName = game->getEmulator();
@@ -157,7 +277,7 @@ void SaveStateRepository::renumberSlots(FileData* game)
 		return;
 
 	auto repo = game->getSourceFileData()->getSystem()->getSaveStateRepository();	
-	repo->refresh();
+	repo->refresh(game);
 
 	auto states = repo->getSaveStates(game);
 	if (states.size() == 0)
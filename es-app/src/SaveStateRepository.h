@@ -3,6 +3,10 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
+#include <mutex>
+#include <thread>
+#include <time.h>
 
 #include "SaveState.h"
 
@@ -19,6 +23,10 @@ public:
 	static int	getNextFreeSlot(FileData* game);
 	static void renumberSlots(FileData* game);
 
+	// Index the save states of every system in the background, so the first gamelist doesn't have to list them
+	static void startIndexing();
+	static void stopIndexing();
+
 	bool hasSaveStates(FileData* game);
 
 	std::vector<SaveState*> getSaveStates(FileData* game);
@@ -26,9 +34,27 @@ public:
 	std::string getSavesPath();
 
 	void clear();
-	void refresh();
+
+	// The index is reloaded on next access, and only if the saves folder has changed
+	// game : the states of this game are read again even if the folder has not changed (states overwritten by the emulator)
+	void refresh(FileData* game = nullptr);
 
 private:
+	void ensureIndex();
+	void loadIndex();
+	void readDates(const std::string& rom);
+
 	SystemData* mSystem;
 	std::map<std::string, std::vector<SaveState*>> mStates;
+
+	std::mutex				mLock;
+	bool					mLoaded;
+	bool					mStale;
+	time_t					mFolderTime;	// Modification time of the saves folder when it was listed
+	time_t					mListingTime;
+
+	std::set<std::string>	mDatedRoms;		// Roms whose states creation dates have been read
+
+	static std::thread*		mIndexingThread;
+	static bool				mIndexingExit;
 };
@@ -0,0 +1,198 @@
+#include "ScreenSaverMediaIndex.h"
+
+#include "utils/FileSystemUtil.h"
+#include "utils/Randomizer.h"
+#include "FileData.h"
+#include "FileFilterIndex.h"
+#include "Log.h"
+#include "Settings.h"
+#include "SystemData.h"
+#include <unordered_set>
+
+ScreenSaverMediaIndex::ScreenSaverMediaIndex(bool video)
+{
+	mVideo = video;
+	mThread = nullptr;
+	mExit = false;
+	mBuilt = false;
+	mChildrenVersion = 0;
+	mMetadataVersion = 0;
+	mSettingsGeneration = 0;
+	mFilterVersion = 0;
+}
+
+ScreenSaverMediaIndex::~ScreenSaverMediaIndex()
+{
+	stopValidation();
+}
+
+void ScreenSaverMediaIndex::update()
+{
+	unsigned int childrenVersion = FolderData::getChildrenVersion();
+	unsigned int metadataVersion = MetaDataList::getLastVersion();
+	unsigned int settingsGeneration = Settings::getGeneration();
+	unsigned int filterVersion = 0;
+
+	for (auto system : SystemData::sSystemVector)
+	{
+		auto idx = system->getIndex(false);
+		if (idx != nullptr && idx->getFilterVersion() > filterVersion)
+			filterVersion = idx->getFilterVersion();
+	}
+
+	if (mBuilt && childrenVersion == mChildrenVersion && metadataVersion == mMetadataVersion && settingsGeneration == mSettingsGeneration && filterVersion == mFilterVersion)
+		return;
+
+	// The games being checked may not exist anymore. The ones not checked yet are not known : they are taken again below
+	stopValidation();
+
+	std::unordered_set<FileData*> games;
+
+	for (auto system : SystemData::sSystemVector)
+	{
+		// We only want nodes from game systems that are not collections
+		if (!system->isGameSystem() || system->isCollection() || system->hasPlatformId(PlatformIds::IMAGEVIEWER) || system->hasPlatformId(PlatformIds::PLATFORM_IGNORE))
+			continue;
+
+		for (auto game : system->getRootFolder()->getFilesRecursive(GAME, true))
+			games.insert(game);
+	}
+
+	std::vector<Candidate> pending;
+
+	std::unique_lock<std::mutex> lock(mLock);
+
+	for (auto it = mKnownGames.begin(); it != mKnownGames.end(); )
+	{
+		if (games.find(it->first) == games.cend())
+		{
+			removeCandidate(it->first);
+			it = mKnownGames.erase(it);
+		}
+		else
+			++it;
+	}
+
+	for (auto game : games)
+	{
+		auto known = mKnownGames.find(game);
+		if (known != mKnownGames.cend() && known->second.metadataVersion == game->getMetadata().getVersion() && known->second.gamePath == game->getPath())
+			continue;
+
+		removeCandidate(game);
+		if (known != mKnownGames.cend())
+			mKnownGames.erase(known);
+
+		Candidate candidate;
+		candidate.game = game;
+		candidate.path = mVideo ? game->getVideoPath() : game->getImagePath();
+		candidate.gamePath = game->getPath();
+		candidate.metadataVersion = game->getMetadata().getVersion();
+
+		if (candidate.path.empty())
+			mKnownGames[game] = candidate;
+		else
+			pending.push_back(candidate);
+	}
+
+	lock.unlock();
+
+	mBuilt = true;
+	mChildrenVersion = childrenVersion;
+	mMetadataVersion = metadataVersion;
+	mSettingsGeneration = settingsGeneration;
+	mFilterVersion = filterVersion;
+
+	if (pending.size() == 0)
+		return;
+
+	LOG(LogDebug) << "ScreenSaverMediaIndex : Checking " << pending.size() << (mVideo ? " videos" : " images");
+
+	mExit = false;
+	mThread = new std::thread(&ScreenSaverMediaIndex::validate, this, pending);
+}
+
+void ScreenSaverMediaIndex::waitValidation()
+{
+	if (mThread == nullptr)
+		return;
+
+	mThread->join();
+
+	delete mThread;
+	mThread = nullptr;
+}
+
+FileData* ScreenSaverMediaIndex::pick(std::string& path)
+{
+	std::unique_lock<std::mutex> lock(mLock);
+
+	if (mCandidates.size() == 0)
+		return nullptr;
+
+	auto& candidate = mCandidates[Randomizer::random(mCandidates.size()) % mCandidates.size()];
+	path = candidate.path;
+	return candidate.game;
+}
+
+void ScreenSaverMediaIndex::remove(FileData* game)
+{
+	std::unique_lock<std::mutex> lock(mLock);
+	removeCandidate(game);
+}
+
+size_t ScreenSaverMediaIndex::size()
+{
+	std::unique_lock<std::mutex> lock(mLock);
+	return mCandidates.size();
+}
+
+void ScreenSaverMediaIndex::validate(std::vector<Candidate> pending)
+{
+	for (auto candidate : pending)
+	{
+		if (mExit)
+			break;
+
+		// The game is never dereferenced here
+		bool exists = Utils::FileSystem::exists(candidate.path);
+
+		std::unique_lock<std::mutex> lock(mLock);
+
+		mKnownGames[candidate.game] = candidate;
+
+		if (exists)
+		{
+			mPositions[candidate.game] = mCandidates.size();
+			mCandidates.push_back(candidate);
+		}
+	}
+}
+
+void ScreenSaverMediaIndex::stopValidation()
+{
+	if (mThread == nullptr)
+		return;
+
+	mExit = true;
+	waitValidation();
+}
+
+// Must be called with mLock held
+void ScreenSaverMediaIndex::removeCandidate(FileData* game)
+{
+	auto it = mPositions.find(game);
+	if (it == mPositions.cend())
+		return;
+
+	size_t index = it->second;
+	mPositions.erase(it);
+
+	if (index != mCandidates.size() - 1)
+	{
+		mCandidates[index] = mCandidates.back();
+		mPositions[mCandidates[index].game] = index;
+	}
+
+	mCandidates.pop_back();
+}
@@ -0,0 +1,66 @@
+#pragma once
+#ifndef ES_APP_SCREEN_SAVER_MEDIA_INDEX_H
+#define ES_APP_SCREEN_SAVER_MEDIA_INDEX_H
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class FileData;
+
+// Games having a video (or an image) usable by the screensaver, with their media path.
+// The game list is compared to the previous one on the UI thread, which only costs a walk of the games,
+// and the media files of the new or changed games are checked in the background.
+// Picks & removals are O(1) : the candidates are a vector, a removed candidate is replaced by the last one.
+class ScreenSaverMediaIndex
+{
+public:
+	ScreenSaverMediaIndex(bool video);
+	~ScreenSaverMediaIndex();
+
+	// Must be called on the UI thread, before picking : removed games are dropped here
+	void update();
+
+	// Waits until the media files of the last update are checked
+	void waitValidation();
+
+	FileData* pick(std::string& path);
+
+	// The game stays known : it won't be taken again until its metadata changes
+	void remove(FileData* game);
+
+	size_t size();
+
+private:
+	struct Candidate
+	{
+		FileData*		game;
+		std::string		path;
+		std::string		gamePath;	// A new game can get the address of a deleted one
+		unsigned int	metadataVersion;
+	};
+
+	void validate(std::vector<Candidate> pending);
+	void stopValidation();
+	void removeCandidate(FileData* game);
+
+	bool			mVideo;
+
+	std::mutex		mLock;
+	std::vector<Candidate>						mCandidates;
+	std::unordered_map<FileData*, size_t>		mPositions;
+	std::unordered_map<FileData*, Candidate>	mKnownGames;
+
+	std::thread*	mThread;
+	bool			mExit;
+
+	bool			mBuilt;
+	unsigned int	mChildrenVersion;
+	unsigned int	mMetadataVersion;
+	unsigned int	mSettingsGeneration;
+	unsigned int	mFilterVersion;
+};
+
+#endif // ES_APP_SCREEN_SAVER_MEDIA_INDEX_H
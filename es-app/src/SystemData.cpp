@@ -18,7 +18,9 @@
 #include "utils/StringUtil.h"
 #include "utils/Randomizer.h"
 #include "views/ViewController.h"
+#include "views/gamelist/IGameListView.h"
 #include "ThreadedHasher.h"
+#include "RomFolderWatcher.h"
 #include <unordered_set>
 #include <algorithm>
 #include <functional>
@@ -114,9 +116,6 @@ SystemData::SystemData(const SystemMetadata& meta, SystemEnvironmentData* envDat
 		setSystemViewMode(defaultView, gridSizeOverride, false);
 
 		setIsGameSystemStatus();
-
-		if (Settings::PreloadMedias())
-			getSaveStateRepository();
 	}
 }
 
@@ -290,18 +289,9 @@ void SystemData::populateFolder(FolderData* folder, std::unordered_map<std::stri
 				}
 			}
 
-			// Don't loose time looking in downloaded_images, downloaded_videos & media folders
-			if (fn == "media" || fn == "medias" || fn == "images" || fn == "manuals" || fn == "videos" || fn == "assets" || Utils::String::startsWith(fn, "downloaded_") || Utils::String::startsWith(fn, "."))
-				continue;
-			
-			// Hardcoded optimisation : WiiU has so many files in content & meta directories
-			if (mMetadata.name == "wiiu" && (fn == "content" || fn == "meta"))
+			if (isIgnoredFolder(mMetadata.name, fn))
 				continue;
 
-			// Hardcoded optimisation : vpinball 'roms' subfolder must be excluded
-			if (mMetadata.name == "vpinball" && fn == "roms")
-				continue;			
-
 			FolderData* newFolder = new FolderData(filePath, this);
 			populateFolder(newFolder, fileMap);
 
@@ -321,6 +311,273 @@ void SystemData::populateFolder(FolderData* folder, std::unordered_map<std::stri
 	}
 }
 
+bool SystemData::isIgnoredFolder(const std::string& systemName, const std::string& folderName)
+{
+	std::string fn = Utils::String::toLower(folderName);
+
+	// Never look in "artwork", reserved for mame roms artwork
+	if (fn == "artwork")
+		return true;
+
+	// Don't loose time looking in downloaded_images, downloaded_videos & media folders
+	if (fn == "media" || fn == "medias" || fn == "images" || fn == "manuals" || fn == "videos" || fn == "assets" || Utils::String::startsWith(fn, "downloaded_") || Utils::String::startsWith(fn, "."))
+		return true;
+
+	// Hardcoded optimisation : WiiU has so many files in content & meta directories
+	if (systemName == "wiiu" && (fn == "content" || fn == "meta"))
+		return true;
+
+	// Hardcoded optimisation : vpinball 'roms' subfolder must be excluded
+	if (systemName == "vpinball" && fn == "roms")
+		return true;
+
+	return false;
+}
+
+// Files & folders created or deleted in the rom folders : games are added or removed from the tree, the indexes & the collections
+// Returns false if none of the paths belongs to the system
+bool SystemData::updateFiles(const std::vector<std::string>& paths)
+{
+	if (mIsCollectionSystem || !mIsGameSystem || mEnvData == nullptr || mRootFolder == nullptr)
+		return false;
+
+	const std::string& startPath = mEnvData->mStartPath;
+	if (startPath.empty())
+		return false;
+
+	std::vector<std::string> systemPaths;
+	for (auto path : paths)
+		if (Utils::String::startsWith(path, startPath + "/"))
+			systemPaths.push_back(path);
+
+	if (systemPaths.size() == 0)
+		return false;
+
+	// Parents are processed before their children
+	std::sort(systemPaths.begin(), systemPaths.end());
+
+	std::unordered_map<std::string, FileData*> tree;
+	tree[startPath] = mRootFolder;
+
+	std::stack<FolderData*> stack;
+	stack.push(mRootFolder);
+
+	while (stack.size())
+	{
+		FolderData* current = stack.top();
+		stack.pop();
+
+		for (auto it : current->getChildren())
+		{
+			tree[it->getPath()] = it;
+
+			if (it->getType() == FOLDER)
+				stack.push((FolderData*)it);
+		}
+	}
+
+	SystemData* viewSystem = isGroupChildSystem() ? getParentGroupSystem() : this;
+
+	// No view to update when the UI isn't created yet
+	std::shared_ptr<IGameListView> view;
+	if (ViewController::get() != nullptr)
+		view = ViewController::get()->getGameListView(viewSystem, false);
+
+	// Items at the root of a grouped system are also children of its folder in the group
+	FolderData* groupFolder = nullptr;
+	if (viewSystem != this)
+	{
+		for (auto child : viewSystem->getRootFolder()->getChildren())
+		{
+			if (child->getType() == FOLDER && child->getSystem() == this && ((FolderData*)child)->isVirtualStorage())
+			{
+				groupFolder = (FolderData*)child;
+				break;
+			}
+		}
+	}
+
+	bool showHidden = Settings::ShowHiddenFiles();
+
+	auto shv = Settings::getInstance()->getString(getName() + ".ShowHiddenFiles");
+	if (shv == "1") showHidden = true;
+	else if (shv == "0") showHidden = false;
+
+	std::unordered_map<std::string, FileData*> fileMap;
+	bool removedFolders = false;
+
+	for (auto path : systemPaths)
+	{
+		auto it = tree.find(path);
+
+		if (!Utils::FileSystem::exists(path))
+		{
+			if (it == tree.cend())
+				continue;
+
+			FileData* file = it->second;
+
+			std::vector<FileData*> games;
+			if (file->getType() == FOLDER)
+				games = ((FolderData*)file)->getFilesRecursive(GAME);
+			else
+				games.push_back(file);
+
+			for (auto game : games)
+			{
+				tree.erase(game->getPath());
+				CollectionSystemManager::get()->deleteCollectionFiles(game);
+
+				// The game is only removed from the index of its own system when deleted
+				if (viewSystem != this)
+					viewSystem->removeFromIndex(game);
+
+				// A removed folder reloads the whole view below, no need to update it for each of its games
+				if (view != nullptr && file->getType() != FOLDER)
+					view.get()->remove(game);
+				else
+				{
+					viewSystem->getRootFolder()->removeFromVirtualFolders(game);
+					delete game;
+				}
+			}
+
+			if (file->getType() == FOLDER)
+			{
+				for (auto child : ((FolderData*)file)->getFilesRecursive(FOLDER))
+					tree.erase(child->getPath());
+
+				tree.erase(it);
+
+				if (groupFolder != nullptr)
+				{
+					auto child = std::find(groupFolder->mChildren.begin(), groupFolder->mChildren.end(), file);
+					if (child != groupFolder->mChildren.end())
+						groupFolder->mChildren.erase(child);
+				}
+
+				delete file;
+				removedFolders = true;
+			}
+
+			continue;
+		}
+
+		if (it != tree.cend())
+			continue;
+
+		if (!showHidden && Utils::FileSystem::isHidden(path))
+			continue;
+
+		// Find the parent folder, creating the folders that had no games
+		std::vector<std::string> missingFolders;
+
+		std::string parentPath = Utils::FileSystem::getParent(path);
+		auto parent = tree.find(parentPath);
+		while (parent == tree.cend() && parentPath.size() > startPath.size())
+		{
+			missingFolders.push_back(parentPath);
+			parentPath = Utils::FileSystem::getParent(parentPath);
+			parent = tree.find(parentPath);
+		}
+
+		if (parent == tree.cend() || parent->second->getType() != FOLDER)
+			continue;
+
+		bool ignored = false;
+		for (auto folderPath : missingFolders)
+			if (isIgnoredFolder(mMetadata.name, Utils::FileSystem::getFileName(folderPath)))
+				ignored = true;
+
+		if (ignored)
+			continue;
+
+		FileData* newFile = nullptr;
+
+		if (mEnvData->isValidExtension(Utils::String::toLower(Utils::FileSystem::getExtension(path))))
+		{
+			newFile = new FileData(GAME, path, this);
+			if (newFile->isArcadeAsset())
+			{
+				delete newFile;
+				continue;
+			}
+		}
+		else if (Utils::FileSystem::isDirectory(path))
+		{
+			if (isIgnoredFolder(mMetadata.name, Utils::FileSystem::getFileName(path)))
+				continue;
+
+			FolderData* newFolder = new FolderData(path, this);
+			populateFolder(newFolder, fileMap);
+
+			if (newFolder->getChildren().size() == 0)
+			{
+				delete newFolder;
+				continue;
+			}
+
+			newFile = newFolder;
+		}
+		else
+			continue;
+
+		FolderData* folder = (FolderData*)parent->second;
+		for (auto folderPath = missingFolders.crbegin(); folderPath != missingFolders.crend(); ++folderPath)
+		{
+			FolderData* newFolder = new FolderData(*folderPath, this);
+			folder->addChild(newFolder);
+			tree[*folderPath] = newFolder;
+			fileMap[*folderPath] = newFolder;
+			folder = newFolder;
+		}
+
+		folder->addChild(newFile);
+		tree[path] = newFile;
+		fileMap[path] = newFile;
+
+		if (newFile->getType() == FOLDER)
+			for (auto child : ((FolderData*)newFile)->getFilesRecursive(GAME | FOLDER))
+				tree[child->getPath()] = child;
+	}
+
+	if (fileMap.size() > 0 && Settings::RemoveMultiDiskContent())
+		removeMultiDiskContent(fileMap);
+
+	std::vector<FileData*> newGames;
+	for (auto file : fileMap)
+	{
+		if (file.second->getType() == GAME)
+			newGames.push_back(file.second);
+
+		if (groupFolder != nullptr && file.second->getParent() == mRootFolder)
+			groupFolder->addChild(file.second, false);
+	}
+
+	for (auto game : newGames)
+	{
+		addToIndex(game);
+		if (viewSystem != this)
+			viewSystem->addToIndex(game);
+
+		CollectionSystemManager::get()->refreshCollectionSystems(game);
+	}
+
+	LOG(LogDebug) << "SystemData::updateFiles " << getName() << " : " << newGames.size() << " games added";
+
+	updateDisplayedGameCount();
+	if (viewSystem != this)
+		viewSystem->updateDisplayedGameCount();
+
+	// The view may hold the removed folders in its navigation stack : it is created again
+	if (removedFolders && ViewController::get() != nullptr)
+		ViewController::get()->reloadGameListView(viewSystem);
+	else if (view != nullptr && newGames.size() > 0)
+		view->repopulate();
+
+	return true;
+}
+
 FileFilterIndex* SystemData::getIndex(bool createIndex)
 {
 	if (mFilterIndex == nullptr && createIndex)
@@ -342,6 +599,34 @@ void SystemData::deleteIndex()
 	}
 }
 
+void SystemData::updateIndex(FileData* game)
+{
+	if (mFilterIndex != nullptr)
+		mFilterIndex->updateIndex(game);
+
+	if (isGroupChildSystem() && getParentGroupSystem() != nullptr)
+		getParentGroupSystem()->updateIndex(game);
+}
+
+// Compares the incrementally maintained index with a full rebuild of the index
+bool SystemData::checkIndex()
+{
+	if (mFilterIndex == nullptr)
+		return true;
+
+	auto currentIndex = mFilterIndex;
+
+	mFilterIndex = new FileFilterIndex();
+	indexAllGameFilters(mRootFolder);
+
+	bool ret = currentIndex->isIndexEqual(mFilterIndex);
+
+	delete mFilterIndex;
+	mFilterIndex = currentIndex;
+
+	return ret;
+}
+
 void SystemData::indexAllGameFilters(const FolderData* folder)
 {
 	const std::vector<FileData*>& children = folder->getChildren();
@@ -896,6 +1181,11 @@ bool SystemData::loadConfig(Window* window)
 			ThreadedHasher::start(window, (ThreadedHasher::HasherType)checkIndex, false, true);
 	}
 
+	if (window != nullptr && Settings::getInstance()->getBool("WatchRomFolders"))
+		RomFolderWatcher::start(window);
+
+	SaveStateRepository::startIndexing();
+
 	return true;
 }
 
@@ -1144,6 +1434,9 @@ bool SystemData::hasDirtySystems()
 
 void SystemData::deleteSystems()
 {
+	RomFolderWatcher::stop();
+	SaveStateRepository::stopIndexing();
+
 	bool saveOnExit = !Settings::IgnoreGamelist() && Settings::SaveGamelistsOnExit();
 
 	for (unsigned int i = 0; i < sSystemVector.size(); i++)
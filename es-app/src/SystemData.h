@@ -134,6 +134,12 @@ public:
 		if (mFilterIndex != nullptr) mFilterIndex->addToIndex(game);
 	};
 
+	void updateIndex(FileData* game);
+	bool checkIndex();
+
+	bool updateFiles(const std::vector<std::string>& paths);
+	static bool isIgnoredFolder(const std::string& systemName, const std::string& folderName);
+
 	void resetFilters() {
 		if (mFilterIndex != nullptr) mFilterIndex->resetFilters();
 	};
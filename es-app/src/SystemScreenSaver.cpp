@@ -11,6 +11,7 @@
 #include "FileFilterIndex.h"
 #include "Log.h"
 #include "PowerSaver.h"
+#include "ScreenSaverMediaIndex.h"
 #include "Scripting.h"
 #include "Sound.h"
 #include "SystemData.h"
@@ -27,13 +28,16 @@
 #include "ApiSystem.h"
 
 #define FADE_TIME 			500
+// Delay between two checks of the game changes while the screensaver is inactive
+#define MEDIA_INDEX_UPDATE_DELAY	5000
 
 SystemScreenSaver::SystemScreenSaver(Window* window) :
 	mVideoScreensaver(NULL),
 	mImageScreensaver(NULL),
 	mWindow(window),
-	mGamesWithVideosLoaded(false),
-	mGamesWithImagesLoaded(false),
+	mImageIndex(nullptr),
+	mVideoIndex(nullptr),
+	mIndexUpdateTimer(0),
 	mState(STATE_INACTIVE),
 	mOpacity(0.0f),
 	mTimer(0),
@@ -56,6 +60,12 @@ SystemScreenSaver::~SystemScreenSaver()
 	// Delete subtitle file, if existing
 	remove(getTitlePath().c_str());
 	mCurrentGame = NULL;
+
+	if (mImageIndex != nullptr)
+		delete mImageIndex;
+
+	if (mVideoIndex != nullptr)
+		delete mVideoIndex;
 }
 
 bool SystemScreenSaver::allowSleep()
@@ -284,50 +294,20 @@ void SystemScreenSaver::renderScreenSaver()
 	}
 }
 
-unsigned long SystemScreenSaver::countGameListNodes(bool video)
+ScreenSaverMediaIndex* SystemScreenSaver::getMediaIndex(bool video)
 {
-	if (video && mGamesWithVideosLoaded)
-		return mGamesWithVideos.size();
-
-	if (!video && mGamesWithImagesLoaded)
-		return mGamesWithImages.size();
-
-	unsigned long nodeCount = 0;
-
 	if (video)
 	{
-		mGamesWithVideosLoaded = true;
-		mGamesWithVideos.clear();
-	}
-	else
-	{
-		mGamesWithImagesLoaded = true;
-		mGamesWithImages.clear();
-	}
-
-	for (auto system : SystemData::sSystemVector)
-	{
-		// We only want nodes from game systems that are not collections
-		if (!system->isGameSystem() || system->isCollection() || system->hasPlatformId(PlatformIds::IMAGEVIEWER) || system->hasPlatformId(PlatformIds::PLATFORM_IGNORE))
-			continue;
+		if (mVideoIndex == nullptr)
+			mVideoIndex = new ScreenSaverMediaIndex(true);
 
-		auto games = system->getRootFolder()->getFilesRecursive(GAME, true);
-		for (auto game : games)
-		{
-			if (video && !game->getVideoPath().empty())
-			{
-				mGamesWithVideos.push_back(game);
-				nodeCount++;
-			}
-			else if (!video && !game->getImagePath().empty())
-			{
-				mGamesWithImages.push_back(game);
-				nodeCount++;
-			}
-		}
+		return mVideoIndex;
 	}
 
-	return nodeCount;
+	if (mImageIndex == nullptr)
+		mImageIndex = new ScreenSaverMediaIndex(false);
+
+	return mImageIndex;
 }
 
 std::string  SystemScreenSaver::selectGameMedia(FileData* game, bool video)
@@ -361,36 +341,23 @@ std::string SystemScreenSaver::pickRandomGameMedia(bool video)
 {
 	mCurrentGame = NULL;
 
-	int count = countGameListNodes(video);
-	if (count == 0)
-		return "";
+	auto index = getMediaIndex(video);
+	index->update();
 
-	std::vector<FileData*>* games = &mGamesWithImages;
-	if (video)
-		games = &mGamesWithVideos;	
+	int retry = 10;
+	while (retry-- > 0)
+	{
+		std::string path;
 
-	int randomValue = Randomizer::random(count) % count;
-	int index = randomValue;
+		auto game = index->pick(path);
+		if (game == nullptr)
+			break;
 
-	while (true)
-	{
-		auto path = selectGameMedia(games->at(index), video);
+		path = selectGameMedia(game, video);
 		if (!path.empty())
 			return path;
-		
-		games->erase(std::next(games->begin(), index));
-		
-		count = games->size();
-		if (count == 0)
-			break;
 
-		index--;
-
-		if (index < 0)
-			index = count - 1;
-
-		if (index == randomValue)
-			break;
+		index->remove(game);
 	}
 
 	return "";
@@ -477,6 +444,22 @@ void SystemScreenSaver::update(int deltaTime)
 			nextVideo();
 	}
 
+	else if (mState == STATE_INACTIVE)
+	{
+		// Keep the media index of the screensaver up to date, so that starting it doesn't have to list the games
+		mIndexUpdateTimer += deltaTime;
+		if (mIndexUpdateTimer >= MEDIA_INDEX_UPDATE_DELAY)
+		{
+			mIndexUpdateTimer = 0;
+
+			std::string screensaver_behavior = Settings::getInstance()->getString("ScreenSaverBehavior");
+			if (screensaver_behavior == "random video" && !Settings::getInstance()->getBool("SlideshowScreenSaverCustomVideoSource"))
+				getMediaIndex(true)->update();
+			else if (screensaver_behavior == "slideshow" && !Settings::getInstance()->getBool("SlideshowScreenSaverCustomImageSource"))
+				getMediaIndex(false)->update();
+		}
+	}
+
 	// If we have a loaded video then update it
 	if (mVideoScreensaver)
 		mVideoScreensaver->update(deltaTime);
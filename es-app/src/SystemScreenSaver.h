@@ -49,6 +49,7 @@ private:
 };
 
 class SystemScreenSaver;
+class ScreenSaverMediaIndex;
 
 class VideoScreenSaver : public GameScreenSaverBase
 {
@@ -85,10 +86,11 @@ public:
 
 	virtual FileData* getCurrentGame();
 	virtual void launchGame();
-	inline virtual void resetCounts() { mGamesWithVideosLoaded = false; mGamesWithImagesLoaded = false; mGamesWithImages.clear(); mGamesWithVideos.clear(); };
+	// The media indexes follow the game changes by themselves : nothing to reset
+	inline virtual void resetCounts() { };
 
 private:
-	unsigned long countGameListNodes(bool video = false);
+	ScreenSaverMediaIndex* getMediaIndex(bool video);
 
 	std::string pickRandomGameMedia(bool video = false);
 	std::string pickRandomCustomImage(bool video = false);
@@ -107,11 +109,10 @@ private:
 	std::shared_ptr<ImageScreenSaver>		mFadingImageScreensaver;
 	std::shared_ptr<ImageScreenSaver>		mImageScreensaver;
 
-	std::vector<FileData*> mGamesWithImages;
-	std::vector<FileData*> mGamesWithVideos;
+	ScreenSaverMediaIndex*	mImageIndex;
+	ScreenSaverMediaIndex*	mVideoIndex;
+	int						mIndexUpdateTimer;
 
-	bool			mGamesWithVideosLoaded;
-	bool			mGamesWithImagesLoaded;
 	Window*			mWindow;
 	STATE			mState;
 	float			mOpacity;
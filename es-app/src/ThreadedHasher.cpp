@@ -111,17 +111,24 @@ void ThreadedHasher::run()
 			}
 		}		
 
-		if (netplay)
+		if (netplay && cheevos)
+		{
+			LOG(LogDebug) << "CheckCrc32AndCheevosHash : " << label;
+			game->checkCrc32AndCheevosHash(mForce);
+		}
+		else if (netplay)
 		{
 			LOG(LogDebug) << "CheckCrc32 : " << label;
 			game->checkCrc32(mForce);
 		}
-
-		if (cheevos)
+		else if (cheevos)
 		{
 			LOG(LogDebug) << "CheckCheevosHash : " << label;
 			game->checkCheevosHash(mForce);
+		}
 
+		if (cheevos)
+		{
 			auto hash = Utils::String::toUpper(game->getMetadata(MetaDataId::CheevosHash));
 			if (!hash.empty())
 			{
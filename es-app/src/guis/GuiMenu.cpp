@@ -56,6 +56,7 @@
 #include "Gamelist.h"
 #include "TextToSpeech.h"
 #include "Paths.h"
+#include "RomFolderWatcher.h"
 
 #if WIN32
 #include "Win32ApiSystem.h"
@@ -1269,6 +1270,23 @@ void GuiMenu::openDeveloperSettings()
 	s->addWithDescription(_("PARSE GAMELISTS ONLY"), _("Debug tool: Don't check if the ROMs actually exist. Can cause problems!"), parse_gamelists);
 	s->addSaveFunc([parse_gamelists] { Settings::getInstance()->setBool("ParseGamelistOnly", parse_gamelists->getState()); });
 
+#if defined(__linux__)
+	// rom folders watcher
+	auto watch_roms = std::make_shared<SwitchComponent>(mWindow);
+	watch_roms->setState(Settings::getInstance()->getBool("WatchRomFolders"));
+	s->addWithDescription(_("WATCH ROM FOLDERS"), _("Add or remove the games copied to or deleted from the rom folders, without updating the gamelists."), watch_roms);
+	s->addSaveFunc([this, watch_roms]
+	{
+		if (Settings::getInstance()->setBool("WatchRomFolders", watch_roms->getState()))
+		{
+			if (watch_roms->getState())
+				RomFolderWatcher::start(mWindow);
+			else
+				RomFolderWatcher::stop();
+		}
+	});
+#endif
+
 	// Local Art
 	auto local_art = std::make_shared<SwitchComponent>(mWindow);
 	local_art->setState(Settings::getInstance()->getBool("LocalArt"));
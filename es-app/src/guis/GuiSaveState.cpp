@@ -230,7 +230,7 @@ bool GuiSaveState::input(InputConfig* config, Input input)
 					toDelete.remove();
 
 					SaveStateRepository::renumberSlots(mGame);
-					mRepository->refresh();
+					mRepository->refresh(mGame);
 
 					loadGrid();
 				}, 
@@ -250,7 +250,7 @@ bool GuiSaveState::input(InputConfig* config, Input input)
 				const SaveState& toCopy = mGrid->getSelected();
 				if (toCopy.copyToSlot(slot))
 				{
-					mRepository->refresh();
+					mRepository->refresh(mGame);
 					loadGrid();
 				}
 			}
@@ -4,6 +4,7 @@
 #include "components/OptionListComponent.h"
 #include "guis/GuiMsgBox.h"
 #include "guis/GuiScraperStart.h"
+#include "scrapers/ScraperCache.h"
 #include "scrapers/ThreadedScraper.h"
 
 GuiScraperSettings::GuiScraperSettings(Window* window) : GuiSettings(window, _("SCRAPER SETTINGS").c_str())
@@ -159,4 +160,11 @@ GuiScraperSettings::GuiScraperSettings(Window* window) : GuiSettings(window, _("
 		addInputTextRow(_("USERNAME"), "ScreenScraperUser", false, true);
 		addInputTextRow(_("PASSWORD"), "ScreenScraperPass", true, true);
 	}
+
+	addGroup(_("CACHE"));
+	addSwitch(_("KEEP SCRAPER RESPONSES IN CACHE"), _("Scraping the same games again replays the responses instead of querying the server."), "ScraperCache", true, nullptr);
+	addEntry(_("CLEAR SCRAPER CACHE"), false, [this]
+	{
+		mWindow->pushGui(new GuiMsgBox(mWindow, _("ARE YOU SURE?"), _("YES"), [] { ScraperCache::getInstance()->clear(); }, _("NO"), nullptr));
+	});
 }
\ No newline at end of file
@@ -38,6 +38,7 @@
 #include "TextToSpeech.h"
 #include "Paths.h"
 #include "resources/TextureData.h"
+#include "resources/ResourceManager.h"
 
 #ifdef WIN32
 #include <Windows.h>
@@ -223,6 +224,20 @@ bool parseArgs(int argc, char* argv[])
 		{
 			Settings::getInstance()->setBool("ForceDisableFilters", true);
 		}
+		else if (strcmp(argv[i], "--create-resource-pack") == 0)
+		{
+			std::string folder = Paths::getEmulationStationPath() + "/resources";
+			std::string packPath = Paths::getEmulationStationPath() + "/resources.pack";
+			if (i + 1 < argc && argv[i + 1][0] != '-')
+				packPath = argv[i + 1];
+
+			if (ResourceManager::createResourcePack(folder, packPath))
+				std::cout << "Resource pack created : " << packPath << "\n";
+			else
+				std::cerr << "Unable to create the resource pack " << packPath << "\n";
+
+			return false;
+		}
 		else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0)
 		{
 #ifdef WIN32
@@ -251,6 +266,7 @@ bool parseArgs(int argc, char* argv[])
 				"--force-kid		Force the UI mode to be Kid\n"
 				"--force-kiosk		Force the UI mode to be Kiosk\n"
 				"--force-disable-filters		Force the UI to ignore applied filters in gamelist\n"
+				"--create-resource-pack [path]	Pack the bundled resources into resources.pack (or [path]) and exit\n"
 				"--home [path]		Directory to use as home path\n"
 #ifdef _ENABLEEMUELEC
 				"--log-path [path]		Directory to use for log\n"
@@ -352,6 +368,11 @@ void signalHandler(int signum)
 	else
 		LOG(LogError) << "Interrupt signal (" << signum << ") received.\n";
 
+	// Write the queued lines without waiting for the log writer, which may be the thread that crashed.
+	// Other signals ( SIGINT ) interrupt a healthy process : exit() closes the log normally from onExit
+	if (signum == SIGSEGV || signum == SIGFPE || signum == SIGILL || signum == SIGABRT)
+		Log::close(true);
+
 	// cleanup and close up stuff here  
 	exit(signum);
 }
@@ -727,8 +748,6 @@ int main(int argc, char* argv[])
 #endif
 
 		Renderer::swapBuffers();
-
-		Log::flush();
 	}
 
 	if (isFastShutdown())
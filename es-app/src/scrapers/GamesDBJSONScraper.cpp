@@ -542,13 +542,10 @@ namespace
 } // namespace
 
   // Process should return false only when we reached a maximum scrap by minute, to retry
-bool TheGamesDBJSONRequest::process(HttpReq* request, std::vector<ScraperSearchResult>& results)
+bool TheGamesDBJSONRequest::process(const std::string& content, std::vector<ScraperSearchResult>& results)
 {
-	if (request->status() != HttpReq::REQ_SUCCESS)
-		return false;
-
 	Document doc;
-	doc.Parse(request->getContent().c_str());
+	doc.Parse(content.c_str());
 
 	if (doc.HasParseError())
 	{
@@ -512,12 +512,10 @@ static void processGame(const Value& game, std::vector<ScraperSearchResult>& res
 } // namespace
 
   // Process should return false only when we reached a maximum scrap by minute, to retry
-bool HfsDBRequest::process(HttpReq* request, std::vector<ScraperSearchResult>& results)
+bool HfsDBRequest::process(const std::string& content, std::vector<ScraperSearchResult>& results)
 {
-	assert(request->status() == HttpReq::REQ_SUCCESS);
-
 	Document doc;
-	doc.Parse(request->getContent().c_str());
+	doc.Parse(content.c_str());
 
 	if (doc.HasParseError())
 	{
@@ -11,9 +11,12 @@
 #include <fstream>
 #include "utils/FileSystemUtil.h"
 #include "utils/StringUtil.h"
+#include "math/Misc.h"
 #include <thread>
+#include <condition_variable>
 #include <SDL_timer.h>
 #include "HfsDBScraper.h"
+#include "ScraperCache.h"
 
 #define OVERQUOTA_RETRY_DELAY 15000
 #define OVERQUOTA_RETRY_COUNT 5
@@ -187,6 +190,10 @@ bool Scraper::isMediaSupported(const Scraper::ScraperMediaSource& md)
 std::unique_ptr<ScraperSearchHandle> Scraper::search(const ScraperSearchParams& params)
 {
 	std::unique_ptr<ScraperSearchHandle> handle(new ScraperSearchHandle());
+	handle->mScraperName = getScraperName(this);
+	if (params.system != nullptr)
+		handle->mSystemName = params.system->getName();
+
 	generateRequests(params, handle->mRequestQueue, handle->mResults);
 	return handle;
 }
@@ -216,6 +223,8 @@ void ScraperSearchHandle::update()
 		// a request can add more requests to the queue while running,
 		// so be careful with references into the queue
 		auto& req = *(mRequestQueue.front());
+		req.setCacheContext(mScraperName, mSystemName);
+
 		AsyncHandleStatus status = req.status();
 
 		if(status == ASYNC_ERROR)
@@ -261,7 +270,9 @@ ScraperHttpRequest::ScraperHttpRequest(std::vector<ScraperSearchResult>& results
 	if (options != nullptr)
 		mOptions = *options;
 
-	mRequest = new HttpReq(url, &mOptions);
+	// The HttpReq is created on first update, once the cache has been checked
+	mRequest = nullptr;
+	mUrl = url;
 	mRetryCount = 0;
 	mOverQuotaPendingTime = 0;
 }
@@ -273,6 +284,22 @@ ScraperHttpRequest::~ScraperHttpRequest()
 
 void ScraperHttpRequest::update()
 {
+	if (mRequest == nullptr)
+	{
+		if (mStatus != ASYNC_IN_PROGRESS)
+			return;
+
+		std::string content;
+		if (!mCacheScraper.empty() && ScraperCache::getInstance()->getResponse(mCacheScraper, mCacheSystem, mUrl, mOptions.dataToPost, content))
+		{
+			setStatus(ASYNC_DONE); // if process() has an error, status will be changed to ASYNC_ERROR
+			process(content, mResults);
+			return;
+		}
+
+		mRequest = new HttpReq(mUrl, &mOptions);
+	}
+
 	if (mOverQuotaPendingTime > 0)
 	{
 		int lastTime = SDL_GetTicks();
@@ -298,8 +325,12 @@ void ScraperHttpRequest::update()
 
 	if(status == HttpReq::REQ_SUCCESS)
 	{
+		std::string content = mRequest->getContent();
+
 		setStatus(ASYNC_DONE); // if process() has an error, status will be changed to ASYNC_ERROR
-		process(mRequest, mResults);
+		if (process(content, mResults) && mStatus == ASYNC_DONE && !mCacheScraper.empty())
+			ScraperCache::getInstance()->putResponse(mCacheScraper, mCacheSystem, mUrl, mOptions.dataToPost, content);
+
 		return;
 	}
 
@@ -479,6 +510,18 @@ ImageDownloadHandle::ImageDownloadHandle(const std::string& url, const std::stri
 {
 	mRetryCount = 0;
 	mOverQuotaPendingTime = 0;
+	mRequest = nullptr;
+
+	// Resized medias are cached with their target size
+	mCacheKey = url + "#" + std::to_string(maxWidth) + "x" + std::to_string(maxHeight);
+
+	auto cachedPath = ScraperCache::getInstance()->getMedia(mCacheKey, path);
+	if (!cachedPath.empty())
+	{
+		mSavePath = cachedPath;
+		setStatus(ASYNC_DONE);
+		return;
+	}
 
 	if (url.find("screenscraper") != std::string::npos && (path.find(".jpg") != std::string::npos || path.find(".png") != std::string::npos) && url.find("media=map") == std::string::npos)
 	{
@@ -502,7 +545,7 @@ ImageDownloadHandle::~ImageDownloadHandle()
 
 int ImageDownloadHandle::getPercent()
 {
-	if (mRequest->status() == HttpReq::REQ_IN_PROGRESS)
+	if (mRequest != nullptr && mRequest->status() == HttpReq::REQ_IN_PROGRESS)
 		return mRequest->getPercent();
 
 	return -1;
@@ -510,6 +553,21 @@ int ImageDownloadHandle::getPercent()
 
 void ImageDownloadHandle::update()
 {
+	if (mRequest == nullptr)
+		return;
+
+	if (mPendingResize != nullptr)
+	{
+		if (!mPendingResize->load())
+			return;
+
+		mPendingResize = nullptr;
+
+		ScraperCache::getInstance()->putMedia(mCacheKey, mSavePath);
+		setStatus(ASYNC_DONE);
+		return;
+	}
+
 	if (mOverQuotaPendingTime > 0)
 	{
 		int lastTime = SDL_GetTicks();
@@ -599,12 +657,14 @@ void ImageDownloadHandle::update()
 			}
 		}
 
-		// It's an image ?
-		if (mSavePath.find("-fanart") == std::string::npos && mSavePath.find("-bezel") == std::string::npos && mSavePath.find("-map") == std::string::npos && (ext == ".jpg" || ext == ".jpeg" || ext == ".png" || ext == ".bmp" || ext == ".gif"))
+		// It's an image ? Resize it on the worker pool, so the thread polling the downloads is not blocked
+		if ((mMaxWidth > 0 || mMaxHeight > 0) && mSavePath.find("-fanart") == std::string::npos && mSavePath.find("-bezel") == std::string::npos && mSavePath.find("-map") == std::string::npos && (ext == ".jpg" || ext == ".jpeg" || ext == ".png" || ext == ".bmp" || ext == ".gif"))
 		{
-			try { resizeImage(mSavePath, mMaxWidth, mMaxHeight); }
-			catch(...) { }
+			mPendingResize = resizeImageAsync(mSavePath, mMaxWidth, mMaxHeight);
+			return;
 		}
+
+		ScraperCache::getInstance()->putMedia(mCacheKey, mSavePath);
 	}
 
 	setStatus(ASYNC_DONE);
@@ -630,15 +690,51 @@ bool resizeImage(const std::string& path, int maxWidth, int maxHeight)
 		return false;
 	}
 
-	//make sure we can read this filetype first, then load it
-	if(FreeImage_FIFSupportsReading(format))
+	//make sure we can read this filetype first
+	if(!FreeImage_FIFSupportsReading(format))
 	{
-		image = FreeImage_Load(format, path.c_str());
-	}else{
 		LOG(LogError) << "Error - file format reading not supported for image \"" << path << "\"!";
 		return false;
 	}
 
+	int loadFlags = 0;
+
+#ifdef FIF_LOAD_NOPIXELS
+	// Read the header only : most images don't need resizing, and this gives the size needed to scale JPEGs at decode time
+	image = FreeImage_Load(format, path.c_str(), FIF_LOAD_NOPIXELS);
+	if (image != NULL)
+	{
+		float headerWidth = (float)FreeImage_GetWidth(image);
+		float headerHeight = (float)FreeImage_GetHeight(image);
+		FreeImage_Unload(image);
+
+		if (headerWidth == 0 || headerHeight == 0)
+			return true;
+
+		int targetWidth = maxWidth == 0 ? (int)((maxHeight / headerHeight) * headerWidth) : maxWidth;
+		int targetHeight = maxHeight == 0 ? (int)((maxWidth / headerWidth) * headerHeight) : maxHeight;
+
+		if (headerWidth <= targetWidth && headerHeight <= targetHeight)
+			return true;
+
+		// Let libjpeg do DCT scaling (1/2, 1/4, 1/8) : the decoded image has its largest side >= the requested size (upper 16 bits of the flags)
+		if (format == FIF_JPEG)
+		{
+			float ratio = Math::max(targetWidth / headerWidth, targetHeight / headerHeight);
+			int requestedSize = (int)Math::ceilf(Math::max(headerWidth, headerHeight) * ratio);
+			if (requestedSize > 0 && requestedSize < 0xFFFF)
+				loadFlags = requestedSize << 16;
+		}
+	}
+#endif
+
+	image = FreeImage_Load(format, path.c_str(), loadFlags);
+	if (image == NULL)
+	{
+		LOG(LogError) << "Error - could not load image \"" << path << "\"!";
+		return false;
+	}
+
 	float width = (float)FreeImage_GetWidth(image);
 	float height = (float)FreeImage_GetHeight(image);
 
@@ -653,7 +749,7 @@ bool resizeImage(const std::string& path, int maxWidth, int maxHeight)
 	else if(maxHeight == 0)
 		maxHeight = (int)((maxWidth / width) * height);
 	
-	if (width <= maxWidth && height <= maxHeight)
+	if (width <= maxWidth && height <= maxHeight && loadFlags == 0)
 	{
 		FreeImage_Unload(image);
 		return true;
@@ -684,6 +780,102 @@ bool resizeImage(const std::string& path, int maxWidth, int maxHeight)
 	return saved;
 }
 
+// Worker threads resizing the downloaded images. Idle threads wait on the condition variable.
+class ImageResizePool
+{
+public:
+	static ImageResizePool* getInstance()
+	{
+		static ImageResizePool instance;
+		return &instance;
+	}
+
+	ImageResizePool() : mExit(false) { }
+
+	// The workers must be gone before the mutex & condition variable are destroyed
+	~ImageResizePool()
+	{
+		{
+			std::unique_lock<std::mutex> lock(mLock);
+			mExit = true;
+		}
+
+		mEvent.notify_all();
+
+		for (auto& thread : mThreads)
+			if (thread.joinable())
+				thread.join();
+	}
+
+	std::shared_ptr<std::atomic<bool>> queue(const std::string& path, int maxWidth, int maxHeight)
+	{
+		ResizeJob job;
+		job.path = path;
+		job.maxWidth = maxWidth;
+		job.maxHeight = maxHeight;
+		job.done = std::make_shared<std::atomic<bool>>(false);
+
+		std::unique_lock<std::mutex> lock(mLock);
+
+		if (mThreads.size() == 0)
+		{
+			int threadCount = Math::min(Math::max((int)std::thread::hardware_concurrency(), 1), 4);
+			for (int i = 0; i < threadCount; i++)
+			{
+				mThreads.push_back(std::thread(&ImageResizePool::run, this));
+			}
+		}
+
+		mJobs.push(job);
+		mEvent.notify_one();
+
+		return job.done;
+	}
+
+private:
+	struct ResizeJob
+	{
+		std::string path;
+		int maxWidth;
+		int maxHeight;
+		std::shared_ptr<std::atomic<bool>> done;
+	};
+
+	void run()
+	{
+		while (true)
+		{
+			ResizeJob job;
+
+			{
+				std::unique_lock<std::mutex> lock(mLock);
+				mEvent.wait(lock, [this] { return mExit || !mJobs.empty(); });
+				if (mExit)
+					return;
+
+				job = mJobs.front();
+				mJobs.pop();
+			}
+
+			try { resizeImage(job.path, job.maxWidth, job.maxHeight); }
+			catch (...) {}
+
+			job.done->store(true);
+		}
+	}
+
+	std::mutex mLock;
+	std::condition_variable mEvent;
+	std::queue<ResizeJob> mJobs;
+	std::vector<std::thread> mThreads;
+	bool mExit;
+};
+
+std::shared_ptr<std::atomic<bool>> resizeImageAsync(const std::string& path, int maxWidth, int maxHeight)
+{
+	return ImageResizePool::getInstance()->queue(path, maxWidth, maxHeight);
+}
+
 std::string Scraper::getSaveAsPath(FileData* game, const MetaDataId metadataId, const std::string& extension)
 {
 	std::string suffix = "image";
@@ -10,6 +10,7 @@
 #include <queue>
 #include <utility>
 #include <set>
+#include <atomic>
 #include <assert.h>
 #include "FileData.h"
 
@@ -76,9 +77,15 @@ public:
 
 	// returns "true" once we're done
 	virtual void update() = 0;
+
+	// scraper & system names, used to store responses in the ScraperCache
+	void setCacheContext(const std::string& scraper, const std::string& system) { mCacheScraper = scraper; mCacheSystem = system; }
 	
 protected:
 	std::vector<ScraperSearchResult>& mResults;
+
+	std::string mCacheScraper;
+	std::string mCacheSystem;
 };
 
 // a single HTTP request that needs to be processed to get the results
@@ -91,11 +98,12 @@ public:
 	virtual void update() override;
 
 protected:
-	virtual bool process(HttpReq* request, std::vector<ScraperSearchResult>& results) = 0;
+	virtual bool process(const std::string& content, std::vector<ScraperSearchResult>& results) = 0;
 
 private:
 	HttpReq* mRequest;
 	HttpReqOptions mOptions;
+	std::string mUrl;
 	int	mRetryCount;
 
 	int mOverQuotaPendingTime;
@@ -115,6 +123,9 @@ public:
 protected:
 	std::queue< std::unique_ptr<ScraperRequest> > mRequestQueue;
 	std::vector<ScraperSearchResult> mResults;
+
+	std::string mScraperName;
+	std::string mSystemName;
 };
 
 typedef void (*generate_scraper_requests_func)(const ScraperSearchParams& params, std::queue< std::unique_ptr<ScraperRequest> >& requests, std::vector<ScraperSearchResult>& results);
@@ -137,7 +148,9 @@ private:
 	int	mRetryCount;
 	int mOverQuotaPendingTime;
 
+	std::string mCacheKey;
 	std::string mSavePath;
+	std::shared_ptr<std::atomic<bool>> mPendingResize;
 	int mMaxWidth;
 	int mMaxHeight;
 };
@@ -266,4 +279,8 @@ protected:
 //Returns true if successful, false otherwise.
 bool resizeImage(const std::string& path, int maxWidth, int maxHeight);
 
+//Same as resizeImage, processed by a pool of worker threads.
+//The returned flag is set once the image has been processed.
+std::shared_ptr<std::atomic<bool>> resizeImageAsync(const std::string& path, int maxWidth, int maxHeight);
+
 #endif // ES_APP_SCRAPERS_SCRAPER_H
@@ -0,0 +1,257 @@
+#include "scrapers/ScraperCache.h"
+
+#include "utils/FileSystemUtil.h"
+#include "utils/StringUtil.h"
+#include "utils/TimeUtil.h"
+#include "utils/md5.h"
+#include "Settings.h"
+#include "Paths.h"
+#include "Log.h"
+#include <algorithm>
+#include <vector>
+
+#define CACHE_PRUNE_RATIO 0.8
+
+// Query parameters that carry credentials : they must not be part of the cache key
+static const std::vector<std::string> volatileParameters = { "devid", "devpassword", "softname", "ssid", "sspassword", "apikey" };
+
+ScraperCache* ScraperCache::getInstance()
+{
+	// Scraper threads may ask for it concurrently : the initialization of a local static is thread safe
+	static ScraperCache instance;
+	return &instance;
+}
+
+ScraperCache::ScraperCache()
+{
+	mTotalSize = 0;
+	mTotalSizeComputed = false;
+}
+
+bool ScraperCache::isEnabled()
+{
+	return Settings::getInstance()->getBool("ScraperCache");
+}
+
+std::string ScraperCache::getRootPath()
+{
+	return Paths::getUserEmulationStationPath() + "/cache/scraper";
+}
+
+std::string ScraperCache::getKey(const std::string& url, const std::string& postData)
+{
+	std::string key = url;
+
+	auto query = url.find('?');
+	if (query != std::string::npos)
+	{
+		std::vector<std::string> kept;
+
+		for (auto param : Utils::String::split(url.substr(query + 1), '&', true))
+		{
+			auto name = Utils::String::toLower(param.substr(0, param.find('=')));
+			if (std::find(volatileParameters.cbegin(), volatileParameters.cend(), name) == volatileParameters.cend())
+				kept.push_back(param);
+		}
+
+		key = url.substr(0, query) + "?" + Utils::String::join(kept, "&");
+	}
+
+	if (!postData.empty())
+		key += "|" + postData;
+
+	return md5(key);
+}
+
+std::string ScraperCache::getResponsePath(const std::string& scraper, const std::string& system, const std::string& key)
+{
+	return getRootPath() + "/" + scraper + "/" + system + "/" + key + ".txt";
+}
+
+std::string ScraperCache::getMediaFolder(const std::string& key)
+{
+	return getRootPath() + "/medias/" + key.substr(0, 2);
+}
+
+bool ScraperCache::isExpired(const std::string& path)
+{
+	int ttl = Settings::getInstance()->getInt("ScraperCacheTTL");
+	if (ttl <= 0)
+		return false;
+
+	time_t modified = Utils::FileSystem::getFileModificationDate(path).getTime();
+	return Utils::Time::now() - modified > (time_t)ttl * 86400;
+}
+
+bool ScraperCache::getResponse(const std::string& scraper, const std::string& system, const std::string& url, const std::string& postData, std::string& content)
+{
+	if (!isEnabled())
+		return false;
+
+	auto path = getResponsePath(scraper, system, getKey(url, postData));
+	if (!Utils::FileSystem::exists(path) || isExpired(path))
+		return false;
+
+	content = Utils::FileSystem::readAllText(path);
+	if (content.empty())
+		return false;
+
+	LOG(LogDebug) << "ScraperCache : Replaying " << url << " from " << path;
+	return true;
+}
+
+void ScraperCache::putResponse(const std::string& scraper, const std::string& system, const std::string& url, const std::string& postData, const std::string& content)
+{
+	if (!isEnabled() || content.empty())
+		return;
+
+	auto path = getResponsePath(scraper, system, getKey(url, postData));
+
+	auto folder = Utils::FileSystem::getParent(path);
+	if (!Utils::FileSystem::exists(folder))
+		Utils::FileSystem::createDirectory(folder);
+
+	Utils::FileSystem::writeAllText(path, content);
+	addSize(content.size());
+}
+
+std::string ScraperCache::getMedia(const std::string& url, const std::string& savePath)
+{
+	if (!isEnabled())
+		return "";
+
+	auto key = getKey(url);
+	auto folder = getMediaFolder(key);
+	if (!Utils::FileSystem::exists(folder))
+		return "";
+
+	// The extension of the cached file is the one that was fixed using the response 'content-type'
+	for (auto file : Utils::FileSystem::getDirContent(folder))
+	{
+		if (!Utils::String::startsWith(Utils::FileSystem::getFileName(file), key))
+			continue;
+
+		if (isExpired(file))
+			return "";
+
+		auto target = Utils::FileSystem::changeExtension(savePath, Utils::FileSystem::getExtension(file));
+		if (!Utils::FileSystem::copyFile(file, target))
+			return "";
+
+		LOG(LogDebug) << "ScraperCache : Restoring " << url << " from " << file;
+		return target;
+	}
+
+	return "";
+}
+
+void ScraperCache::putMedia(const std::string& url, const std::string& path)
+{
+	if (!isEnabled())
+		return;
+
+	auto size = Utils::FileSystem::getFileSize(path);
+	if (size == 0)
+		return;
+
+	auto key = getKey(url);
+	auto folder = getMediaFolder(key);
+	if (!Utils::FileSystem::exists(folder))
+		Utils::FileSystem::createDirectory(folder);
+
+	if (Utils::FileSystem::copyFile(path, folder + "/" + key + Utils::FileSystem::getExtension(path)))
+		addSize(size);
+}
+
+void ScraperCache::addSize(unsigned long long size)
+{
+	unsigned long long maxSize = (unsigned long long) Settings::getInstance()->getInt("ScraperCacheMaxSize") * 1024 * 1024;
+
+	std::unique_lock<std::mutex> lock(mLock);
+
+	// The first put computes the size from the files, including the new one, and enforces the limit
+	if (!mTotalSizeComputed)
+	{
+		pruneLocked();
+		return;
+	}
+
+	mTotalSize += size;
+	if (maxSize > 0 && mTotalSize > maxSize)
+		pruneLocked();
+}
+
+void ScraperCache::prune()
+{
+	std::unique_lock<std::mutex> lock(mLock);
+	pruneLocked();
+}
+
+// mLock must be held
+void ScraperCache::pruneLocked()
+{
+	struct CacheEntry
+	{
+		std::string path;
+		time_t modified;
+		unsigned long long size;
+	};
+
+	std::vector<CacheEntry> entries;
+	unsigned long long totalSize = 0;
+
+	auto root = getRootPath();
+	if (Utils::FileSystem::exists(root))
+	{
+		for (auto file : Utils::FileSystem::getDirContent(root, true))
+		{
+			if (Utils::FileSystem::isDirectory(file))
+				continue;
+
+			if (isExpired(file))
+			{
+				Utils::FileSystem::removeFile(file);
+				continue;
+			}
+
+			CacheEntry entry;
+			entry.path = file;
+			entry.modified = Utils::FileSystem::getFileModificationDate(file).getTime();
+			entry.size = Utils::FileSystem::getFileSize(file);
+			entries.push_back(entry);
+
+			totalSize += entry.size;
+		}
+	}
+
+	unsigned long long maxSize = (unsigned long long) Settings::getInstance()->getInt("ScraperCacheMaxSize") * 1024 * 1024;
+	if (maxSize > 0 && totalSize > maxSize)
+	{
+		// Remove the oldest entries, leaving some room so we don't prune again on the next put
+		std::sort(entries.begin(), entries.end(), [](const CacheEntry& a, const CacheEntry& b) { return a.modified < b.modified; });
+
+		for (auto entry : entries)
+		{
+			if (totalSize <= maxSize * CACHE_PRUNE_RATIO)
+				break;
+
+			if (Utils::FileSystem::removeFile(entry.path))
+				totalSize -= entry.size;
+		}
+
+		LOG(LogInfo) << "ScraperCache : Pruned to " << Utils::FileSystem::megaBytesToString(totalSize / 1024 / 1024);
+	}
+
+	mTotalSize = totalSize;
+	mTotalSizeComputed = true;
+}
+
+void ScraperCache::clear()
+{
+	std::unique_lock<std::mutex> lock(mLock);
+
+	Utils::FileSystem::deleteDirectoryFiles(getRootPath(), true);
+
+	mTotalSize = 0;
+	mTotalSizeComputed = true;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#ifndef ES_APP_SCRAPERS_SCRAPER_CACHE_H
+#define ES_APP_SCRAPERS_SCRAPER_CACHE_H
+
+#include <string>
+#include <mutex>
+
+// On-disk cache of scraper responses & downloaded medias, so that a scrape can be replayed without querying the servers again.
+//
+// Layout ( under ~/.emulationstation/cache/scraper ) :
+//   [scraper]/[system]/[key].txt	-> raw API responses. Key is a md5 of the request url & posted data, without credentials
+//   medias/[xx]/[key].[ext]		-> downloaded medias. Key is a md5 of the media url
+//
+// Entries older than "ScraperCacheTTL" days are ignored, and the oldest entries are removed when the total size exceeds "ScraperCacheMaxSize" Mb.
+class ScraperCache
+{
+public:
+	static ScraperCache* getInstance();
+
+	bool isEnabled();
+
+	bool getResponse(const std::string& scraper, const std::string& system, const std::string& url, const std::string& postData, std::string& content);
+	void putResponse(const std::string& scraper, const std::string& system, const std::string& url, const std::string& postData, const std::string& content);
+
+	// Copies the cached media to savePath, fixing the extension if required. Returns the final path, or an empty string if not in cache
+	std::string getMedia(const std::string& url, const std::string& savePath);
+	void putMedia(const std::string& url, const std::string& path);
+
+	void prune();
+	void clear();
+
+private:
+	ScraperCache();
+
+	static std::string getKey(const std::string& url, const std::string& postData = "");
+
+	std::string getRootPath();
+	std::string getResponsePath(const std::string& scraper, const std::string& system, const std::string& key);
+	std::string getMediaFolder(const std::string& key);
+
+	bool isExpired(const std::string& path);
+	void addSize(unsigned long long size);
+	void pruneLocked();
+
+	std::mutex mLock;
+	unsigned long long mTotalSize;
+	bool mTotalSizeComputed;
+};
+
+#endif // ES_APP_SCRAPERS_SCRAPER_CACHE_H
@@ -317,11 +317,8 @@ void ScreenScraperScraper::generateRequests(const ScraperSearchParams& params,
 }
 
 // Process should return false only when we reached a maximum scrap by minute, to retry
-bool ScreenScraperRequest::process(HttpReq* request, std::vector<ScraperSearchResult>& results)
+bool ScreenScraperRequest::process(const std::string& content, std::vector<ScraperSearchResult>& results)
 {
-	assert(request->status() == HttpReq::REQ_SUCCESS);
-
-	auto content = request->getContent();
 	if (content.empty())
 		return false;
 
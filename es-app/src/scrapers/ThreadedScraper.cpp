@@ -6,6 +6,7 @@
 #include "guis/GuiMsgBox.h"
 #include "Gamelist.h"
 #include "Log.h"
+#include "scrapers/ScraperCache.h"
 
 #define GUIICON _U("\uF03E ")
 
@@ -208,6 +209,10 @@ void ThreadedScraper::run()
 	if (mExitCode == ASYNC_DONE)
 		mWindow->displayNotificationMessage(GUIICON + _("SCRAPING FINISHED") + std::string(". ") + _("UPDATE GAMELISTS TO APPLY CHANGES."));
 
+	// Enforce cache TTL & size limits now that the cache has grown
+	if (ScraperCache::getInstance()->isEnabled())
+		ScraperCache::getInstance()->prune();
+
 	delete this;
 	ThreadedScraper::mInstance = nullptr;
 }
@@ -248,6 +253,7 @@ void ThreadedScraper::acceptResult(ScraperThread& thread)
 		game->getMetadata().importScrappedMetadata(result.mdl);
 		game->detectLanguageAndRegion(true);
 		game->getMetadata().setScrapeDate(result.scraper);
+		game->getSourceFileData()->getSystem()->updateIndex(game->getSourceFileData());
 
 		LOG(LogDebug) << "ThreadedScraper::saveToGamelistRecovery";
 		saveToGamelistRecovery(game);
@@ -4,113 +4,248 @@
 #include "utils/StringUtil.h"
 #include "LocaleES.h"
 #include <time.h>
+#include <memory>
+#include <unordered_map>
 
 #include "components/TextComponent.h"
 #include "components/ImageComponent.h"
 #include "components/VideoComponent.h"
 
-void Binding::updateBindings(TextComponent* comp, SystemData* system, bool showDefaultText)
-{
-	if (comp == nullptr || system == nullptr)
-		return;
+#define BINDING_TEMPLATE_CACHE_SIZE 1024
 
-	auto src = comp->getOriginalThemeText();
-	if (src.empty() || (src.find("{binding:") == std::string::npos && src.find("{system:") == std::string::npos))
-		return;
+// A themed text or path, split once into literal parts & field references.
+// Evaluating a template is a single pass that only queries the fields it references.
+class BindingTemplate
+{
+public:
+	enum TokenType
+	{
+		LITERAL,
+		GAME,
+		SYSTEM		// {system:xxx} or {binding:xxx}
+	};
 
-	auto valueOrUnknown = [](const std::string value) { return value.empty() ? _("Unknown") : value == "0" ? _("None") : value; };
+	struct Token
+	{
+		TokenType type;
+		std::string value;
+		std::string source;	// Original reference, kept when the field can't be resolved
+	};
 
-	for (auto name : Utils::String::extractStrings(src, "{binding:", "}"))
-	{		
-		auto val = system->getProperty(name);
-		if (showDefaultText)
-			val = valueOrUnknown(val);
+	BindingTemplate(const std::string& source)
+	{
+		hasGameFields = false;
+		hasSystemFields = false;
+
+		std::string literal;
+
+		size_t pos = 0;
+		while (pos < source.size())
+		{
+			auto start = source.find('{', pos);
+			if (start == std::string::npos)
+				break;
+
+			auto end = source.find('}', start + 1);
+			if (end == std::string::npos)
+				break;
+
+			TokenType type = LITERAL;
+			size_t nameStart = std::string::npos;
+
+			if (source.compare(start, 6, "{game:") == 0)
+			{
+				type = GAME;
+				nameStart = start + 6;
+			}
+			else if (source.compare(start, 8, "{system:") == 0)
+			{
+				type = SYSTEM;
+				nameStart = start + 8;
+			}
+			else if (source.compare(start, 9, "{binding:") == 0)
+			{
+				type = SYSTEM;
+				nameStart = start + 9;
+			}
+
+			if (type == LITERAL || nameStart >= end)
+			{
+				literal += source.substr(pos, start + 1 - pos);
+				pos = start + 1;
+				continue;
+			}
+
+			literal += source.substr(pos, start - pos);
+			if (!literal.empty())
+			{
+				tokens.push_back({ LITERAL, literal, "" });
+				literal.clear();
+			}
+
+			tokens.push_back({ type, source.substr(nameStart, end - nameStart), source.substr(start, end + 1 - start) });
+
+			if (type == GAME)
+				hasGameFields = true;
+			else
+				hasSystemFields = true;
+
+			pos = end + 1;
+		}
+
+		literal += source.substr(pos);
+		if (!literal.empty())
+			tokens.push_back({ LITERAL, literal, "" });
+	}
 
-		src = Utils::String::replace(src, "{binding:" + name+ "}", val);
+	std::string evaluate(FileData* file, SystemData* system, bool showDefaultText)
+	{
+		std::string ret;
+
+		for (auto& token : tokens)
+		{
+			if (token.type == LITERAL)
+			{
+				ret += token.value;
+				continue;
+			}
+
+			std::string value;
+
+			if (token.type == GAME && file != nullptr)
+				value = file->getProperty(token.value);
+			else if (token.type == SYSTEM && system != nullptr)
+				value = system->getProperty(token.value);
+			else
+			{
+				// Unsupported by the caller : keep the reference as is
+				ret += token.source;
+				continue;
+			}
+
+			if (showDefaultText)
+				value = value.empty() ? _("Unknown") : value == "0" ? _("None") : value;
+
+			ret += value;
+		}
+
+		return ret;
 	}
 
-	for (auto name : Utils::String::extractStrings(src, "{system:", "}", true))
+	// Templates are compiled the first time a theme value is bound, then shared by all the components using the same value
+	static std::shared_ptr<BindingTemplate> get(const std::string& source)
 	{
-		auto val = system->getProperty(name);
-		if (showDefaultText)
-			val = valueOrUnknown(val);
+		static std::unordered_map<std::string, std::shared_ptr<BindingTemplate>> templates;
+
+		auto it = templates.find(source);
+		if (it != templates.cend())
+			return it->second;
 
-		src = Utils::String::replace(src, "{system:" + name + "}", val);
+		if (templates.size() >= BINDING_TEMPLATE_CACHE_SIZE)
+			templates.clear();
+
+		auto ret = std::make_shared<BindingTemplate>(source);
+		templates[source] = ret;
+		return ret;
 	}
-		
-	comp->setText(src);
+
+	std::vector<Token> tokens;
+
+	bool hasGameFields;
+	bool hasSystemFields;
+};
+
+std::string Binding::evaluate(const std::string& source, FileData* file, SystemData* system, bool showDefaultText)
+{
+	if (source.find('{') == std::string::npos)
+		return source;
+
+	return BindingTemplate::get(source)->evaluate(file, system, showDefaultText);
 }
 
-static void _updateTextBindings(TextComponent* comp, FileData* file, bool showDefaultText)
+void Binding::updateBindings(TextComponent* comp, SystemData* system, bool showDefaultText)
 {
 	if (comp == nullptr || system == nullptr)
 		return;
 
 	auto src = comp->getOriginalThemeText();
-	if (src.empty() || src.find("{game:") == std::string::npos)
+	if (src.empty() || src.find('{') == std::string::npos)
 		return;
 
-	auto valueOrUnknown = [](const std::string value) { return value.empty() ? _("Unknown") : value == "0" ? _("None") : value; };
-
-	for (auto name : Utils::String::extractStrings(src, "{game:", "}"))
-	{
-		auto val = file->getProperty(name);
-		
-		if (showDefaultText)
-			val = valueOrUnknown(val);
+	auto bindings = BindingTemplate::get(src);
+	if (!bindings->hasSystemFields)
+		return;
 
-		src = Utils::String::replace(src, "{game:" + name + "}", val);
-	}
-	
-	comp->setText(src);
+	// setText does nothing if the text has not changed
+	comp->setText(bindings->evaluate(nullptr, system, showDefaultText));
 }
 
+static void _updateTextBindings(TextComponent* comp, FileData* file, bool showDefaultText)
+{
+	auto src = comp->getOriginalThemeText();
+	if (src.empty() || src.find('{') == std::string::npos)
+		return;
+
+	auto bindings = BindingTemplate::get(src);
+	if (!bindings->hasGameFields)
+		return;
+
+	comp->setText(bindings->evaluate(file, nullptr, showDefaultText));
+}
 
 static void _updateImageBindings(ImageComponent* comp, FileData* file)
 {
-	if (comp == nullptr || system == nullptr)
+	auto src = comp->getOriginalThemePath();
+	if (src.empty() || src.find('{') == std::string::npos)
 		return;
 
-	auto src = comp->getOriginalThemePath();
-	if (src.empty() || src.find("{game:") == std::string::npos)
+	auto bindings = BindingTemplate::get(src);
+	if (!bindings->hasGameFields)
 		return;
 
-	for (auto name : Utils::String::extractStrings(src, "{game:", "}"))
-		src = Utils::String::replace(src, "{game:" + name + "}", file->getProperty(name));
+	auto path = bindings->evaluate(file, nullptr, false);
 
-	comp->setImage(src);
+	// Avoid resolving the canonical path of an image that is already displayed
+	if (!path.empty() && path == comp->getImagePath())
+		return;
+
+	comp->setImage(path);
 }
 
 static void _updateVideoBindings(VideoComponent* comp, FileData* file)
 {
-	if (comp == nullptr || system == nullptr)
-		return;
-
 	auto src = comp->getOriginalThemePath();
-	if (src.empty() || src.find("{game:") == std::string::npos)
+	if (src.empty() || src.find('{') == std::string::npos)
 		return;
 
-	for (auto name : Utils::String::extractStrings(src, "{game:", "}"))
-		src = Utils::String::replace(src, "{game:" + name + "}", file->getProperty(name));
+	auto bindings = BindingTemplate::get(src);
+	if (!bindings->hasGameFields)
+		return;
 
-	comp->setVideo(src);
+	// setVideo does nothing if the path has not changed
+	comp->setVideo(bindings->evaluate(file, nullptr, false));
 }
 
 void Binding::updateBindings(GuiComponent* comp, FileData* file, bool showDefaultText)
 {
-	if (comp == nullptr || system == nullptr)
+	if (comp == nullptr || file == nullptr)
 		return;
 
 	TextComponent* text = dynamic_cast<TextComponent*>(comp);
 	if (text != nullptr)
+	{
 		_updateTextBindings(text, file, showDefaultText);
+		return;
+	}
 
 	ImageComponent* image = dynamic_cast<ImageComponent*>(comp);
 	if (image != nullptr)
+	{
 		_updateImageBindings(image, file);
+		return;
+	}
 
 	VideoComponent* video = dynamic_cast<VideoComponent*>(comp);
 	if (video != nullptr)
 		_updateVideoBindings(video, file);
-
-}
\ No newline at end of file
+}
@@ -2,6 +2,8 @@
 #ifndef ES_APP_BINDING_H
 #define ES_APP_BINDING_H
 
+#include <string>
+
 class SystemData;
 class FileData;
 class TextComponent;
@@ -14,6 +16,9 @@ class Binding
 public:
 	static void updateBindings(TextComponent* comp, SystemData* system, bool showDefaultText = true);	
 	static void updateBindings(GuiComponent* comp, FileData* file, bool showDefaultText = true);
+
+	// Replaces the {game:}, {system:} & {binding:} references of a themed value. References to a null file or system are kept as is
+	static std::string evaluate(const std::string& source, FileData* file, SystemData* system, bool showDefaultText = true);
 };
 
 #endif
@@ -430,6 +430,11 @@ void ViewController::onFileChanged(FileData* file, FileChangeType change)
 	std::string key = file->getFullPath();
 	auto sourceSystem = file->getSourceFileData()->getSystem();
 
+	if (change == FILE_METADATA_CHANGED && file->getType() == GAME)
+	{
+		sourceSystem->updateIndex(file->getSourceFileData());
+	}
+
 	auto it = mGameListViews.find(sourceSystem);
 	if (it != mGameListViews.cend())
 		it->second->onFileChanged(file, change);
@@ -699,6 +699,33 @@ void DetailedContainer::loadThemedExtras(FileData* file)
 		resetThemedExtras();
 }
 
+void DetailedContainer::prewarmNeighbourVideos(int moveBy)
+{
+	auto entries = mParent->getFileDataEntries();
+
+	int cursor = mParent->getCursorIndex();
+	if (cursor < 0 || cursor >= (int)entries.size())
+		return;
+
+	// The entry in the direction of the move is the most likely to be displayed next
+	int direction = moveBy < 0 ? -1 : 1;
+
+	std::vector<std::string> paths;
+
+	for (int offset : { direction, -direction })
+	{
+		int index = cursor + offset;
+		if (index < 0 || index >= (int)entries.size() || entries[index]->getType() != GAME)
+			continue;
+
+		auto path = entries[index]->getVideoPath();
+		if (!path.empty())
+			paths.push_back(path);
+	}
+
+	mVideo->prewarmVideos(paths);
+}
+
 void DetailedContainer::updateControls(FileData* file, bool isClearing, int moveBy, bool isDeactivating)
 {
 	bool state = (file != NULL);
@@ -720,6 +747,9 @@ void DetailedContainer::updateControls(FileData* file, bool isClearing, int move
 			if (!mVideo->setVideo(file->getVideoPath()))
 				mVideo->setDefaultVideo();
 
+			if (!isClearing && !isDeactivating)
+				prewarmNeighbourVideos(moveBy);
+
 			std::string snapShot = imagePath;
 
 			auto src = mVideo->getSnapshotSource();
@@ -68,6 +68,7 @@ protected:
 	bool isChild(GuiComponent* cmp) { return mParent->isChild(cmp); }
 
 	void updateDetailsForFolder(FolderData* folder);
+	void prewarmNeighbourVideos(int moveBy);
 	void updateFolderViewAmbiantProperties();
 
 	void disableComponent(GuiComponent* comp);
@@ -0,0 +1,121 @@
+#include "Test.h"
+#include "TestSystem.h"
+
+#include "utils/FileSystemUtil.h"
+#include "utils/StringUtil.h"
+#include "views/Binding.h"
+#include "FileData.h"
+#include "LocaleES.h"
+#include "SystemData.h"
+#include <chrono>
+#include <iostream>
+
+// The replacement the compiled templates took over : one search & replace per referenced field
+static std::string referenceEvaluate(std::string src, FileData* file, SystemData* system, bool showDefaultText)
+{
+	auto valueOrUnknown = [](const std::string value) { return value.empty() ? _("Unknown") : value == "0" ? _("None") : value; };
+
+	for (auto prefix : { "{game:", "{system:", "{binding:" })
+	{
+		for (auto name : Utils::String::extractStrings(src, prefix, "}"))
+		{
+			auto val = std::string(prefix) == "{game:" ? file->getProperty(name) : system->getProperty(name);
+			if (showDefaultText)
+				val = valueOrUnknown(val);
+
+			src = Utils::String::replace(src, prefix + name + "}", val);
+		}
+	}
+
+	return src;
+}
+
+static const char* sTemplates[] = {
+	"",
+	"no binding",
+	"{game:name}",
+	"./images/{game:rom}.png",
+	"{game:name} ({game:releasedate}) - {game:developer} / {game:name}",
+	"Players : {game:players}, rating {game:rating}, played {game:playcount}",
+	"{game:favorite}{game:hidden}{game:gameTime}",
+	"{system:fullName} - {binding:name} : {game:name}",
+	"{system:name}{binding:fullName}",
+	"{{game:name}} { } {unknown:name} {game:}" };
+
+static FileData* findGame(SystemData* system, const std::string& fileName)
+{
+	for (auto game : system->getRootFolder()->getFilesRecursive(GAME))
+		if (Utils::FileSystem::getFileName(game->getPath()) == fileName)
+			return game;
+
+	Test::fail(__FILE__, __LINE__, fileName + " not found");
+}
+
+TEST(Binding_evaluateMatchesReplace)
+{
+	std::string root = Test::getTempPath();
+	Test::createFiles(root, { "roms/Sonic.zip", "roms/Tetris.zip" });
+
+	SystemData* system = Test::createSystem("test", root + "/roms", { ".zip" });
+
+	FileData* sonic = findGame(system, "Sonic.zip");
+	sonic->setMetadata(MetaDataId::Name, "Sonic the Hedgehog");
+	sonic->setMetadata(MetaDataId::Developer, "Sega");
+	sonic->setMetadata(MetaDataId::Players, "1");
+	sonic->setMetadata(MetaDataId::PlayCount, "0");
+
+	// Tetris has no metadata : the default texts are used
+	FileData* tetris = findGame(system, "Tetris.zip");
+
+	for (auto game : { sonic, tetris })
+	{
+		for (auto src : sTemplates)
+		{
+			for (bool showDefaultText : { true, false })
+			{
+				// Twice : the second evaluation uses the cached template
+				CHECK_EQUAL(referenceEvaluate(src, game, system, showDefaultText), Binding::evaluate(src, game, system, showDefaultText));
+				CHECK_EQUAL(referenceEvaluate(src, game, system, showDefaultText), Binding::evaluate(src, game, system, showDefaultText));
+			}
+		}
+	}
+
+	CHECK_EQUAL(std::string("{Sonic the Hedgehog} { } {unknown:name} {game:}"), Binding::evaluate("{{game:name}} { } {unknown:name} {game:}", sonic, system));
+
+	// Without a system, its references are left for the system view to resolve
+	CHECK_EQUAL(std::string("Sega {system:name}"), Binding::evaluate("{game:developer} {system:name}", sonic, nullptr));
+	CHECK_EQUAL(std::string("{game:name} test"), Binding::evaluate("{game:name} {binding:name}", nullptr, system));
+
+	delete system;
+}
+
+BENCHMARK(Binding_gameTexts)
+{
+	const int count = 200000;
+
+	std::string root = Test::getTempPath();
+	Test::createFiles(root, { "roms/Sonic.zip" });
+
+	SystemData* system = Test::createSystem("test", root + "/roms", { ".zip" });
+	FileData* game = findGame(system, "Sonic.zip");
+	game->setMetadata(MetaDataId::Developer, "Sega");
+
+	const std::string src = "{game:name} ({game:releasedate}) - {game:developer}";
+
+	size_t length = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < count; i++)
+		length += referenceEvaluate(src, game, system, true).size();
+
+	auto replaced = std::chrono::steady_clock::now();
+	for (int i = 0; i < count; i++)
+		length += Binding::evaluate(src, game, system, true).size();
+
+	auto compiled = std::chrono::steady_clock::now();
+
+	std::cout << "  " << count << " evaluations of \"" << src << "\" : search & replace " << std::chrono::duration<double, std::milli>(replaced - start).count()
+		<< " ms, compiled template " << std::chrono::duration<double, std::milli>(compiled - replaced).count() << " ms (" << length << " chars)" << std::endl;
+
+	delete system;
+}
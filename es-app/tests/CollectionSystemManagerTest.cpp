@@ -0,0 +1,161 @@
+#include "Test.h"
+#include "TestSystem.h"
+
+#include "CollectionSystemManager.h"
+#include "FileData.h"
+#include "Settings.h"
+#include "SystemData.h"
+#include <algorithm>
+#include <set>
+
+struct PlayersCase
+{
+	const char* players;
+	bool at2Players;
+	bool at4Players;
+};
+
+static const PlayersCase sPlayers[] = { { "1", false, false }, { "2", true, false }, { "1-4", true, true }, { "4", false, true }, { "2+", true, true }, { "", false, false } };
+
+// The games an auto collection gets, populated in a collection system of the test's own : populated collections
+// of the manager would be updated through the ViewController, which the tests don't have
+static std::set<FileData*> getCollectionGames(CollectionSystemType type)
+{
+	auto decls = CollectionSystemManager::getSystemDecls();
+	auto decl = std::find_if(decls.begin(), decls.end(), [type](const CollectionSystemDecl& decl) { return decl.type == type; });
+	if (decl == decls.end())
+		Test::fail(__FILE__, __LINE__, "unknown collection type " + std::to_string(type));
+
+	SystemMetadata md;
+	md.name = decl->name;
+	md.fullName = decl->longName;
+	md.themeFolder = decl->themeFolder;
+	md.releaseYear = 0;
+
+	SystemEnvironmentData envData;
+
+	CollectionSystemData sysData;
+	sysData.system = new SystemData(md, &envData, nullptr, true, false, false);
+	sysData.decl = *decl;
+	sysData.filteredIndex = nullptr;
+	sysData.isEnabled = true;
+	sysData.isPopulated = false;
+	sysData.needsSave = false;
+
+	CollectionSystemManager::get()->populateAutoCollection(&sysData);
+
+	std::set<FileData*> games;
+	for (auto game : sysData.system->getRootFolder()->getChildren())
+		games.insert(game->getSourceFileData());
+
+	delete sysData.system;
+	return games;
+}
+
+static void checkCollection(CollectionSystemType type, const std::vector<FileData*>& games, bool(*isMember)(FileData*))
+{
+	std::set<FileData*> expected;
+	for (auto game : games)
+		if (isMember(game))
+			expected.insert(game);
+
+	auto actual = getCollectionGames(type);
+	if (actual != expected)
+		Test::fail(__FILE__, __LINE__, "collection " + std::to_string(type) + " has " + std::to_string(actual.size()) + " games, expected " + std::to_string(expected.size()));
+}
+
+static bool hasPlayers(FileData* game, bool four)
+{
+	for (auto& test : sPlayers)
+		if (game->getMetadata(MetaDataId::Players) == test.players)
+			return four ? test.at4Players : test.at2Players;
+
+	return false;
+}
+
+static void checkCollections(const std::vector<FileData*>& games)
+{
+	checkCollection(AUTO_ALL_GAMES, games, [](FileData* game) { return true; });
+	checkCollection(AUTO_FAVORITES, games, [](FileData* game) { return game->getFavorite(); });
+	checkCollection(AUTO_NEVER_PLAYED, games, [](FileData* game) { return game->getMetadata(MetaDataId::PlayCount).empty() || game->getMetadata(MetaDataId::PlayCount) == "0"; });
+	checkCollection(AUTO_AT2PLAYERS, games, [](FileData* game) { return hasPlayers(game, false); });
+	checkCollection(AUTO_AT4PLAYERS, games, [](FileData* game) { return hasPlayers(game, true); });
+	checkCollection(AUTO_ARCADE, games, [](FileData* game) { return false; });
+}
+
+TEST(CollectionSystemManager_autoCollectionsMatchScan)
+{
+	std::string root = Test::getTempPath();
+
+	std::vector<std::string> files;
+	for (int i = 0; i < 24; i++)
+		files.push_back("snes/game" + std::to_string(i) + ".zip");
+
+	for (int i = 0; i < 12; i++)
+		files.push_back("megadrive/game" + std::to_string(i) + ".zip");
+
+	// Excluded from every auto collection : a hidden extension and the kodi entry
+	files.push_back("megadrive/hidden.bin");
+	files.push_back("megadrive/kodi.zip");
+
+	Test::createFiles(root, files);
+
+	Settings::getInstance()->setString("HiddenSystems", "");
+	Settings::getInstance()->setString("megadrive.HiddenExt", "bin");
+
+	SystemData* snes = Test::createSystem("snes", root + "/snes", { ".zip" });
+	SystemData* megadrive = Test::createSystem("megadrive", root + "/megadrive", { ".zip", ".bin" });
+
+	SystemData::sSystemVector.push_back(snes);
+	SystemData::sSystemVector.push_back(megadrive);
+
+	CollectionSystemManager::init(nullptr);
+
+	std::vector<FileData*> games;
+	for (auto system : { snes, megadrive })
+		for (auto game : system->getRootFolder()->getFilesRecursive(GAME))
+			if (game->getName() != "kodi" && game->getFileName() != "hidden.bin")
+				games.push_back(game);
+
+	CHECK_EQUAL(36, (int)games.size());
+
+	for (int i = 0; i < (int)games.size(); i++)
+	{
+		games[i]->setMetadata(MetaDataId::Favorite, i % 3 == 0 ? "true" : "false");
+		games[i]->setMetadata(MetaDataId::PlayCount, i % 2 == 0 ? "2" : "0");
+		games[i]->setMetadata(MetaDataId::Players, sPlayers[i % 6].players);
+	}
+
+	checkCollections(games);
+
+	// Games changing of collections are moved by refreshCollectionSystems, without a new walk of the systems
+	for (int i = 0; i < (int)games.size(); i += 5)
+	{
+		games[i]->setMetadata(MetaDataId::Favorite, games[i]->getFavorite() ? "false" : "true");
+		games[i]->setMetadata(MetaDataId::PlayCount, "1");
+		games[i]->setMetadata(MetaDataId::Players, sPlayers[(i + 1) % 6].players);
+		CollectionSystemManager::get()->refreshCollectionSystems(games[i]);
+	}
+
+	checkCollections(games);
+
+	// Deleted games leave every collection
+	for (int i = 0; i < 6; i++)
+	{
+		FileData* game = games.back();
+		games.pop_back();
+
+		CollectionSystemManager::get()->deleteCollectionFiles(game);
+		delete game;
+	}
+
+	checkCollections(games);
+
+	CollectionSystemManager::deinit();
+
+	SystemData::sSystemVector.clear();
+	delete snes;
+	delete megadrive;
+
+	Settings::getInstance()->setString("megadrive.HiddenExt", "");
+}
@@ -0,0 +1,171 @@
+#include "Test.h"
+#include "TestSystem.h"
+
+#include "CollectionSystemManager.h"
+#include "FileData.h"
+#include "FileFilterIndex.h"
+#include "FileSorts.h"
+#include "Settings.h"
+#include "SystemData.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+// Any setting change makes the next call compute the display list from scratch
+static std::vector<FileData*> getRebuiltList(FolderData* folder)
+{
+	static int count = 0;
+	Settings::getInstance()->setString("DisplayListTest", std::to_string(++count));
+
+	return folder->getChildrenListToDisplay();
+}
+
+static void checkDisplayList(FolderData* folder, const char* step)
+{
+	auto updated = folder->getChildrenListToDisplay();
+	auto rebuilt = getRebuiltList(folder);
+
+	if (updated != rebuilt)
+		Test::fail(__FILE__, __LINE__, std::string(step) + " : the updated list has " + std::to_string(updated.size()) + " items, the rebuilt one " + std::to_string(rebuilt.size()));
+}
+
+static std::vector<std::string> getGameFiles(int count)
+{
+	std::vector<std::string> files;
+
+	for (int i = 0; i < count; i++)
+	{
+		char name[32];
+		snprintf(name, sizeof(name), "game%05d.zip", i);
+		files.push_back(i % 20 == 0 ? std::string("folder/") + name : std::string(name));
+	}
+
+	return files;
+}
+
+TEST(FileData_displayListUpdateMatchesRebuild)
+{
+	std::string root = Test::getTempPath();
+	Test::createFiles(root, getGameFiles(400));
+
+	Settings::getInstance()->setString("CollectionSystemsAuto", "");
+	Settings::getInstance()->setBool("ShowHiddenFiles", false);
+
+	SystemData* system = Test::createSystem("test", root, { ".zip" });
+	SystemData::sSystemVector.push_back(system);
+
+	CollectionSystemManager::init(nullptr);
+	CollectionSystemManager::get()->loadCollectionSystems();
+
+	FolderData* folder = system->getRootFolder();
+	auto games = folder->getFilesRecursive(GAME);
+	CHECK_EQUAL(400, (int)games.size());
+
+	int renamed = 0;
+
+	for (auto viewMode : { "always", "never" })
+	{
+		for (auto sortId : { FileSorts::FILENAME_ASCENDING, FileSorts::FILENAME_DESCENDING })
+		{
+			Settings::getInstance()->setString("test.FolderViewMode", viewMode);
+			system->setSortId(sortId);
+
+			auto list = getRebuiltList(folder);
+			CHECK(list.size() > 0);
+			CHECK(list == folder->getChildrenListToDisplay());
+
+			// A few renamed games are moved to their new position
+			for (int i = 0; i < 5; i++, renamed++)
+				games[(renamed * 37) % games.size()]->setMetadata(MetaDataId::Name, "Renamed " + std::to_string(renamed));
+
+			checkDisplayList(folder, "renamed");
+
+			// Hidden games leave the list, and come back
+			for (int i = 0; i < 3; i++)
+				games[i * 53]->setMetadata(MetaDataId::Hidden, "true");
+
+			checkDisplayList(folder, "hidden");
+
+			for (int i = 0; i < 3; i++)
+				games[i * 53]->setMetadata(MetaDataId::Hidden, "false");
+
+			checkDisplayList(folder, "shown");
+
+			// Too many changes make the list computed again
+			for (int i = 0; i < 100; i++)
+				games[i * 3]->setMetadata(MetaDataId::Name, "Batch " + std::to_string(renamed++));
+
+			checkDisplayList(folder, "batch");
+
+			// A text filter keeps the matching games only, a renamed game can start to match
+			FileFilterIndex* index = system->getIndex(true);
+			index->setTextFilter("renamed");
+			checkDisplayList(folder, "filtered");
+
+			games[7]->setMetadata(MetaDataId::Name, "Renamed " + std::to_string(renamed++));
+			checkDisplayList(folder, "filtered rename");
+
+			index->setTextFilter("");
+			checkDisplayList(folder, "unfiltered");
+		}
+	}
+
+	CollectionSystemManager::deinit();
+
+	SystemData::sSystemVector.clear();
+	delete system;
+
+	Settings::getInstance()->setString("test.FolderViewMode", "");
+}
+
+BENCHMARK(FileData_displayList)
+{
+	const int count = 30000;
+
+	std::string root = Test::getTempPath();
+	Test::createFiles(root, getGameFiles(count));
+
+	Settings::getInstance()->setString("CollectionSystemsAuto", "");
+	Settings::getInstance()->setString("test.FolderViewMode", "never");
+
+	SystemData* system = Test::createSystem("test", root, { ".zip" });
+	SystemData::sSystemVector.push_back(system);
+
+	CollectionSystemManager::init(nullptr);
+	CollectionSystemManager::get()->loadCollectionSystems();
+
+	FolderData* folder = system->getRootFolder();
+	auto games = folder->getFilesRecursive(GAME);
+
+	const int iterations = 20;
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++)
+		getRebuiltList(folder);
+
+	auto rebuilt = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++)
+		folder->getChildrenListToDisplay();
+
+	auto cached = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++)
+	{
+		games[i * 101]->setMetadata(MetaDataId::Name, "Renamed " + std::to_string(i));
+		folder->getChildrenListToDisplay();
+	}
+
+	auto updated = std::chrono::steady_clock::now();
+
+	std::cout << "  " << count << " games : rebuild " << std::chrono::duration<double, std::milli>(rebuilt - start).count() / iterations << " ms"
+		<< ", cached " << std::chrono::duration<double, std::milli>(cached - rebuilt).count() / iterations << " ms"
+		<< ", one renamed game " << std::chrono::duration<double, std::milli>(updated - cached).count() / iterations << " ms" << std::endl;
+
+	CHECK(folder->getChildrenListToDisplay() == getRebuiltList(folder));
+
+	CollectionSystemManager::deinit();
+
+	SystemData::sSystemVector.clear();
+	delete system;
+
+	Settings::getInstance()->setString("test.FolderViewMode", "");
+}
@@ -0,0 +1,206 @@
+#include "Test.h"
+#include "TestSystem.h"
+
+#include "FileData.h"
+#include "FileFilterIndex.h"
+#include "SystemData.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+
+static int getKeyCount(FileFilterIndex* index, FilterIndexType type, const std::string& key)
+{
+	for (auto decl : index->getFilterDataDecls())
+	{
+		if (decl.type != type)
+			continue;
+
+		auto it = decl.allIndexKeys->find(key);
+		return it == decl.allIndexKeys->cend() ? 0 : it->second;
+	}
+
+	return 0;
+}
+
+// Names made of shared words, so that trigrams and words have long posting lists
+static std::vector<std::string> getGameNames(int count, unsigned int seed)
+{
+	static const char* words[] = { "Super", "Mario", "Bros", "Street", "Fighter", "II", "Sonic", "The", "Hedgehog", "Final", "Fight",
+		"Metal", "Slug", "Golden", "Axe", "Bubble", "Bobble", "Puzzle", "World", "Turbo", "Zelda", "Donkey", "Kong", "Country", "3" };
+
+	std::mt19937 random(seed);
+	std::vector<std::string> names;
+
+	for (int i = 0; i < count; i++)
+	{
+		std::string name;
+
+		int wordCount = 1 + random() % 4;
+		for (int w = 0; w < wordCount; w++)
+			name += std::string(w == 0 ? "" : " ") + words[random() % (sizeof(words) / sizeof(words[0]))];
+
+		names.push_back(name + " (" + std::to_string(i) + ").zip");
+	}
+
+	return names;
+}
+
+// An index without any game never has candidates, so it evaluates every game the way showFile did before the text index
+static void checkTextFilter(FileFilterIndex* index, const std::vector<FileData*>& games, const std::string& text, bool useRelevancy)
+{
+	FileFilterIndex fullScan;
+	fullScan.setTextFilter(text, useRelevancy);
+	index->setTextFilter(text, useRelevancy);
+
+	for (auto game : games)
+	{
+		if (index->showFile(game) != fullScan.showFile(game))
+			Test::fail(__FILE__, __LINE__, "'" + text + "' (relevancy " + std::to_string(useRelevancy) + ") differs for " + game->getName());
+	}
+}
+
+static const char* sTextFilters[] = { "mario", "MARIO BROS", "ario", "bro", "Fighter II", "street fighter", "fight", "sonic hedgehog",
+	"the", "golden,axe", "zelda, kong", "bubble,x", "xyz", "ma", "s", "Super Mario (1", "metal slug 3", "kong country 3", "(12)" };
+
+TEST(FileFilterIndex_textCandidatesMatchFullScan)
+{
+	std::string root = Test::getTempPath();
+	Test::createFiles(root, getGameNames(500, 1));
+
+	SystemData* system = Test::createSystem("test", root, { ".zip" });
+	FileFilterIndex* index = system->getIndex(true);
+
+	auto games = system->getRootFolder()->getFilesRecursive(GAME);
+	CHECK_EQUAL(500, (int)games.size());
+
+	for (auto text : sTextFilters)
+	{
+		checkTextFilter(index, games, text, false);
+		checkTextFilter(index, games, text, true);
+	}
+
+	// Renamed and deleted games must leave the text index, without rebuilding it
+	for (int i = 0; i < 50; i++)
+	{
+		games[i]->setMetadata(MetaDataId::Name, i % 2 ? "Golden Axe Warrior" : "Mario Kart");
+		system->updateIndex(games[i]);
+	}
+
+	for (int i = 0; i < 50; i++)
+		delete games[games.size() - 1 - i];
+
+	games.resize(games.size() - 50);
+
+	for (auto text : sTextFilters)
+	{
+		checkTextFilter(index, games, text, false);
+		checkTextFilter(index, games, text, true);
+	}
+
+	checkTextFilter(index, games, "mario kart", false);
+	checkTextFilter(index, games, "warrior", true);
+
+	index->setTextFilter("");
+	delete system;
+}
+
+TEST(FileFilterIndex_updateMatchesRebuild)
+{
+	std::string root = Test::getTempPath();
+	Test::createFiles(root, { "a.zip", "b.zip", "c.zip", "sub/d.zip" });
+
+	SystemData* system = Test::createSystem("test", root, { ".zip" });
+	FileFilterIndex* index = system->getIndex(true);
+
+	auto games = system->getRootFolder()->getFilesRecursive(GAME);
+	CHECK_EQUAL(4, (int)games.size());
+	CHECK(system->checkIndex());
+
+	const char* publishers[] = { "Sega", "Nintendo", "Sega", "Capcom" };
+
+	for (int i = 0; i < (int)games.size(); i++)
+	{
+		games[i]->setMetadata(MetaDataId::Publisher, publishers[i]);
+		games[i]->setMetadata(MetaDataId::Players, std::to_string(1 + i % 2));
+		games[i]->setMetadata(MetaDataId::ReleaseDate, "199" + std::to_string(i) + "0101T000000");
+		system->updateIndex(games[i]);
+		CHECK(system->checkIndex());
+	}
+
+	CHECK_EQUAL(2, getKeyCount(index, PUBDEV_FILTER, "SEGA"));
+	CHECK_EQUAL(2, getKeyCount(index, PLAYER_FILTER, "1"));
+
+	// Changing a value moves the game to its new key, an unchanged update keeps the counts
+	games[0]->setMetadata(MetaDataId::Publisher, "Capcom");
+	system->updateIndex(games[0]);
+	system->updateIndex(games[0]);
+	CHECK(system->checkIndex());
+	CHECK_EQUAL(1, getKeyCount(index, PUBDEV_FILTER, "SEGA"));
+	CHECK_EQUAL(2, getKeyCount(index, PUBDEV_FILTER, "CAPCOM"));
+
+	games[1]->setMetadata(MetaDataId::Favorite, "true");
+	games[1]->setMetadata(MetaDataId::Hidden, "true");
+	system->updateIndex(games[1]);
+	CHECK(system->checkIndex());
+
+	// A deleted game leaves the index
+	delete games[2];
+	CHECK(system->checkIndex());
+	CHECK_EQUAL(0, getKeyCount(index, PUBDEV_FILTER, "SEGA"));
+
+	delete system;
+}
+
+BENCHMARK(FileFilterIndex_textFilter)
+{
+	std::string root = Test::getTempPath();
+	Test::createFiles(root, getGameNames(20000, 2));
+
+	SystemData* system = Test::createSystem("test", root, { ".zip" });
+	FileFilterIndex* index = system->getIndex(true);
+	auto games = system->getRootFolder()->getFilesRecursive(GAME);
+
+	// Typed one character at a time, like the search box does
+	for (bool useRelevancy : { false, true })
+	{
+		double indexed = 0, fullScan = 0;
+		int keystrokes = 0;
+
+		for (std::string query : { "street fighter", "super mario bros", "zelda" })
+		{
+			for (size_t length = 1; length <= query.length(); length++)
+			{
+				std::string text = query.substr(0, length);
+
+				FileFilterIndex reference;
+				reference.setTextFilter(text, useRelevancy);
+				index->setTextFilter(text, useRelevancy);
+
+				int count = 0, referenceCount = 0;
+
+				auto start = std::chrono::steady_clock::now();
+				for (auto game : games)
+					if (index->showFile(game))
+						count++;
+
+				auto middle = std::chrono::steady_clock::now();
+				for (auto game : games)
+					if (reference.showFile(game))
+						referenceCount++;
+
+				auto end = std::chrono::steady_clock::now();
+
+				CHECK_EQUAL(referenceCount, count);
+
+				indexed += std::chrono::duration<double, std::milli>(middle - start).count();
+				fullScan += std::chrono::duration<double, std::milli>(end - middle).count();
+				keystrokes++;
+			}
+		}
+
+		std::cout << "  " << games.size() << " games, relevancy " << useRelevancy << " : indexed " << indexed / keystrokes << " ms, full scan " << fullScan / keystrokes << " ms per keystroke" << std::endl;
+	}
+
+	index->setTextFilter("");
+	delete system;
+}
@@ -0,0 +1,153 @@
+#include "Test.h"
+
+#include "utils/FileSystemUtil.h"
+#include "scrapers/Scraper.h"
+#include <FreeImage.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+static void writeImage(const std::string& path, FREE_IMAGE_FORMAT format, int width, int height)
+{
+	FIBITMAP* image = FreeImage_Allocate(width, height, 24);
+	CHECK(image != nullptr);
+
+	for (int y = 0; y < height; y++)
+	{
+		BYTE* line = FreeImage_GetScanLine(image, y);
+		for (int x = 0; x < width; x++)
+		{
+			line[x * 3 + FI_RGBA_RED] = (BYTE)(x * 255 / width);
+			line[x * 3 + FI_RGBA_GREEN] = (BYTE)(y * 255 / height);
+			line[x * 3 + FI_RGBA_BLUE] = (BYTE)((x ^ y) & 0xFF);
+		}
+	}
+
+	bool saved = FreeImage_Save(format, image, path.c_str()) != 0;
+	FreeImage_Unload(image);
+
+	CHECK(saved);
+}
+
+static void checkImageSize(const std::string& path, int width, int height)
+{
+	FIBITMAP* image = FreeImage_Load(FreeImage_GetFileType(path.c_str(), 0), path.c_str(), 0);
+	CHECK(image != nullptr);
+
+	int imageWidth = FreeImage_GetWidth(image);
+	int imageHeight = FreeImage_GetHeight(image);
+	FreeImage_Unload(image);
+
+	CHECK_EQUAL(width, imageWidth);
+	CHECK(std::abs(height - imageHeight) <= 1);
+}
+
+static void waitForResize(const std::vector<std::shared_ptr<std::atomic<bool>>>& jobs)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	for (auto& job : jobs)
+	{
+		while (!job->load())
+		{
+			if (std::chrono::steady_clock::now() - start > std::chrono::seconds(30))
+				Test::fail(__FILE__, __LINE__, "resizeImageAsync timed out");
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+	}
+}
+
+struct ResizeCase
+{
+	const char* file;
+	FREE_IMAGE_FORMAT format;
+	int width;
+	int height;
+	int maxWidth;
+	int maxHeight;
+	int expectedWidth;
+	int expectedHeight;
+};
+
+static const ResizeCase sResizeCases[] = {
+	{ "wide.png", FIF_PNG, 1200, 800, 400, 0, 400, 266 },
+	{ "tall.png", FIF_PNG, 600, 1200, 0, 300, 150, 300 },
+	{ "box.png", FIF_PNG, 1200, 800, 300, 300, 300, 300 },
+	{ "photo.jpg", FIF_JPEG, 2400, 1600, 400, 0, 400, 266 },
+	{ "small.png", FIF_PNG, 100, 50, 400, 0, 100, 50 } };
+
+// The worker pool gives the files resizeImage gives, and leaves small enough images untouched
+TEST(ResizeImage_asyncMatchesSync)
+{
+	std::string root = Test::getTempPath();
+	FreeImage_Initialise();
+
+	std::vector<std::shared_ptr<std::atomic<bool>>> jobs;
+
+	for (auto& test : sResizeCases)
+	{
+		std::string path = root + "/" + test.file;
+		writeImage(path, test.format, test.width, test.height);
+
+		Utils::FileSystem::copyFile(path, root + "/sync-" + test.file);
+		Utils::FileSystem::copyFile(path, root + "/async-" + test.file);
+
+		CHECK(resizeImage(root + "/sync-" + test.file, test.maxWidth, test.maxHeight));
+		jobs.push_back(resizeImageAsync(root + "/async-" + test.file, test.maxWidth, test.maxHeight));
+	}
+
+	waitForResize(jobs);
+
+	for (auto& test : sResizeCases)
+	{
+		std::string sync = Utils::FileSystem::readAllText(root + "/sync-" + test.file);
+		std::string async = Utils::FileSystem::readAllText(root + "/async-" + test.file);
+
+		CHECK(!sync.empty());
+		CHECK(sync == async);
+
+		checkImageSize(root + "/sync-" + test.file, test.expectedWidth, test.expectedHeight);
+
+		if (test.width == test.expectedWidth && test.height == test.expectedHeight)
+			CHECK(sync == Utils::FileSystem::readAllText(root + "/" + test.file));
+	}
+
+	FreeImage_DeInitialise();
+}
+
+BENCHMARK(ResizeImage_scrapedImages)
+{
+	const int count = 16;
+
+	std::string root = Test::getTempPath();
+	FreeImage_Initialise();
+
+	writeImage(root + "/source.jpg", FIF_JPEG, 3000, 2000);
+
+	for (int i = 0; i < count; i++)
+	{
+		Utils::FileSystem::copyFile(root + "/source.jpg", root + "/sync" + std::to_string(i) + ".jpg");
+		Utils::FileSystem::copyFile(root + "/source.jpg", root + "/async" + std::to_string(i) + ".jpg");
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < count; i++)
+		resizeImage(root + "/sync" + std::to_string(i) + ".jpg", 640, 0);
+
+	auto sync = std::chrono::steady_clock::now();
+
+	std::vector<std::shared_ptr<std::atomic<bool>>> jobs;
+	for (int i = 0; i < count; i++)
+		jobs.push_back(resizeImageAsync(root + "/async" + std::to_string(i) + ".jpg", 640, 0));
+
+	waitForResize(jobs);
+
+	auto async = std::chrono::steady_clock::now();
+
+	std::cout << "  " << count << " jpegs 3000x2000 to 640 : resizeImage " << std::chrono::duration<double, std::milli>(sync - start).count() / count << " ms per image"
+		<< ", worker pool " << std::chrono::duration<double, std::milli>(async - sync).count() / count << " ms per image" << std::endl;
+
+	FreeImage_DeInitialise();
+}
@@ -0,0 +1,95 @@
+#include "Test.h"
+#include "TestSystem.h"
+
+#include "utils/FileSystemUtil.h"
+#include "FileData.h"
+#include "Paths.h"
+#include "SaveStateRepository.h"
+#include "SystemData.h"
+#include <chrono>
+#include <thread>
+
+static FileData* findGame(SystemData* system, const std::string& fileName)
+{
+	for (auto game : system->getRootFolder()->getFilesRecursive(GAME))
+		if (Utils::FileSystem::getFileName(game->getPath()) == fileName)
+			return game;
+
+	Test::fail(__FILE__, __LINE__, fileName + " not found");
+}
+
+TEST(SaveStateRepository_refreshFollowsFolder)
+{
+	std::string root = Test::getTempPath();
+	Test::createFiles(root, { "roms/a.zip", "roms/b.zip", "roms/c.zip", "roms/d.zip" });
+	Test::createFiles(root, { "saves/test/a.state1", "saves/test/a.auto", "saves/test/b.state", "saves/test/b.state.png" });
+
+	std::string savesPath = Paths::getSavesPath();
+	Paths::getSavesPath() = root + "/saves";
+
+	SystemData* system = Test::createSystem("test", root + "/roms", { ".zip" });
+	SaveStateRepository* repository = system->getSaveStateRepository();
+
+	FileData* a = findGame(system, "a.zip");
+	FileData* b = findGame(system, "b.zip");
+	FileData* c = findGame(system, "c.zip");
+	FileData* d = findGame(system, "d.zip");
+
+	// The folder is listed on first access, not when the repository is created
+	Test::createFiles(root, { "saves/test/c.state2" });
+
+	CHECK(repository->hasSaveStates(a));
+	CHECK(repository->hasSaveStates(b));
+	CHECK(repository->hasSaveStates(c));
+	CHECK(!repository->hasSaveStates(d));
+
+	// Changes are seen after a refresh, even when made in the second the folder was listed
+	Test::createFiles(root, { "saves/test/d.state3" });
+	Utils::FileSystem::removeFile(root + "/saves/test/c.state2");
+
+	repository->refresh();
+	CHECK(repository->hasSaveStates(d));
+	CHECK(!repository->hasSaveStates(c));
+
+	// And once the folder time can tell it changed
+	std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+	repository->refresh();
+	CHECK(repository->hasSaveStates(d));
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+	Utils::FileSystem::removeFile(root + "/saves/test/a.state1");
+	Utils::FileSystem::removeFile(root + "/saves/test/a.auto");
+
+	repository->refresh(a);
+	CHECK(!repository->hasSaveStates(a));
+	CHECK(repository->hasSaveStates(b));
+
+	delete system;
+	Paths::getSavesPath() = savesPath;
+}
+
+TEST(SaveStateRepository_backgroundIndexing)
+{
+	std::string root = Test::getTempPath();
+	Test::createFiles(root, { "roms/a.zip", "roms/b.zip", "saves/test/a.state1" });
+
+	std::string savesPath = Paths::getSavesPath();
+	Paths::getSavesPath() = root + "/saves";
+
+	SystemData* system = Test::createSystem("test", root + "/roms", { ".zip" });
+	SystemData::sSystemVector.push_back(system);
+
+	SaveStateRepository::startIndexing();
+
+	// The UI may read the index while it is being filled
+	CHECK(system->getSaveStateRepository()->hasSaveStates(findGame(system, "a.zip")));
+	CHECK(!system->getSaveStateRepository()->hasSaveStates(findGame(system, "b.zip")));
+
+	SaveStateRepository::stopIndexing();
+
+	CHECK(system->getSaveStateRepository()->hasSaveStates(findGame(system, "a.zip")));
+
+	SystemData::sSystemVector.clear();
+	delete system;
+	Paths::getSavesPath() = savesPath;
+}
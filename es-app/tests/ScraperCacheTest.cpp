@@ -0,0 +1,109 @@
+#include "Test.h"
+
+#include "scrapers/Scraper.h"
+#include "scrapers/ScraperCache.h"
+#include "services/httplib.h"
+#include "Settings.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// Keeps the raw response instead of parsing it
+class RawScraperRequest : public ScraperHttpRequest
+{
+public:
+	RawScraperRequest(std::vector<ScraperSearchResult>& results, const std::string& url) : ScraperHttpRequest(results, url) { }
+
+	std::string content;
+
+protected:
+	bool process(const std::string& data, std::vector<ScraperSearchResult>& results) override
+	{
+		content = data;
+		return true;
+	}
+};
+
+static std::string runRequest(const std::string& url)
+{
+	std::vector<ScraperSearchResult> results;
+
+	RawScraperRequest request(results, url);
+	request.setCacheContext("test", "system");
+
+	auto start = std::chrono::steady_clock::now();
+
+	AsyncHandleStatus status;
+	while ((status = request.status()) == ASYNC_IN_PROGRESS)
+	{
+		if (std::chrono::steady_clock::now() - start > std::chrono::seconds(10))
+			Test::fail(__FILE__, __LINE__, "timeout requesting " + url);
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+
+	CHECK(status == ASYNC_DONE);
+	return request.content;
+}
+
+// Local http server answering "result of [name]" to /search?name=[name], and counting the requests it received
+class MockServer
+{
+public:
+	MockServer() : hits(0)
+	{
+		mServer.Get("/search", [this](const httplib::Request& req, httplib::Response& res)
+		{
+			hits++;
+			res.set_content("result of " + req.get_param_value("name"), "text/plain");
+		});
+
+		port = mServer.bind_to_any_port("127.0.0.1");
+		mThread = std::thread([this] { mServer.listen_after_bind(); });
+	}
+
+	~MockServer()
+	{
+		mServer.stop();
+		mThread.join();
+	}
+
+	std::string getUrl(const std::string& name) { return "http://127.0.0.1:" + std::to_string(port) + "/search?name=" + name; }
+
+	std::atomic<int> hits;
+	int port;
+
+private:
+	httplib::Server mServer;
+	std::thread mThread;
+};
+
+TEST(ScraperCache_replayDoesNotQueryServer)
+{
+	MockServer server;
+	CHECK(server.port > 0);
+
+	Settings::getInstance()->setBool("ScraperCache", true);
+	ScraperCache::getInstance()->clear();
+
+	std::string url = server.getUrl("sonic");
+
+	CHECK_EQUAL(std::string("result of sonic"), runRequest(url + "&devpassword=first"));
+	CHECK_EQUAL(1, server.hits.load());
+
+	// The replay is served from the cache, the credentials are not part of the key
+	CHECK_EQUAL(std::string("result of sonic"), runRequest(url + "&devpassword=second"));
+	CHECK_EQUAL(1, server.hits.load());
+
+	CHECK_EQUAL(std::string("result of tails"), runRequest(server.getUrl("tails")));
+	CHECK_EQUAL(2, server.hits.load());
+
+	// Once cleared, or when disabled, the server is queried again
+	ScraperCache::getInstance()->clear();
+	runRequest(url);
+	CHECK_EQUAL(3, server.hits.load());
+
+	Settings::getInstance()->setBool("ScraperCache", false);
+	runRequest(url);
+	CHECK_EQUAL(4, server.hits.load());
+}
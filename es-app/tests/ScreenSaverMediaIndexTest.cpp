@@ -0,0 +1,88 @@
+#include "Test.h"
+#include "TestSystem.h"
+
+#include "utils/FileSystemUtil.h"
+#include "FileData.h"
+#include "ScreenSaverMediaIndex.h"
+#include "SystemData.h"
+#include <map>
+
+// Picks until every candidate has been seen, checking that only the expected games & paths come out
+static void checkPicks(ScreenSaverMediaIndex& index, const std::map<FileData*, std::string>& expected)
+{
+	CHECK_EQUAL(expected.size(), index.size());
+
+	std::map<FileData*, int> seen;
+
+	for (int i = 0; i < 200 * (int)expected.size() + 1; i++)
+	{
+		std::string path;
+		FileData* game = index.pick(path);
+
+		if (expected.empty())
+		{
+			CHECK(game == nullptr);
+			return;
+		}
+
+		auto it = expected.find(game);
+		CHECK(it != expected.cend());
+		CHECK_EQUAL(it->second, path);
+
+		seen[game]++;
+	}
+
+	CHECK_EQUAL(expected.size(), seen.size());
+}
+
+TEST(ScreenSaverMediaIndex_followsGameChanges)
+{
+	std::string root = Test::getTempPath();
+	Test::createFiles(root, { "roms/a.zip", "roms/b.zip", "roms/c.zip", "roms/d.zip", "roms/e.zip", "videos/a.mp4", "videos/b.mp4", "videos/e.mp4" });
+
+	SystemData* system = Test::createSystem("test", root + "/roms", { ".zip" });
+	SystemData::sSystemVector.push_back(system);
+
+	std::map<std::string, FileData*> games;
+	for (auto game : system->getRootFolder()->getFilesRecursive(GAME))
+		games[Utils::FileSystem::getStem(game->getPath())] = game;
+
+	// c has a missing video, d has none
+	games["a"]->setMetadata(MetaDataId::Video, root + "/videos/a.mp4");
+	games["b"]->setMetadata(MetaDataId::Video, root + "/videos/b.mp4");
+	games["c"]->setMetadata(MetaDataId::Video, root + "/videos/c.mp4");
+
+	ScreenSaverMediaIndex index(true);
+	index.update();
+	index.waitValidation();
+
+	checkPicks(index, { { games["a"], root + "/videos/a.mp4" }, { games["b"], root + "/videos/b.mp4" } });
+
+	// Nothing changed : no new check
+	index.update();
+	checkPicks(index, { { games["a"], root + "/videos/a.mp4" }, { games["b"], root + "/videos/b.mp4" } });
+
+	// A miss stays out until the game changes
+	index.remove(games["a"]);
+	index.update();
+	checkPicks(index, { { games["b"], root + "/videos/b.mp4" } });
+
+	games["a"]->setMetadata(MetaDataId::Video, root + "/videos/e.mp4");
+	games["e"]->setMetadata(MetaDataId::Video, root + "/videos/e.mp4");
+	index.update();
+	index.waitValidation();
+	checkPicks(index, { { games["a"], root + "/videos/e.mp4" }, { games["b"], root + "/videos/b.mp4" }, { games["e"], root + "/videos/e.mp4" } });
+
+	// A deleted game leaves the candidates
+	delete games["b"];
+	index.update();
+	index.waitValidation();
+	checkPicks(index, { { games["a"], root + "/videos/e.mp4" }, { games["e"], root + "/videos/e.mp4" } });
+
+	// So do the games of a removed system
+	SystemData::sSystemVector.clear();
+	delete system;
+
+	index.update();
+	checkPicks(index, { });
+}
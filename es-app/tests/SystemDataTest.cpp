@@ -0,0 +1,98 @@
+#include "Test.h"
+#include "TestSystem.h"
+
+#include "utils/FileSystemUtil.h"
+#include "CollectionSystemManager.h"
+#include "FileData.h"
+#include "Settings.h"
+#include "SystemData.h"
+#include <algorithm>
+
+static std::vector<std::string> getPaths(SystemData* system, unsigned int typeMask)
+{
+	std::vector<std::string> paths;
+	for (auto file : system->getRootFolder()->getFilesRecursive(typeMask))
+		paths.push_back(file->getPath());
+
+	std::sort(paths.begin(), paths.end());
+	return paths;
+}
+
+// The tree updated with updateFiles must be the one a full scan of the folder gives
+static void checkMatchesScan(SystemData* system, const std::string& root)
+{
+	SystemData* scanned = Test::createSystem("scanned", root, { ".zip" });
+
+	auto games = getPaths(system, GAME);
+	auto scannedGames = getPaths(scanned, GAME);
+	auto folders = getPaths(system, FOLDER);
+	auto scannedFolders = getPaths(scanned, FOLDER);
+
+	delete scanned;
+
+	CHECK_EQUAL(scannedGames.size(), games.size());
+	CHECK(games == scannedGames);
+	CHECK(folders == scannedFolders);
+	CHECK(system->checkIndex());
+}
+
+TEST(SystemData_updateFilesAddAndRemove)
+{
+	std::string root = Test::getTempPath();
+	Test::createFiles(root, { "a.zip", "b.zip", "sub/c.zip", "sub/d.zip" });
+
+	Settings::getInstance()->setBool("ShowHiddenFiles", false);
+	CollectionSystemManager::init(nullptr);
+
+	SystemData* system = Test::createSystem("test", root, { ".zip" });
+	system->getIndex(true);
+
+	CHECK_EQUAL(4, (int)getPaths(system, GAME).size());
+
+	// Paths out of the system are ignored
+	CHECK(!system->updateFiles({ Utils::FileSystem::getParent(root) + "/other/e.zip" }));
+
+	// A new game
+	Test::createFiles(root, { "e.zip" });
+	CHECK(system->updateFiles({ root + "/e.zip" }));
+	CHECK(system->getRootFolder()->FindByPath(root + "/e.zip") != nullptr);
+	checkMatchesScan(system, root);
+
+	// Already known games, unknown extensions and hidden files are not added
+	Test::createFiles(root, { "readme.txt", ".hidden.zip" });
+	CHECK(system->updateFiles({ root + "/e.zip", root + "/readme.txt", root + "/.hidden.zip" }));
+	CHECK_EQUAL(5, (int)getPaths(system, GAME).size());
+	checkMatchesScan(system, root);
+
+	// A game in folders having no game yet : only the game is notified, its folders are created
+	Test::createFiles(root, { "new/deep/f.zip" });
+	CHECK(system->updateFiles({ root + "/new/deep/f.zip" }));
+	checkMatchesScan(system, root);
+
+	// A folder moved in with its games : only the folder is notified
+	Test::createFiles(root, { "moved/g.zip", "moved/inner/h.zip" });
+	CHECK(system->updateFiles({ root + "/moved" }));
+	CHECK_EQUAL(8, (int)getPaths(system, GAME).size());
+	checkMatchesScan(system, root);
+
+	// A deleted game
+	Utils::FileSystem::removeFile(root + "/b.zip");
+	CHECK(system->updateFiles({ root + "/b.zip" }));
+	CHECK(system->getRootFolder()->FindByPath(root + "/b.zip") == nullptr);
+	checkMatchesScan(system, root);
+
+	// A deleted folder takes its games and subfolders away, their own events come after and are ignored
+	Utils::FileSystem::deleteDirectoryFiles(root + "/moved", true);
+	CHECK(system->updateFiles({ root + "/moved", root + "/moved/g.zip", root + "/moved/inner", root + "/moved/inner/h.zip" }));
+	CHECK_EQUAL(5, (int)getPaths(system, GAME).size());
+	checkMatchesScan(system, root);
+
+	// Created and deleted in the same batch
+	Test::createFiles(root, { "i.zip" });
+	Utils::FileSystem::removeFile(root + "/a.zip");
+	CHECK(system->updateFiles({ root + "/i.zip", root + "/a.zip" }));
+	checkMatchesScan(system, root);
+
+	delete system;
+	CollectionSystemManager::deinit();
+}
@@ -0,0 +1,44 @@
+#include "TestSystem.h"
+
+#include "utils/FileSystemUtil.h"
+#include "MetaData.h"
+#include "SystemData.h"
+#include <fstream>
+
+namespace Test
+{
+	void createFiles(const std::string& root, const std::vector<std::string>& files)
+	{
+		for (auto file : files)
+		{
+			std::string path = root + "/" + file;
+			Utils::FileSystem::createDirectory(Utils::FileSystem::getParent(path));
+
+			std::ofstream stream(path);
+		}
+	}
+
+	SystemData* createSystem(const std::string& name, const std::string& romPath, const std::vector<std::string>& extensions)
+	{
+		static bool initialized = false;
+		if (!initialized)
+		{
+			MetaDataList::initMetadata();
+			initialized = true;
+		}
+
+		SystemMetadata md;
+		md.name = name;
+		md.fullName = name;
+		md.themeFolder = name;
+		md.releaseYear = 0;
+
+		SystemEnvironmentData* envData = new SystemEnvironmentData();
+		envData->mStartPath = romPath;
+
+		for (auto ext : extensions)
+			envData->mSearchExtensions.insert(ext);
+
+		return new SystemData(md, envData, nullptr, false, false, false);
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+#ifndef ES_APP_TESTS_TEST_SYSTEM_H
+#define ES_APP_TESTS_TEST_SYSTEM_H
+
+#include <string>
+#include <vector>
+
+class SystemData;
+
+namespace Test
+{
+	// Creates empty files, relative to root, creating their folders as well
+	void createFiles(const std::string& root, const std::vector<std::string>& files);
+
+	// Creates a game system scanning romPath, without theme nor emulators. The caller deletes it.
+	SystemData* createSystem(const std::string& name, const std::string& romPath, const std::vector<std::string>& extensions);
+}
+
+#endif // ES_APP_TESTS_TEST_SYSTEM_H
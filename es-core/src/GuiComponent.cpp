@@ -896,136 +896,158 @@ bool GuiComponent::isChild(GuiComponent* cmp)
 	return false;
 }
 
-ThemeData::ThemeElement::Property GuiComponent::getProperty(const std::string name)
+// Properties that are forwarded to a ScrollableContainer parent
+static bool isScrollableContainerProperty(unsigned int id)
 {
-	if (getParent() != nullptr && getParent()->isKindOf<ScrollableContainer>())
+	switch (id)
 	{
-		if (name == "pos" || name == "x" || name =="y" || name=="size" || name == "w" || name == "h" || name == "offset" || name == "offsetX" || name == "offsetY")
-			return getParent()->getProperty(name);
+	case ThemeProperty::POS:
+	case ThemeProperty::X:
+	case ThemeProperty::Y:
+	case ThemeProperty::SIZE:
+	case ThemeProperty::W:
+	case ThemeProperty::H:
+	case ThemeProperty::OFFSET:
+	case ThemeProperty::OFFSET_X:
+	case ThemeProperty::OFFSET_Y:
+		return true;
 	}
 
+	return false;
+}
+
+ThemeData::ThemeElement::Property GuiComponent::getProperty(unsigned int id)
+{
+	if (getParent() != nullptr && isScrollableContainerProperty(id) && getParent()->isKindOf<ScrollableContainer>())
+		return getParent()->getProperty(id);
+
 	Vector2f screenScale = Vector2f((float)Renderer::getScreenWidth(), (float)Renderer::getScreenHeight());
 	Vector2f scale = getParent() ? getParent()->getSize() : screenScale;
 
-	if (name == "pos")
+	switch (id)
+	{
+	case ThemeProperty::POS:
 		return Vector2f(mPosition.x(), mPosition.y()) / scale;
-
-	if (name == "x")
+	case ThemeProperty::X:
 		return mPosition.x() / scale.x();
-
-	if (name == "y")
+	case ThemeProperty::Y:
 		return mPosition.y() / scale.y();
-	
-	if (name == "size")
+	case ThemeProperty::SIZE:
 		return mSize / scale;
-
-	if (name == "w")
+	case ThemeProperty::W:
 		return mSize.x() / scale.x();
-
-	if (name == "h")
+	case ThemeProperty::H:
 		return mSize.y() / scale.y();
-
-	if (name == "origin")
+	case ThemeProperty::ORIGIN:
 		return getOrigin();
-
-	if (name == "rotation")
+	case ThemeProperty::ROTATION:
 		return getRotation();
-
-	if (name == "rotationOrigin")
+	case ThemeProperty::ROTATION_ORIGIN:
 		return getRotationOrigin();
-
-	if (name == "opacity")
+	case ThemeProperty::OPACITY:
 		return getOpacity() / 255.0f;
-
-	if (name == "zIndex")
+	case ThemeProperty::Z_INDEX:
 		return getZIndex();
-
-	if (name == "scale")
+	case ThemeProperty::SCALE:
 		return getScale();
-
-	if (name == "scaleOrigin")
+	case ThemeProperty::SCALE_ORIGIN:
 		return getScaleOrigin();
-
-	if (name == "offset")
+	case ThemeProperty::OFFSET:
 		return mScreenOffset / screenScale;
-
-	if (name == "offsetX")
+	case ThemeProperty::OFFSET_X:
 		return mScreenOffset.x() / screenScale.x();
-
-	if (name == "offsetY")
+	case ThemeProperty::OFFSET_Y:
 		return mScreenOffset.y() / screenScale.y();
-
-	if (name == "clipRect")
+	case ThemeProperty::CLIP_RECT:
 		return Vector4f(mClipRect.x() / screenScale.x(), mClipRect.y() / screenScale.y(), mClipRect.z() /screenScale.x(), mClipRect.w() / screenScale.y());
+	}
 
 	return "";
 }
 
-void GuiComponent::setProperty(const std::string name, const ThemeData::ThemeElement::Property& value)
+void GuiComponent::setProperty(unsigned int id, const ThemeData::ThemeElement::Property& value)
 {
+	if (getParent() != nullptr && isScrollableContainerProperty(id) && getParent()->isKindOf<ScrollableContainer>())
+	{
+		getParent()->setProperty(id, value);
+		return;
+	}
+
 	Vector2f screenScale = Vector2f((float)Renderer::getScreenWidth(), (float)Renderer::getScreenHeight());
 	Vector2f scale = getParent() ? getParent()->getSize() : screenScale;
 
-	if (getParent() != nullptr && getParent()->isKindOf<ScrollableContainer>())
+	switch (id)
 	{
-		if (name == "pos" || name == "x" || name == "y" || name == "size" || name == "w" || name == "h" || name == "offset" || name == "offsetX" || name == "offsetY")
-		{
-			getParent()->setProperty(name, value);
-			return;
-		}
+	case ThemeProperty::POS:
+		if (value.type == ThemeData::ThemeElement::Property::PropertyType::Pair)
+			setPosition(Vector3f(value.v.x() * scale.x(), value.v.y() * scale.y(), 0));
+		break;
+	case ThemeProperty::X:
+		if (value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
+			setPosition(Vector3f(value.f * scale.x(), mPosition.y(), 0));
+		break;
+	case ThemeProperty::Y:
+		if (value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
+			setPosition(Vector3f(mPosition.x(), value.f * scale.y(), 0));
+		break;
+	case ThemeProperty::SIZE:
+		if (value.type == ThemeData::ThemeElement::Property::PropertyType::Pair)
+			setSize(Vector2f(value.v.x() * scale.x(), value.v.y() * scale.y()));
+		break;
+	case ThemeProperty::W:
+		if (value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
+			setSize(Vector2f(value.f * scale.x(), mSize.y()));
+		break;
+	case ThemeProperty::H:
+		if (value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
+			setSize(Vector2f(mSize.x(), value.f * scale.y()));
+		break;
+	case ThemeProperty::ORIGIN:
+		if (value.type == ThemeData::ThemeElement::Property::PropertyType::Pair)
+			setOrigin(Vector2f(value.v.x(), value.v.y()));
+		break;
+	case ThemeProperty::ROTATION:
+		if (value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
+			setRotationDegrees(value.f);
+		break;
+	case ThemeProperty::ROTATION_ORIGIN:
+		if (value.type == ThemeData::ThemeElement::Property::PropertyType::Pair)
+			setRotationOrigin(Vector2f(value.v.x(), value.v.y()));
+		break;
+	case ThemeProperty::Z_INDEX:
+		if (value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
+			setZIndex(value.f);
+		break;
+	case ThemeProperty::OPACITY:
+		if (value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
+			setOpacity(value.f * 255.0f);
+		break;
+	case ThemeProperty::SCALE:
+		if (value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
+			setScale(value.f);
+		break;
+	case ThemeProperty::SCALE_ORIGIN:
+		if (value.type == ThemeData::ThemeElement::Property::PropertyType::Pair)
+			setScaleOrigin(Vector2f(value.v.x(), value.v.y()));
+		break;
+	case ThemeProperty::OFFSET:
+		if (value.type == ThemeData::ThemeElement::Property::PropertyType::Pair)
+			setScreenOffset(Vector2f(value.v.x() * screenScale.x(), value.v.y() * screenScale.y()));
+		break;
+	case ThemeProperty::OFFSET_X:
+		if (value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
+			setScreenOffset(Vector2f(value.f * screenScale.x(), mScreenOffset.y()));
+		break;
+	case ThemeProperty::OFFSET_Y:
+		if (value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
+			setScreenOffset(Vector2f(mScreenOffset.x(), value.f * screenScale.y()));
+		break;
+	case ThemeProperty::CLIP_RECT:
+		if (value.type == ThemeData::ThemeElement::Property::PropertyType::Rect)
+			setClipRect(Vector4f(value.r.x() * screenScale.x(), value.r.y() * screenScale.y(), value.r.z() * screenScale.x(), value.r.w() * screenScale.y()));
+		break;
 	}
 
-	if (name == "pos" && value.type == ThemeData::ThemeElement::Property::PropertyType::Pair)
-		setPosition(Vector3f(value.v.x() * scale.x(), value.v.y() * scale.y(), 0));
-
-	if (name == "x" && value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
-		setPosition(Vector3f(value.f * scale.x(), mPosition.y(), 0));
-
-	if (name == "y" && value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
-		setPosition(Vector3f(mPosition.x(), value.f * scale.y(), 0));
-
-	if (name == "size" && value.type == ThemeData::ThemeElement::Property::PropertyType::Pair)
-		setSize(Vector2f(value.v.x() * scale.x(), value.v.y() * scale.y()));
-
-	if (name == "w" && value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
-		setSize(Vector2f(value.f * scale.x(), mSize.y()));
-
-	if (name == "h" && value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
-		setSize(Vector2f(mSize.x(), value.f * scale.y()));
-
-	if (name == "origin" && value.type == ThemeData::ThemeElement::Property::PropertyType::Pair)
-		setOrigin(Vector2f(value.v.x(), value.v.y()));
-
-	if (name == "rotation" && value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
-		setRotationDegrees(value.f);
-
-	if (name == "rotationOrigin" && value.type == ThemeData::ThemeElement::Property::PropertyType::Pair)
-		setRotationOrigin(Vector2f(value.v.x(), value.v.y()));
-
-	if (name == "zIndex" && value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
-		setZIndex(value.f);
-
-	if (name == "opacity" && value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
-		setOpacity(value.f * 255.0f);
-
-	if (name == "scale" && value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
-		setScale(value.f);
-
-	if (name == "scaleOrigin" && value.type == ThemeData::ThemeElement::Property::PropertyType::Pair)
-		setScaleOrigin(Vector2f(value.v.x(), value.v.y()));
-
-	if (name == "offset" && value.type == ThemeData::ThemeElement::Property::PropertyType::Pair)
-		setScreenOffset(Vector2f(value.v.x() * screenScale.x(), value.v.y() * screenScale.y()));
-	
-	if (name == "offsetX" && value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
-		setScreenOffset(Vector2f(value.f * screenScale.x(), mScreenOffset.y()));
-
-	if (name == "offsetY" && value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
-		setScreenOffset(Vector2f(mScreenOffset.x(), value.f * screenScale.y()));
-
-	if (name == "clipRect" && value.type == ThemeData::ThemeElement::Property::PropertyType::Rect)
-		setClipRect(Vector4f(value.r.x() * screenScale.x(), value.r.y() * screenScale.y(), value.r.z() * screenScale.x(), value.r.w() * screenScale.y()));
-
 	mTransformDirty = true;
 }
 
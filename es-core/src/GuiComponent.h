@@ -177,8 +177,9 @@ public:
 	bool isStaticExtra() const { return mStaticExtra; }
 	void setIsStaticExtra(bool value) { mStaticExtra = value; }
 
-	virtual ThemeData::ThemeElement::Property getProperty(const std::string name);
-	virtual void setProperty(const std::string name, const ThemeData::ThemeElement::Property& value);
+	// id is an interned property name ( see ThemeProperty::PropertyId )
+	virtual ThemeData::ThemeElement::Property getProperty(unsigned int id);
+	virtual void setProperty(unsigned int id, const ThemeData::ThemeElement::Property& value);
 
 	bool isShowing() { return mShowing; }
 
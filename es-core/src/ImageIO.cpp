@@ -9,9 +9,162 @@
 #include <fstream>
 #include <map>
 #include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 #include "renderers/Renderer.h"
 #include "Paths.h"
 
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IMAGEIO_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define IMAGEIO_NEON
+#endif
+
+// Converts a FreeImage 32 bits scanline (BGRA in memory) to RGBA
+static void convertScanLineBGRA32(const unsigned int* src, unsigned int* dst, int count)
+{
+	int x = 0;
+
+#if defined(IMAGEIO_SSE2)
+	const __m128i maskAG = _mm_set1_epi32(0xFF00FF00);
+	const __m128i maskB = _mm_set1_epi32(0x000000FF);
+
+	for (; x + 4 <= count; x += 4)
+	{
+		__m128i c = _mm_loadu_si128((const __m128i*)(src + x));
+		__m128i ag = _mm_and_si128(c, maskAG);
+		__m128i r = _mm_and_si128(_mm_srli_epi32(c, 16), maskB);
+		__m128i b = _mm_slli_epi32(_mm_and_si128(c, maskB), 16);
+		_mm_storeu_si128((__m128i*)(dst + x), _mm_or_si128(ag, _mm_or_si128(r, b)));
+	}
+#elif defined(IMAGEIO_NEON)
+	for (; x + 16 <= count; x += 16)
+	{
+		uint8x16x4_t px = vld4q_u8((const uint8_t*)(src + x));
+		uint8x16_t tmp = px.val[0];
+		px.val[0] = px.val[2];
+		px.val[2] = tmp;
+		vst4q_u8((uint8_t*)(dst + x), px);
+	}
+#endif
+
+	for (; x < count; x++)
+	{
+		unsigned int c = src[x];
+		dst[x] = (c & 0xFF00FF00) | ((c & 0xFF) << 16) | ((c >> 16) & 0xFF);
+	}
+}
+
+// Converts a FreeImage 24 bits scanline (BGR in memory) to opaque RGBA, avoiding FreeImage_ConvertTo32Bits
+static void convertScanLineBGR24(const unsigned char* src, unsigned char* dst, int count)
+{
+	int x = 0;
+
+#if defined(IMAGEIO_NEON)
+	const uint8x16_t alpha = vdupq_n_u8(0xFF);
+
+	for (; x + 16 <= count; x += 16)
+	{
+		uint8x16x3_t px = vld3q_u8(src + x * 3);
+
+		uint8x16x4_t out;
+		out.val[0] = px.val[FI_RGBA_RED];
+		out.val[1] = px.val[FI_RGBA_GREEN];
+		out.val[2] = px.val[FI_RGBA_BLUE];
+		out.val[3] = alpha;
+		vst4q_u8(dst + x * 4, out);
+	}
+#endif
+
+	for (; x < count; x++)
+	{
+		const unsigned char* s = src + x * 3;
+		unsigned char* d = dst + x * 4;
+		d[0] = s[FI_RGBA_RED];
+		d[1] = s[FI_RGBA_GREEN];
+		d[2] = s[FI_RGBA_BLUE];
+		d[3] = 0xFF;
+	}
+}
+
+// Converts a decoded bitmap to a RGBA buffer, rescaled to fit maxSize. The source bitmap is left untouched
+static unsigned char* convertBitmapToRGBA32(FIBITMAP* fiSource, size_t & width, size_t & height, MaxSizeInfo* maxSize, Vector2i* baseSize, Vector2i* packedSize)
+{
+	FIBITMAP* fiBitmap = fiSource;
+
+	//convert to 32bit if necessary. 24 bits bitmaps are expanded while copying the pixels
+	bool isRGB24 = FreeImage_GetBPP(fiBitmap) == 24 && FreeImage_GetImageType(fiBitmap) == FIT_BITMAP;
+	if (FreeImage_GetBPP(fiBitmap) != 32 && !isRGB24)
+	{
+		FIBITMAP * fiConverted = FreeImage_ConvertTo32Bits(fiBitmap);
+		if (fiConverted != nullptr)
+			fiBitmap = fiConverted;
+	}
+
+	width = FreeImage_GetWidth(fiBitmap);
+	height = FreeImage_GetHeight(fiBitmap);
+
+	if (baseSize != nullptr)
+		*baseSize = Vector2i(width, height);
+
+	if (maxSize != nullptr && maxSize->x() > 0 && maxSize->y() > 0 && (width > maxSize->x() || height > maxSize->y()))
+	{
+		Vector2i sz = ImageIO::adjustPictureSize(Vector2i(width, height), Vector2i(maxSize->x(), maxSize->y()), maxSize->externalZoom());
+
+		if (sz.x() > Renderer::getScreenWidth() || sz.y() > Renderer::getScreenHeight())
+			sz = ImageIO::adjustPictureSize(sz, Vector2i(Renderer::getScreenWidth(), Renderer::getScreenHeight()), false);
+
+		if (sz.x() != width || sz.y() != height)
+		{
+			LOG(LogDebug) << "ImageIO : rescaling image from " << std::string(std::to_string(width) + "x" + std::to_string(height)).c_str() << " to " << std::string(std::to_string(sz.x()) + "x" + std::to_string(sz.y())).c_str();
+
+			FIBITMAP* imageRescaled = FreeImage_Rescale(fiBitmap, sz.x(), sz.y(), FILTER_BOX);
+			if (imageRescaled != nullptr)
+			{
+				if (fiBitmap != fiSource)
+					FreeImage_Unload(fiBitmap);
+
+				fiBitmap = imageRescaled;
+
+				width = FreeImage_GetWidth(fiBitmap);
+				height = FreeImage_GetHeight(fiBitmap);
+
+				if (packedSize != nullptr)
+					*packedSize = Vector2i(width, height);
+			}
+		}
+	}
+
+	unsigned char* tempData = new unsigned char[width * height * 4];
+
+	int w = (int)width;
+
+	if (isRGB24 && FreeImage_GetBPP(fiBitmap) == 24)
+	{
+		for (int y = (int)height; --y >= 0; )
+			convertScanLineBGR24(FreeImage_GetScanLine(fiBitmap, y), tempData + (y * width * 4), w);
+	}
+	else
+	{
+		for (int y = (int)height; --y >= 0; )
+			convertScanLineBGRA32((unsigned int*)FreeImage_GetScanLine(fiBitmap, y), (unsigned int*)(tempData + (y * width * 4)), w);
+	}
+
+	if (fiBitmap != fiSource)
+		FreeImage_Unload(fiBitmap);
+
+	return tempData;
+}
+
 unsigned char* ImageIO::loadFromMemoryRGBA32(const unsigned char * data, const size_t size, size_t & width, size_t & height, MaxSizeInfo* maxSize, Vector2i* baseSize, Vector2i* packedSize, int subImageIndex)
 {
 	LOG(LogDebug) << "ImageIO::loadFromMemoryRGBA32";
@@ -19,10 +172,9 @@ unsigned char* ImageIO::loadFromMemoryRGBA32(const unsigned char * data, const s
 	if (baseSize != nullptr)
 		*baseSize = Vector2i(0, 0);
 
-	if (baseSize != nullptr)
+	if (packedSize != nullptr)
 		*packedSize = Vector2i(0, 0);
 
-	std::vector<unsigned char> rawData;
 	width = 0;
 	height = 0;
 	FIMEMORY * fiMemory = FreeImage_OpenMemory((BYTE *)data, (DWORD)size);
@@ -47,99 +199,28 @@ unsigned char* ImageIO::loadFromMemoryRGBA32(const unsigned char * data, const s
 				{
 					fiBitmap = FreeImage_LockPage(fiMultiBitmap, subImageIndex);
 					if (fiBitmap == nullptr)
-						FreeImage_CloseMultiBitmap(fiMultiBitmap);				
+					{
+						FreeImage_CloseMultiBitmap(fiMultiBitmap);
+						fiMultiBitmap = nullptr;
+					}
 				}
 			}
 			
 			if (fiBitmap != nullptr)
 			{
-				//loaded. convert to 32bit if necessary
-				if (FreeImage_GetBPP(fiBitmap) != 32)
-				{
-					FIBITMAP * fiConverted = FreeImage_ConvertTo32Bits(fiBitmap);
-					if (fiConverted != nullptr)
-					{
-						//free original bitmap data
-						if (fiMultiBitmap != nullptr)
-						{
-							FreeImage_UnlockPage(fiMultiBitmap, fiBitmap, false);
-							FreeImage_CloseMultiBitmap(fiMultiBitmap);
-							fiMultiBitmap = nullptr;
-						}
-						else
-							FreeImage_Unload(fiBitmap);
-
-						fiBitmap = fiConverted;
-					}
-				}
+				unsigned char* tempData = convertBitmapToRGBA32(fiBitmap, width, height, maxSize, baseSize, packedSize);
 
-				if (fiBitmap != nullptr)
+				if (fiMultiBitmap)
 				{
-					width = FreeImage_GetWidth(fiBitmap);
-					height = FreeImage_GetHeight(fiBitmap);
-
-					if (baseSize != nullptr)
-						*baseSize = Vector2i(width, height);
-
-					if (maxSize != nullptr && maxSize->x() > 0 && maxSize->y() > 0 && (width > maxSize->x() || height > maxSize->y()))
-					{
-						Vector2i sz = adjustPictureSize(Vector2i(width, height), Vector2i(maxSize->x(), maxSize->y()), maxSize->externalZoom());
-
-						if (sz.x() > Renderer::getScreenWidth() || sz.y() > Renderer::getScreenHeight())
-							sz = adjustPictureSize(sz, Vector2i(Renderer::getScreenWidth(), Renderer::getScreenHeight()), false);
-						
-						if (sz.x() != width || sz.y() != height)
-						{
-							LOG(LogDebug) << "ImageIO : rescaling image from " << std::string(std::to_string(width) + "x" + std::to_string(height)).c_str() << " to " << std::string(std::to_string(sz.x()) + "x" + std::to_string(sz.y())).c_str();
-
-							FIBITMAP* imageRescaled = FreeImage_Rescale(fiBitmap, sz.x(), sz.y(), FILTER_BOX);
-
-							if (fiMultiBitmap != nullptr)
-							{
-								FreeImage_UnlockPage(fiMultiBitmap, fiBitmap, false);
-								FreeImage_CloseMultiBitmap(fiMultiBitmap);
-								fiMultiBitmap = nullptr;
-							}
-							else
-								FreeImage_Unload(fiBitmap);
-
-							fiBitmap = imageRescaled;
-
-							width = FreeImage_GetWidth(fiBitmap);
-							height = FreeImage_GetHeight(fiBitmap);
-
-							if (packedSize != nullptr)
-								*packedSize = Vector2i(width, height);
-						}
-					}
-
-					unsigned char* tempData = new unsigned char[width * height * 4];
-
-					int w = (int)width;
-
-					for (int y = (int)height; --y >= 0; )
-					{
-						unsigned int* argb = (unsigned int*)FreeImage_GetScanLine(fiBitmap, y);
-						unsigned int* abgr = (unsigned int*)(tempData + (y * width * 4));
-						for (int x = w; --x >= 0;)
-						{
-							unsigned int c = argb[x];
-							abgr[x] = (c & 0xFF00FF00) | ((c & 0xFF) << 16) | ((c >> 16) & 0xFF);
-						}
-					}
-
-					if (fiMultiBitmap)
-					{
-						FreeImage_UnlockPage(fiMultiBitmap, fiBitmap, false);
-						FreeImage_CloseMultiBitmap(fiMultiBitmap);
-					}
-					else
-						FreeImage_Unload(fiBitmap);
+					FreeImage_UnlockPage(fiMultiBitmap, fiBitmap, false);
+					FreeImage_CloseMultiBitmap(fiMultiBitmap);
+				}
+				else
+					FreeImage_Unload(fiBitmap);
 
-					FreeImage_CloseMemory(fiMemory);
+				FreeImage_CloseMemory(fiMemory);
 
-					return tempData;
-				}
+				return tempData;
 			}
 			else
 			{
@@ -157,6 +238,53 @@ unsigned char* ImageIO::loadFromMemoryRGBA32(const unsigned char * data, const s
 	return nullptr;
 }
 
+int ImageIO::loadFramesFromMemoryRGBA32(const unsigned char * data, const size_t size, MaxSizeInfo* maxSize, const std::function<bool(int, unsigned char*, size_t, size_t, const Vector2i&, const Vector2i&)>& onFrame)
+{
+	LOG(LogDebug) << "ImageIO::loadFramesFromMemoryRGBA32";
+
+	int count = 0;
+
+	FIMEMORY * fiMemory = FreeImage_OpenMemory((BYTE *)data, (DWORD)size);
+	if (fiMemory == nullptr)
+		return 0;
+
+	FREE_IMAGE_FORMAT format = FreeImage_GetFileTypeFromMemory(fiMemory);
+	if (format != FIF_UNKNOWN && FreeImage_FIFSupportsReading(format))
+	{
+		// The multibitmap is opened once for all the frames, GIF_PLAYBACK composes each page over the previous ones
+		FIMULTIBITMAP* fiMultiBitmap = FreeImage_LoadMultiBitmapFromMemory(format, fiMemory, GIF_PLAYBACK);
+		if (fiMultiBitmap != nullptr)
+		{
+			int pageCount = FreeImage_GetPageCount(fiMultiBitmap);
+
+			for (int i = 0; i < pageCount; i++)
+			{
+				FIBITMAP* fiBitmap = FreeImage_LockPage(fiMultiBitmap, i);
+				if (fiBitmap == nullptr)
+					break;
+
+				size_t width, height;
+				Vector2i baseSize(0, 0);
+				Vector2i packedSize(0, 0);
+
+				unsigned char* tempData = convertBitmapToRGBA32(fiBitmap, width, height, maxSize, &baseSize, &packedSize);
+				FreeImage_UnlockPage(fiMultiBitmap, fiBitmap, false);
+
+				count++;
+
+				// The callback takes the ownership of the buffer
+				if (!onFrame(i, tempData, width, height, baseSize, packedSize))
+					break;
+			}
+
+			FreeImage_CloseMultiBitmap(fiMultiBitmap);
+		}
+	}
+
+	FreeImage_CloseMemory(fiMemory);
+	return count;
+}
+
 void ImageIO::flipPixelsVert(unsigned char* imagePx, const size_t& width, const size_t& height)
 {
 	unsigned int temp;
@@ -255,32 +383,150 @@ struct CachedFileInfo
 	int y;	
 };
 
-static std::map<std::string, CachedFileInfo> sizeCache;
-static bool sizeCacheDirty = false;
+// Binary image size cache ( imagecache.bin ) :
+//   header  : "ESIC" + version
+//   records : pathLength, size, x, y (int32) + path ( relative to the root path )
+// Records are appended as images are measured, a record with a negative size removes the entry.
+// The file is compacted at exit when it contains too many dead records.
+
+#define IMAGECACHE_MAGIC			"ESIC"
+#define IMAGECACHE_VERSION			1
+#define IMAGECACHE_FLUSH_COUNT		256
+
+struct CachedFileRecord
+{
+	int32_t pathLength;
+	int32_t size;
+	int32_t x;
+	int32_t y;
+};
+
+static std::unordered_map<std::string, CachedFileInfo> sizeCache;
+static std::shared_timed_mutex sizeCacheLock;
+
+static std::vector<char> sizeCachePending;	// Records not written yet
+static int sizeCachePendingCount = 0;
+static int sizeCacheFileRecords = 0;		// Records in the file, including dead ones
+static bool sizeCacheRewrite = false;		// The file must be rewritten from scratch
+
+static std::mutex sizeCacheFileLock;
 
 std::string getImageCacheFilename()
+{
+	return Paths::getUserEmulationStationPath() + "/imagecache.bin";
+}
+
+static std::string getLegacyImageCacheFilename()
 {
 	return Paths::getUserEmulationStationPath() + "/imagecache.db";
 }
 
-void ImageIO::clearImageCache()
+static bool _isCachablePath(const std::string& path)
 {
-	std::string fname = getImageCacheFilename();
-	Utils::FileSystem::removeFile(fname);
-	sizeCache.clear();
+	return 
+		path.find("/themes/") == std::string::npos && 
+		path.find("/tmp/") == std::string::npos &&
+		path.find("/emulationstation.tmp/") == std::string::npos &&
+		path.find("/pdftmp/") == std::string::npos && 
+		path.find("/saves/") == std::string::npos;
 }
 
-void ImageIO::loadImageCache()
+// genericRoot is getGenericPath(relativeTo), computed once by the caller
+static std::string _resolveCachePath(const std::string& path, const std::string& relativeTo, const std::string& genericRoot)
 {
+	// Fast path for the paths created by createRelativePath, avoids normalizing each path
+	if (path.size() > 3 && path[0] == '.' && path[1] == '/' && path[2] != '.' && path[2] != '/')
+		return genericRoot + path.substr(1);
+
+	return Utils::FileSystem::resolveRelativePath(path, relativeTo, true);
+}
+
+static void _appendRecord(std::vector<char>& buffer, const std::string& path, int sz, int x, int y)
+{
+	CachedFileRecord record;
+	record.pathLength = (int32_t)path.size();
+	record.size = sz;
+	record.x = x;
+	record.y = y;
+
+	buffer.insert(buffer.end(), (const char*)&record, (const char*)&record + sizeof(CachedFileRecord));
+	buffer.insert(buffer.end(), path.cbegin(), path.cend());
+}
+
+// Writes the pending records at the end of the file. sizeCacheLock must NOT be held
+static void _flushImageCache()
+{
+	std::unique_lock<std::mutex> fileLock(sizeCacheFileLock);
+
+	std::vector<char> pending;
+	int pendingCount;
+
+	{
+		std::unique_lock<std::shared_timed_mutex> lock(sizeCacheLock);
+		if (sizeCacheRewrite || sizeCachePendingCount == 0)
+			return;
+
+		pending.swap(sizeCachePending);
+		pendingCount = sizeCachePendingCount;
+		sizeCachePendingCount = 0;
+	}
+
 	std::string fname = getImageCacheFilename();
+	bool exists = Utils::FileSystem::exists(fname);
 
-	std::ifstream f(fname.c_str());
+	std::ofstream f(WINSTRINGW(fname), std::ios::binary | std::ios::app);
 	if (f.fail())
 		return;
 
+	if (!exists)
+	{
+		int32_t version = IMAGECACHE_VERSION;
+		f.write(IMAGECACHE_MAGIC, 4);
+		f.write((const char*)&version, sizeof(int32_t));
+	}
+
+	f.write(pending.data(), pending.size());
+	f.close();
+
+	std::unique_lock<std::shared_timed_mutex> lock(sizeCacheLock);
+	sizeCacheFileRecords += pendingCount;
+}
+
+// Adds a record to the pending list. sizeCacheLock must be held
+static bool _queueRecord(const std::string& fn, int sz, int x, int y)
+{
+	if (!_isCachablePath(fn))
+		return false;
+
+	_appendRecord(sizeCachePending, Utils::FileSystem::createRelativePath(fn, Paths::getRootPath(), true), sz, x, y);
+	sizeCachePendingCount++;
+
+	return sizeCachePendingCount >= IMAGECACHE_FLUSH_COUNT;
+}
+
+void ImageIO::clearImageCache()
+{
+	std::unique_lock<std::mutex> fileLock(sizeCacheFileLock);
+	std::unique_lock<std::shared_timed_mutex> lock(sizeCacheLock);
+
+	Utils::FileSystem::removeFile(getImageCacheFilename());
+	Utils::FileSystem::removeFile(getLegacyImageCacheFilename());
 	sizeCache.clear();
+	sizeCachePending.clear();
+	sizeCachePendingCount = 0;
+	sizeCacheFileRecords = 0;
+	sizeCacheRewrite = false;
+}
+
+// Imports the text cache used by previous versions ( path|size|x|y lines )
+static void _loadLegacyImageCache(const std::string& fname)
+{
+	std::ifstream f(WINSTRINGW(fname));
+	if (f.fail())
+		return;
 
 	std::string relativeTo = Paths::getRootPath();
+	std::string genericRoot = Utils::FileSystem::getGenericPath(relativeTo);
 
 	std::vector<std::string> splits;
 
@@ -304,7 +550,7 @@ void ImageIO::loadImageCache()
 
 		if (splits.size() == 4)
 		{
-			std::string file = Utils::FileSystem::resolveRelativePath(splits[0], relativeTo, true);
+			std::string file = _resolveCachePath(splits[0], relativeTo, genericRoot);
 
 			CachedFileInfo fi;
 			fi.size = Utils::String::toInteger(splits[1]);
@@ -316,97 +562,275 @@ void ImageIO::loadImageCache()
 	}
 
 	f.close();
-}
 
-static bool _isCachablePath(const std::string& path)
-{
-	return 
-		path.find("/themes/") == std::string::npos && 
-		path.find("/tmp/") == std::string::npos &&
-		path.find("/emulationstation.tmp/") == std::string::npos &&
-		path.find("/pdftmp/") == std::string::npos && 
-		path.find("/saves/") == std::string::npos;
+	sizeCacheRewrite = true;
 }
 
-void ImageIO::saveImageCache()
+// Reads the binary cache file, walking its records in memory
+static void _readImageCache(const std::string& fname)
 {
-	if (!sizeCacheDirty)
-		return;
+	const char* data = nullptr;
+	size_t length = 0;
 
-	std::string fname = getImageCacheFilename();
-	std::ofstream f(fname.c_str(), std::ios::binary);
+#if defined(_WIN32)
+	// No mapping here : the file is read once
+	std::ifstream f(WINSTRINGW(fname), std::ios::binary | std::ios::ate);
 	if (f.fail())
 		return;
 
+	std::streamsize fileLength = f.tellg();
+	f.seekg(0, std::ios::beg);
+
+	std::vector<char> buffer(fileLength > 0 ? (size_t)fileLength : 0);
+	if (fileLength <= 0 || !f.read(buffer.data(), fileLength))
+		return;
+
+	f.close();
+
+	data = buffer.data();
+	length = buffer.size();
+#else
+	int fd = ::open(fname.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size <= 0)
+	{
+		close(fd);
+		return;
+	}
+
+	void* mapping = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (mapping == MAP_FAILED)
+		return;
+
+	data = (const char*)mapping;
+	length = (size_t)info.st_size;
+#endif
+
+	int32_t version = 0;
+	if (length < 8 || memcmp(data, IMAGECACHE_MAGIC, 4) != 0 || (memcpy(&version, data + 4, sizeof(int32_t)), version) != IMAGECACHE_VERSION)
+		sizeCacheRewrite = true;
+	else
+	{
+		std::string relativeTo = Paths::getRootPath();
+		std::string genericRoot = Utils::FileSystem::getGenericPath(relativeTo);
+		sizeCache.reserve(length / (sizeof(CachedFileRecord) + 48));
+
+		const char* ptr = data + 8;
+		const char* end = data + length;
+
+		while (ptr + sizeof(CachedFileRecord) <= end)
+		{
+			CachedFileRecord record;
+			memcpy(&record, ptr, sizeof(CachedFileRecord));
+			ptr += sizeof(CachedFileRecord);
+
+			if (record.pathLength <= 0 || ptr + record.pathLength > end)
+			{
+				// Truncated record ( crash while writing ? ) : keep what was read and rewrite a clean file
+				sizeCacheRewrite = true;
+				break;
+			}
+
+			std::string file = _resolveCachePath(std::string(ptr, record.pathLength), relativeTo, genericRoot);
+			ptr += record.pathLength;
+
+			if (record.size < 0)
+				sizeCache.erase(file);
+			else
+				sizeCache[file] = CachedFileInfo(record.size, record.x, record.y);
+
+			sizeCacheFileRecords++;
+		}
+	}
+
+#if !defined(_WIN32)
+	munmap((void*)data, length);
+#endif
+}
+
+// Writes the whole cache to a new file, through a temporary file. sizeCacheFileLock & sizeCacheLock must be held
+static void _rewriteImageCache()
+{
 	std::string relativeTo = Paths::getRootPath();
 
-	for (auto it : sizeCache)
+	int32_t version = IMAGECACHE_VERSION;
+
+	std::vector<char> buffer;
+	buffer.insert(buffer.end(), IMAGECACHE_MAGIC, IMAGECACHE_MAGIC + 4);
+	buffer.insert(buffer.end(), (const char*)&version, (const char*)&version + sizeof(int32_t));
+
+	int records = 0;
+
+	for (auto& it : sizeCache)
 	{
-		if (it.second.size < 0)
+		if (it.second.size <= 0 || it.second.x <= 0)
 			continue;
 
 		if (!_isCachablePath(it.first))
 			continue;
 
-		std::string path = Utils::FileSystem::createRelativePath(it.first, relativeTo, true); 
-
-		f << path;
-		f << "|";
-		f << std::to_string(it.second.size);
-		f << "|";
-		f << std::to_string(it.second.x);
-		f << "|";
-		f << std::to_string(it.second.y);
-		f << "\n";
+		_appendRecord(buffer, Utils::FileSystem::createRelativePath(it.first, relativeTo, true), it.second.size, it.second.x, it.second.y);
+		records++;
 	}
 
+	std::string fname = getImageCacheFilename();
+	std::string tmpName = fname + ".tmp";
+
+	std::ofstream f(WINSTRINGW(tmpName), std::ios::binary);
+	if (f.fail())
+		return;
+
+	f.write(buffer.data(), buffer.size());
 	f.close();
+
+	if (Utils::FileSystem::renameFile(tmpName, fname))
+	{
+		Utils::FileSystem::removeFile(getLegacyImageCacheFilename());
+
+		sizeCachePending.clear();
+		sizeCachePendingCount = 0;
+		sizeCacheFileRecords = records;
+		sizeCacheRewrite = false;
+	}
 }
 
-static std::mutex sizeCacheLock;
+void ImageIO::loadImageCache()
+{
+	StopWatch stopWatch("ImageIO::loadImageCache :", LogDebug);
 
-void ImageIO::removeImageCache(const std::string& fn)
+	std::unique_lock<std::mutex> fileLock(sizeCacheFileLock);
+	std::unique_lock<std::shared_timed_mutex> lock(sizeCacheLock);
+
+	sizeCache.clear();
+	sizeCacheFileRecords = 0;
+
+	std::string fname = getImageCacheFilename();
+	if (Utils::FileSystem::exists(fname))
+		_readImageCache(fname);
+	else
+	{
+		std::string legacy = getLegacyImageCacheFilename();
+		if (Utils::FileSystem::exists(legacy))
+			_loadLegacyImageCache(legacy);
+	}
+
+	// An imported or damaged file is replaced right away : the records of the session are appended to a clean file
+	if (sizeCacheRewrite)
+		_rewriteImageCache();
+}
+
+void ImageIO::saveImageCache()
+{
+	StopWatch stopWatch("ImageIO::saveImageCache :", LogDebug);
+
+	bool rewrite = false;
+
+	{
+		std::unique_lock<std::shared_timed_mutex> lock(sizeCacheLock);
+
+		// Compact the file when more than half of its records are dead
+		rewrite = sizeCacheRewrite || (sizeCacheFileRecords > 1024 && sizeCacheFileRecords > 2 * (int)sizeCache.size());
+		if (!rewrite && sizeCachePendingCount == 0)
+			return;
+	}
+
+	if (!rewrite)
+	{
+		_flushImageCache();
+		return;
+	}
+
+	std::unique_lock<std::mutex> fileLock(sizeCacheFileLock);
+	std::unique_lock<std::shared_timed_mutex> lock(sizeCacheLock);
+
+	_rewriteImageCache();
+}
+
+// The file size recorded with the dimensions. The entry is trusted like loadImageSize does, without checking the file
+bool ImageIO::getImageCacheFileSize(const std::string& fn, int& sz)
 {
-	std::unique_lock<std::mutex> lock(sizeCacheLock);
+	std::shared_lock<std::shared_timed_mutex> lock(sizeCacheLock);
 
 	auto it = sizeCache.find(fn);
-	if (it != sizeCache.cend())
-		sizeCache.erase(fn);
+	if (it == sizeCache.cend() || it->second.size <= 0 || it->second.x <= 0)
+		return false;
+
+	sz = it->second.size;
+	return true;
+}
+
+void ImageIO::removeImageCache(const std::string& fn)
+{
+	bool flush = false;
+
+	{
+		std::unique_lock<std::shared_timed_mutex> lock(sizeCacheLock);
+
+		auto it = sizeCache.find(fn);
+		if (it == sizeCache.cend())
+			return;
+
+		bool persisted = it->second.size > 0 && it->second.x > 0;
+		sizeCache.erase(it);
+
+		if (persisted)
+			flush = _queueRecord(fn, -1, 0, 0);
+	}
+
+	if (flush)
+		_flushImageCache();
 }
 
 void ImageIO::updateImageCache(const std::string& fn, int sz, int x, int y)
 {
-	std::unique_lock<std::mutex> lock(sizeCacheLock);
+	bool flush = false;
 
-	auto it = sizeCache.find(fn);
-	if (it != sizeCache.cend())
 	{
-		if (x != it->second.x || y != it->second.y || sz != it->second.size)
+		std::unique_lock<std::shared_timed_mutex> lock(sizeCacheLock);
+
+		auto it = sizeCache.find(fn);
+		if (it != sizeCache.cend())
 		{
-			auto& item = it->second;
+			if (x != it->second.x || y != it->second.y || sz != it->second.size)
+			{
+				auto& item = it->second;
+
+				bool persisted = item.size > 0 && item.x > 0;
 
-			item.x = x;
-			item.y = y;
-			item.size = sz;
+				item.x = x;
+				item.y = y;
+				item.size = sz;
 
-			if (sz > 0 && x > 0 && _isCachablePath(fn))
-				sizeCacheDirty = true;
+				if (sz > 0 && x > 0)
+					flush = _queueRecord(fn, sz, x, y);
+				else if (persisted)
+					flush = _queueRecord(fn, -1, 0, 0); // The entry is no longer valid : don't let the file bring back the old size
+			}
 		}
-	}
-	else
-	{
-		sizeCache[fn] = CachedFileInfo(sz, x, y);
+		else
+		{
+			sizeCache[fn] = CachedFileInfo(sz, x, y);
 
-		if (sz > 0 && x > 0 && _isCachablePath(fn))
-			sizeCacheDirty = true;
+			if (sz > 0 && x > 0)
+				flush = _queueRecord(fn, sz, x, y);
+		}
 	}
+
+	// Persist regularly, so a crash doesn't lose the whole session
+	if (flush)
+		_flushImageCache();
 }
 
 
 bool ImageIO::loadImageSize(const std::string& fn, unsigned int *x, unsigned int *y)
 {
 	{
-		std::unique_lock<std::mutex> lock(sizeCacheLock);
+		std::shared_lock<std::shared_timed_mutex> lock(sizeCacheLock);
 
 		auto it = sizeCache.find(fn);
 		if (it != sizeCache.cend())
@@ -530,11 +954,55 @@ bool ImageIO::loadImageSize(const std::string& fn, unsigned int *x, unsigned int
 	return false;
 }
 
+struct MultiBitmapInformation
+{
+	std::string stamp;
+	int totalFrames;
+	int frameTime;
+	bool result;
+};
+
+static std::mutex mMultiBitmapInfoLock;
+static std::unordered_map<std::string, MultiBitmapInformation> mMultiBitmapInfos;
+
+#define MULTIBITMAP_INFO_CACHE_SIZE 512
+
 bool ImageIO::getMultiBitmapInformation(const std::string& path, int& totalFrames, int& frameTime)
 {	
 	totalFrames = 1;
 	frameTime = 0;
 
+	// Images are revisited each time the user comes back to a game : the file is only parsed again when it changed
+	std::string stamp = std::to_string(Utils::FileSystem::getFileModificationDate(path).getTime()) + "-" + std::to_string(Utils::FileSystem::getFileSize(path));
+
+	{
+		std::unique_lock<std::mutex> lock(mMultiBitmapInfoLock);
+
+		auto it = mMultiBitmapInfos.find(path);
+		if (it != mMultiBitmapInfos.cend() && it->second.stamp == stamp)
+		{
+			totalFrames = it->second.totalFrames;
+			frameTime = it->second.frameTime;
+			return it->second.result;
+		}
+	}
+
+	bool result = readMultiBitmapInformation(path, totalFrames, frameTime);
+
+	std::unique_lock<std::mutex> lock(mMultiBitmapInfoLock);
+
+	if (mMultiBitmapInfos.size() >= MULTIBITMAP_INFO_CACHE_SIZE)
+		mMultiBitmapInfos.clear();
+
+	mMultiBitmapInfos[path] = { stamp, totalFrames, frameTime, result };
+	return result;
+}
+
+bool ImageIO::readMultiBitmapInformation(const std::string& path, int& totalFrames, int& frameTime)
+{
+	totalFrames = 1;
+	frameTime = 0;
+
 	FREE_IMAGE_FORMAT fileFormat;
 
 #if WIN32
@@ -3,7 +3,9 @@
 #define ES_CORE_IMAGE_IO
 
 #include <stdlib.h>
+#include <string>
 #include <vector>
+#include <functional>
 #include "math/Vector2f.h"
 #include "math/Vector2i.h"
 
@@ -44,6 +46,9 @@ class ImageIO
 {
 public:
 	static unsigned char*  loadFromMemoryRGBA32(const unsigned char * data, const size_t size, size_t & width, size_t & height, MaxSizeInfo* maxSize = nullptr, Vector2i* baseSize = nullptr, Vector2i* packedSize = nullptr, int subImageIndex = -1);
+
+	// Decodes all the frames of an animated image in a single pass. onFrame receives each RGBA frame it must delete[], and returns false to stop decoding
+	static int			  loadFramesFromMemoryRGBA32(const unsigned char * data, const size_t size, MaxSizeInfo* maxSize, const std::function<bool(int index, unsigned char* dataRGBA, size_t width, size_t height, const Vector2i& baseSize, const Vector2i& packedSize)>& onFrame);
 	static void flipPixelsVert(unsigned char* imagePx, const size_t& width, const size_t& height);
 	
 	static Vector2f getPictureMinSize(Vector2f imageSize, Vector2f maxSize);
@@ -51,12 +56,16 @@ public:
 	static bool		loadImageSize(const std::string& fn, unsigned int *x, unsigned int *y);
 
 	static void		removeImageCache(const std::string& fn);
+	static bool		getImageCacheFileSize(const std::string& fn, int& sz);
 	static void		updateImageCache(const std::string& fn, int sz, int x, int y);
 	static void		loadImageCache();
 	static void		saveImageCache();
 	static void		clearImageCache();
 
 	static bool		getMultiBitmapInformation(const std::string& path, int& totalFrames, int& frameTime);
+
+private:
+	static bool		readMultiBitmapInformation(const std::string& path, int& totalFrames, int& frameTime);
 };
 
 #endif // ES_CORE_IMAGE_IO
@@ -4,8 +4,12 @@
 #include "platform.h"
 #include <iostream>
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <time.h>
 #include "Settings.h"
-#include <iomanip> 
 #include <SDL_timer.h>
 #include "Paths.h"
 
@@ -13,11 +17,112 @@
 #include <Windows.h>
 #endif
 
-static std::mutex mLogLock;
+#define LOG_QUEUE_SIZE			4096	// Must be a power of two
+#define LOG_WRITE_INTERVAL		50		// ms
+#define LOG_MAX_FILE_SIZE		(16 * 1024 * 1024)
+#define LOG_ROTATED_SUFFIX		".1"	// The .bak file keeps the previous session, attached to crash reports : rotation doesn't touch it
+
+// Bounded lock-free queue of formatted log lines. Any thread can push, the lines are popped by the writer under mWriteLock.
+// Each slot carries a sequence number telling whether it is free for the producer at this position, or ready for the consumer.
+class LogQueue
+{
+public:
+	LogQueue() : mHead(0), mTail(0)
+	{
+		for (size_t i = 0; i < LOG_QUEUE_SIZE; i++)
+			mSlots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	// Returns false when the queue is full : producers never wait for the writer
+	bool push(std::string& text, LogLevel level)
+	{
+		size_t pos = mTail.load(std::memory_order_relaxed);
+
+		while (true)
+		{
+			Slot& slot = mSlots[pos & (LOG_QUEUE_SIZE - 1)];
+			size_t sequence = slot.sequence.load(std::memory_order_acquire);
+			intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+
+			if (diff == 0)
+			{
+				if (mTail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					slot.text.swap(text);
+					slot.level = level;
+					slot.sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+				return false;
+			else
+				pos = mTail.load(std::memory_order_relaxed);
+		}
+	}
+
+	// Single consumer
+	bool pop(std::string& text, LogLevel& level)
+	{
+		size_t pos = mHead.load(std::memory_order_relaxed);
+
+		Slot& slot = mSlots[pos & (LOG_QUEUE_SIZE - 1)];
+		if ((intptr_t)slot.sequence.load(std::memory_order_acquire) - (intptr_t)(pos + 1) < 0)
+			return false;
+
+		text.swap(slot.text);
+		slot.text.clear();
+		level = slot.level;
+
+		mHead.store(pos + 1, std::memory_order_relaxed);
+		slot.sequence.store(pos + LOG_QUEUE_SIZE, std::memory_order_release);
+		return true;
+	}
+
+	size_t size()
+	{
+		return mTail.load(std::memory_order_relaxed) - mHead.load(std::memory_order_relaxed);
+	}
+
+private:
+	struct Slot
+	{
+		std::atomic<size_t> sequence;
+		std::string			text;
+		LogLevel			level;
+	};
+
+	Slot				mSlots[LOG_QUEUE_SIZE];
+	std::atomic<size_t> mHead;
+	std::atomic<size_t> mTail;
+};
+
+static LogQueue					sQueue;
+static std::atomic<int>			sDropped(0);
+
+static std::mutex				mLogLock;	// Held while writing to the file
+static FILE*					sFile = NULL;
+static std::string				sLogPath;
+static size_t					sFileSize = 0;
+
+static std::mutex				sWriterLock;
+static std::condition_variable	sWriterEvent;
+static std::thread				sWriterThread;
+static bool						sWriterRunning = false;
+static std::atomic<bool>		sWriterActive(false);	// Lines are queued only while the writer runs
+static std::atomic<bool>		sCrashing(false);
 
 LogLevel Log::mReportingLevel = (LogLevel) -1;
-bool     Log::mDirty          = false;
-FILE*    Log::mFile           = NULL;
+bool     Log::mEnabled        = false;
+
+static void printToConsole(const std::string& text)
+{
+#if WIN32
+	OutputDebugStringA(text.c_str());
+#else
+	fprintf(stderr, "%s", text.c_str());
+#endif
+}
 
 void Log::init()
 {		
@@ -55,21 +160,47 @@ void Log::init()
 	
 	Utils::FileSystem::removeFile(bakPath);
 	Utils::FileSystem::renameFile(logPath, bakPath);
+	Utils::FileSystem::removeFile(logPath + LOG_ROTATED_SUFFIX);
 
-	bool locked = mLogLock.try_lock();
+	{
+		std::unique_lock<std::mutex> lock(mLogLock);
 
-	mFile = fopen(logPath.c_str(), "w");
-	mDirty = false;
-	mReportingLevel = lvl;
+		sLogPath = logPath;
+		sFileSize = 0;
+		sFile = fopen(logPath.c_str(), "w");
+		if (sFile == NULL)
+			return;
 
-	if (locked)
-		mLogLock.unlock();
+		mEnabled = true;
+		mReportingLevel = lvl;
+	}
+
+	std::unique_lock<std::mutex> lock(sWriterLock);
+	sWriterRunning = true;
+	sWriterThread = std::thread(&Log::writerThread);
+	sWriterActive = true;
 }
 
 std::ostringstream& Log::get(LogLevel level)
 {
+	// The timestamp only changes once per second : each thread keeps its last formatting
+	static thread_local time_t lastTime = 0;
+	static thread_local char timeStamp[32] = { 0 };
+
 	time_t t = time(nullptr);
-	mStream << std::put_time(localtime(&t), "%F %T\t");
+	if (t != lastTime)
+	{
+		struct tm tmTime;
+#if WIN32
+		localtime_s(&tmTime, &t);
+#else
+		localtime_r(&t, &tmTime);
+#endif
+		strftime(timeStamp, sizeof(timeStamp), "%F %T\t", &tmTime);
+		lastTime = t;
+	}
+
+	mStream << timeStamp;
 
 	switch (level)
 	{
@@ -92,62 +223,206 @@ std::ostringstream& Log::get(LogLevel level)
 	return mStream;
 }
 
-void Log::flush()
+// mLogLock must be locked by the caller. Writes the queued lines in a single batch, and rotates the file when it gets too large
+void Log::writeQueue()
 {
-	if (!mDirty)
+	std::string batch;
+	std::string text;
+	LogLevel level;
+
+	while (sQueue.pop(text, level))
+	{
+		batch += text;
+
+		if (level == LogError || mReportingLevel >= LogDebug)
+			printToConsole(text);
+	}
+
+	int dropped = sDropped.exchange(0);
+	if (dropped > 0)
+		batch += "WARNING\t" + std::to_string(dropped) + " log lines were dropped\n";
+
+	if (batch.empty() || sFile == NULL)
 		return;
 
-	if (mLogLock.try_lock())
+	if (sFileSize + batch.size() > LOG_MAX_FILE_SIZE)
 	{
-		if (mFile != nullptr)
-			fflush(mFile);
+		auto rotatedPath = sLogPath + LOG_ROTATED_SUFFIX;
 
-		mDirty = false;
-		mLogLock.unlock();
+		fclose(sFile);
+		Utils::FileSystem::removeFile(rotatedPath);
+		Utils::FileSystem::renameFile(sLogPath, rotatedPath);
+
+		sFile = fopen(sLogPath.c_str(), "w");
+		sFileSize = 0;
+
+		if (sFile == NULL)
+			return;
 	}
+
+	fwrite(batch.c_str(), 1, batch.size(), sFile);
+	fflush(sFile);
+
+	sFileSize += batch.size();
 }
 
-void Log::close()
+void Log::writerThread()
 {
-	bool locked = mLogLock.try_lock();
+	std::unique_lock<std::mutex> lock(sWriterLock);
 
-	if (mFile != NULL)
+	while (sWriterRunning)
 	{
-		fflush(mFile);
-		fclose(mFile);
-		mFile = NULL;
+		// Lines are written by batches, or as soon as the queue fills up
+		sWriterEvent.wait_for(lock, std::chrono::milliseconds(LOG_WRITE_INTERVAL), [] { return !sWriterRunning || sQueue.size() > LOG_QUEUE_SIZE / 2; });
+
+		lock.unlock();
+
+		{
+			std::unique_lock<std::mutex> logLock(mLogLock);
+			writeQueue();
+		}
+
+		lock.lock();
 	}
+}
+
+void Log::flush()
+{
+	std::unique_lock<std::mutex> lock(mLogLock);
+	writeQueue();
+}
+
+void Log::close(bool crashing)
+{
+	// Closed by the crash handler : the exit handlers must not wait for locks a crashed thread may hold
+	if (sCrashing)
+		return;
+
+	sCrashing = crashing;
+	sWriterActive = false;
+
+	if (crashing)
+	{
+		// The crash may have happened in the writer, or while a thread holds the locks : nothing is waited for
+		if (sWriterLock.try_lock())
+		{
+			sWriterRunning = false;
+			sWriterLock.unlock();
+		}
+
+		sWriterEvent.notify_one();
+
+		if (sWriterThread.joinable())
+			sWriterThread.detach();
+
+		if (!mLogLock.try_lock())
+			return;
+
+		mEnabled = false;
+
+		if (sFile != NULL)
+		{
+			writeQueue();
+
+			fclose(sFile);
+			sFile = NULL;
+		}
 
-	mDirty = false;
-	
-	if (locked)
 		mLogLock.unlock();
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(sWriterLock);
+		sWriterRunning = false;
+	}
+
+	sWriterEvent.notify_one();
+
+	if (sWriterThread.joinable())
+		sWriterThread.join();
+
+	std::unique_lock<std::mutex> lock(mLogLock);
+
+	mEnabled = false;
+
+	if (sFile != NULL)
+	{
+		writeQueue();
+
+		fclose(sFile);
+		sFile = NULL;
+	}
 }
 
 Log::~Log()
 {
-	bool locked = mLogLock.try_lock();
+	mStream << "\n";
+
+	std::string text = mStream.str();
+	LogLevel level = mMessageLevel;
 
-	if (mFile != NULL)
+	if (sCrashing)
+		return;
+
+	// Once the writer is stopped, nothing would write the queue anymore : lines are written by the caller
+	if (!sWriterActive)
 	{
-		mStream << std::endl;
-		fprintf(mFile, "%s", mStream.str().c_str());
-		mDirty = true;
+		std::unique_lock<std::mutex> lock(mLogLock);
+		writeQueue();
+
+		if (sFile != NULL)
+		{
+			fwrite(text.c_str(), 1, text.size(), sFile);
+			fflush(sFile);
+			sFileSize += text.size();
+		}
+
+		if (level == LogError || mReportingLevel >= LogDebug)
+			printToConsole(text);
+
+		return;
 	}
-	
-	// If it's an error, also print to console
-	// print all messages if using --debug
-	if (mMessageLevel == LogError || mReportingLevel >= LogDebug)
+
+	if (sQueue.push(text, level))
 	{
-#if WIN32
-		OutputDebugStringA(mStream.str().c_str());
-#else
-		fprintf(stderr, "%s", mStream.str().c_str());
-#endif
+		// close() may have stopped the writer & drained the queue since sWriterActive was read : don't leave the line in the queue
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (!sWriterActive)
+		{
+			if (sCrashing)
+				return;
+
+			std::unique_lock<std::mutex> lock(mLogLock);
+			writeQueue();
+			return;
+		}
+
+		// Wake the writer early when the queue fills up, or to get errors on disk before a possible crash
+		if (level == LogError || sQueue.size() > LOG_QUEUE_SIZE / 2)
+			sWriterEvent.notify_one();
+
+		return;
 	}
 
-	if (locked)
-		mLogLock.unlock();
+	// The writer is overwhelmed : errors are written by the caller, other lines are dropped & counted
+	if (level != LogError)
+	{
+		sDropped++;
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(mLogLock);
+	writeQueue();
+
+	if (sFile != NULL)
+	{
+		fwrite(text.c_str(), 1, text.size(), sFile);
+		fflush(sFile);
+		sFileSize += text.size();
+	}
+
+	printToConsole(text);
 }
 
 StopWatch::StopWatch(const std::string& elapsedMillisecondsMessage, LogLevel level)
@@ -20,16 +20,18 @@ public:
 	std::ostringstream& get(LogLevel level = LogInfo);
 
 	static inline LogLevel& getReportingLevel() { return mReportingLevel; }
-	static inline bool enabled() { return mFile != NULL; }
+	static inline bool enabled() { return mEnabled; }
 
 	static void init();
 	static void flush();
-	static void close();
+	static void close(bool crashing = false);
 	
 private:
+	static void writeQueue();
+	static void writerThread();
+
 	static LogLevel     mReportingLevel;
-	static bool         mDirty;
-	static FILE*        mFile;
+	static bool         mEnabled;
 
 protected:
 	std::ostringstream  mStream;
@@ -7,11 +7,17 @@
 #include <pugixml/src/pugixml.hpp>
 #include <algorithm>
 #include <vector>
+#include <mutex>
+#include <unordered_map>
 #include "utils/StringUtil.h"
 #include "Paths.h"
 
 Settings* Settings::sInstance = NULL;
+std::atomic<unsigned int> Settings::sGeneration(0);
 static std::string mEmptyString = "";
+
+static std::mutex mSettingIdsLock;
+static std::unordered_map<std::string, SettingId> mSettingIds;
 Delegate<ISettingsChangedEvent> Settings::settingChanged;
 
 IMPLEMENT_STATIC_BOOL_SETTING(DebugText, false)
@@ -55,10 +61,68 @@ void Settings::updateCachedSetting(const std::string& name)
 	UPDATE_STATIC_BOOL_SETTING(IgnoreLeadingArticles)		
 	UPDATE_STATIC_INT_SETTING(ScreenSaverTime)
 
+	{
+		std::unique_lock<std::mutex> lock(mSettingIdsLock);
+
+		auto it = mSettingIds.find(name);
+		if (it != mSettingIds.cend())
+			loadSettingValue(it->second, name);
+
+		sGeneration++;
+	}
+
 	if (mLoaded)
 		settingChanged.invoke([name](ISettingsChangedEvent* c) { c->onSettingChanged(name); });
 }
 
+SettingId Settings::getSettingId(const std::string& name)
+{
+	// Create the instance first : loading the settings updates the interned values
+	Settings* settings = getInstance();
+
+	std::unique_lock<std::mutex> lock(mSettingIdsLock);
+
+	auto it = mSettingIds.find(name);
+	if (it != mSettingIds.cend())
+		return it->second;
+
+	// Id 0 is never loaded
+	SettingId id = (SettingId)mSettingIds.size() + 1;
+	if (id >= SETTINGS_MAX_IDS)
+	{
+		LOG(LogError) << "Settings::getSettingId : too many setting ids, " << name << " won't be read";
+		return 0;
+	}
+
+	mSettingIds[name] = id;
+	settings->loadSettingValue(id, name);
+	return id;
+}
+
+std::string Settings::getString(SettingId id)
+{
+	std::unique_lock<std::mutex> lock(mSettingIdsLock);
+	return mValues[id].stringValue;
+}
+
+// mSettingIdsLock must be locked by the caller
+void Settings::loadSettingValue(SettingId id, const std::string& name)
+{
+	SettingValue& value = mValues[id];
+
+	auto bit = mBoolMap.find(name);
+	value.boolValue = bit == mBoolMap.cend() ? false : bit->second;
+
+	auto iit = mIntMap.find(name);
+	value.intValue = iit == mIntMap.cend() ? 0 : iit->second;
+
+	auto fit = mFloatMap.find(name);
+	value.floatValue = fit == mFloatMap.cend() ? 0.0f : fit->second;
+
+	auto sit = mStringMap.find(name);
+	value.stringValue = sit == mStringMap.cend() ? mEmptyString : sit->second;
+}
+
 // these values are NOT saved to es_settings.xml
 // since they're set through command-line arguments, and not the in-program settings menu
 std::vector<const char*> settings_dont_save {
@@ -94,6 +158,8 @@ std::vector<const char*> settings_dont_save {
 
 Settings::Settings() : mLoaded(false)
 {
+	mValues.resize(SETTINGS_MAX_IDS);
+
 	setDefaults();
 	loadFile();
 	mLoaded = true;
@@ -114,6 +180,7 @@ void Settings::setDefaults()
 	mIntMap.clear();
 	mBoolMap["BackgroundJoystickInput"] = false;
 	mBoolMap["ParseGamelistOnly"] = false;
+	mBoolMap["WatchRomFolders"] = false;
 	mBoolMap["ShowHiddenFiles"] = false;
 	mBoolMap["ShowParentFolder"] = true;
 	mBoolMap["IgnoreLeadingArticles"] = Settings::_IgnoreLeadingArticles;
@@ -211,6 +278,7 @@ void Settings::setDefaults()
 	mStringMap["GameTransitionStyle"] = "auto";
 
 	mStringMap["ThemeSet"] = "";
+	mBoolMap["CompiledThemeCache"] = true;
 	mStringMap["ScreenSaverBehavior"] = "dim";
 	mStringMap["GamelistViewStyle"] = "automatic";
 
@@ -220,6 +288,9 @@ void Settings::setDefaults()
 	mStringMap["ScrapperLogoSrc"] = "wheel";
 	mBoolMap["ScrapeVideos"] = false;
 	mBoolMap["ScrapeShortTitle"] = false;
+	mBoolMap["ScraperCache"] = false;
+	mIntMap["ScraperCacheTTL"] = 30; // days
+	mIntMap["ScraperCacheMaxSize"] = 512; // Mb
 	
 	mBoolMap["ScreenSaverMarquee"] = true;
 	mBoolMap["ScreenSaverControls"] = true;
@@ -315,6 +386,7 @@ void Settings::setDefaults()
 	mBoolMap["PreloadMedias"] = Settings::_PreloadMedias;
 	mBoolMap["OptimizeVRAM"] = true;
 	mBoolMap["OptimizeVideo"] = true;
+	mBoolMap["VideoPlanarYuv"] = true;
 
 	mBoolMap["ShowFilenames"] = false;
 
@@ -2,16 +2,21 @@
 #ifndef ES_CORE_SETTINGS_H
 #define ES_CORE_SETTINGS_H
 
+#include <atomic>
 #include <map>
 #include <string>
 #include <vector>
 #include "utils/Delegate.h"
 
-// Non-cached settings macros
-#define DEFINE_BOOL_SETTING(XX) static bool XX() { return Settings::getInstance()->getBool(#XX); }; static bool set##XX(bool val) { return Settings::getInstance()->setBool(#XX, val); };
-#define DEFINE_INT_SETTING(XX) static int XX() { return Settings::getInstance()->getInt(#XX); }; static bool set##XX(int val) { return Settings::getInstance()->setInt(#XX, val); };
-#define DEFINE_FLOAT_SETTING(XX) static float XX() { return Settings::getInstance()->getFloat(#XX); }; static bool set##XX(float val) { return Settings::getInstance()->setFloat(#XX, val); };
-#define DEFINE_STRING_SETTING(XX) static std::string XX() { return Settings::getInstance()->getString(#XX); }; static bool set##XX(const std::string& val) { return Settings::getInstance()->setString(#XX, val); };
+#define SETTINGS_MAX_IDS 1024
+
+typedef int SettingId;
+
+// Settings macros reading the values through interned ids
+#define DEFINE_BOOL_SETTING(XX) static bool XX() { static const SettingId id = Settings::getSettingId(#XX); return Settings::getInstance()->getBool(id); }; static bool set##XX(bool val) { return Settings::getInstance()->setBool(#XX, val); };
+#define DEFINE_INT_SETTING(XX) static int XX() { static const SettingId id = Settings::getSettingId(#XX); return Settings::getInstance()->getInt(id); }; static bool set##XX(int val) { return Settings::getInstance()->setInt(#XX, val); };
+#define DEFINE_FLOAT_SETTING(XX) static float XX() { static const SettingId id = Settings::getSettingId(#XX); return Settings::getInstance()->getFloat(id); }; static bool set##XX(float val) { return Settings::getInstance()->setFloat(#XX, val); };
+#define DEFINE_STRING_SETTING(XX) static std::string XX() { static const SettingId id = Settings::getSettingId(#XX); return Settings::getInstance()->getString(id); }; static bool set##XX(const std::string& val) { return Settings::getInstance()->setString(#XX, val); };
 
 // Cached static settings macros
 #define DECLARE_STATIC_BOOL_SETTING(XX) \
@@ -62,6 +67,18 @@ public:
 	bool setFloat(const std::string& name, float value);
 	bool setString(const std::string& name, const std::string& value);
 
+	// Setting names are interned once into ids, reading a value by id is an array access : for code reading settings in loops.
+	// The values are refreshed when the setting changes. Id 0 is returned when there are too many ids, and always reads the default values.
+	static SettingId getSettingId(const std::string& name);
+
+	bool getBool(SettingId id) { return mValues[id].boolValue; }
+	int getInt(SettingId id) { return mValues[id].intValue; }
+	float getFloat(SettingId id) { return mValues[id].floatValue; }
+	std::string getString(SettingId id); // A copy : the value may be refreshed by another thread
+
+	// Incremented each time a setting changes : values derived from settings can be cached and checked against it
+	static unsigned int getGeneration() { return sGeneration; }
+
 	std::map<std::string, std::string>& getStringMap() { return mStringMap; }
 
 	// Cached settings using static fields. They must be implemented using IMPLEMENT_STATIC_xx_SETTING & updated with UPDATE_STATIC_xxx_SETTING
@@ -95,6 +112,9 @@ public:
 	DEFINE_BOOL_SETTING(NetPlayCheckIndexesAtStart)
 	DEFINE_BOOL_SETTING(NetPlayShowMissingGames)			
 	DEFINE_BOOL_SETTING(LoadEmptySystems)		
+	DEFINE_BOOL_SETTING(ForceDisableFilters)
+	DEFINE_BOOL_SETTING(OptimizeVideo)
+	DEFINE_STRING_SETTING(ShowBattery)
 	DEFINE_STRING_SETTING(HiddenSystems)
 	DEFINE_STRING_SETTING(TransitionStyle)
 	DEFINE_STRING_SETTING(GameTransitionStyle)		
@@ -105,6 +125,7 @@ public:
 
 private:
 	static Settings* sInstance;
+	static std::atomic<unsigned int> sGeneration;
 
 	Settings();
 
@@ -125,6 +146,20 @@ private:
 
 	bool mLoaded;
 	void updateCachedSetting(const std::string& name);
+
+	struct SettingValue
+	{
+		SettingValue() : boolValue(false), intValue(0), floatValue(0.0f) { }
+
+		bool		boolValue;
+		int			intValue;
+		float		floatValue;
+		std::string stringValue;
+	};
+
+	void loadSettingValue(SettingId id, const std::string& name);
+
+	std::vector<SettingValue> mValues;
 };
 
 #endif // ES_CORE_SETTINGS_H
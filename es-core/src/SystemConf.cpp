@@ -13,10 +13,12 @@
 #include <iostream>
 #include <SDL_timer.h>
 
-static std::string mapSettingsName(const std::string& name)
+static const std::string& mapSettingsName(const std::string& name)
 {
+	static const std::string language = "Language";
+
 	if (name == "system.language")
-		return "Language";
+		return language;
 
 	return name;
 }
@@ -229,6 +231,14 @@ std::string SystemConf::get(const std::string &name)
 	if (mSystemConfFile.empty())
 		return Settings::getInstance()->getString(mapSettingsName(name));
 
+	return getValue(name);
+}
+
+// Reads the value in place, without copying it. Only valid when the values are read from mSystemConfFile
+const std::string& SystemConf::getValue(const std::string &name)
+{
+	static const std::string empty;
+
 	auto it = confMap.find(name);
 	if (it != confMap.cend())
 		return it->second;
@@ -237,7 +247,7 @@ std::string SystemConf::get(const std::string &name)
 	if (dit != defaults.cend())
 		return dit->second;
 
-    return "";
+	return empty;
 }
 
 bool SystemConf::set(const std::string &name, const std::string &value)
@@ -260,10 +270,12 @@ bool SystemConf::getBool(const std::string &name, bool defaultValue)
 	if (mSystemConfFile.empty())
 		return Settings::getInstance()->getBool(mapSettingsName(name));
 
+	const std::string& value = getValue(name);
+
 	if (defaultValue)
-		return get(name) != "0";
+		return value != "0";
 
-	return get(name) == "1";
+	return value == "1";
 }
 
 bool SystemConf::setBool(const std::string &name, bool value)
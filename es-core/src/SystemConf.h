@@ -24,6 +24,8 @@ public:
 
 private:
 	SystemConf();
+	const std::string& getValue(const std::string &name);
+
 	static SystemConf* sInstance;
 
 	std::map<std::string, std::string> confMap;
@@ -15,6 +15,11 @@
 #include "anim/ThemeStoryboard.h"
 #include "Paths.h"
 #include "utils/HtmlColor.h"
+#include "utils/md5.h"
+#include <fstream>
+#include <atomic>
+#include <list>
+#include <mutex>
 
 std::vector<std::string> ThemeData::sSupportedViews{ { "system" }, { "basic" }, { "detailed" }, { "grid" }, { "video" }, { "gamecarousel" }, { "menu" }, { "screen" }, { "splash" } };
 std::vector<std::string> ThemeData::sSupportedFeatures { { "video" }, { "carousel" }, { "gamecarousel" }, { "z-index" }, { "visible" },{ "manufacturer" } };
@@ -538,6 +543,104 @@ ThemeData* ThemeData::mDefaultTheme = nullptr;
 #define MINIMUM_THEME_FORMAT_VERSION 3
 #define CURRENT_THEME_FORMAT_VERSION 6
 
+#define THEME_DOCUMENT_CACHE_SIZE	(16 * 1024 * 1024)
+
+static std::string getThemeFileStamp(const std::string& path)
+{
+	return std::to_string(Utils::FileSystem::getFileModificationDate(path).getTime()) + "-" + std::to_string(Utils::FileSystem::getFileSize(path));
+}
+
+// Parsed theme files, shared by the ThemeData of every system.
+// All systems load the same theme.xml & includes and only differ by their variables : files are read & parsed once,
+// then each system evaluates the cached document against its own variables.
+// Cached documents are never modified, so they can be walked by the system loading threads concurrently.
+class ThemeDocumentCache
+{
+public:
+	static std::shared_ptr<const pugi::xml_document> getDocument(const std::string& path, pugi::xml_parse_result& result)
+	{
+		auto stamp = getThemeFileStamp(path);
+
+		{
+			std::unique_lock<std::mutex> lock(mLock);
+
+			auto it = mDocuments.find(path);
+			if (it != mDocuments.cend())
+			{
+				if (it->second.stamp == stamp)
+				{
+					mHits++;
+					mOrder.remove(path);
+					mOrder.push_back(path);
+					result = it->second.result;
+					return it->second.document;
+				}
+
+				mSize -= it->second.size;
+				mDocuments.erase(it);
+				mOrder.remove(path);
+			}
+		}
+
+		auto document = std::make_shared<pugi::xml_document>();
+		result = document->load_file(path.c_str());
+		
+		size_t size = (size_t)Utils::FileSystem::getFileSize(path);
+
+		std::unique_lock<std::mutex> lock(mLock);
+
+		mMisses++;
+
+		if (size < THEME_DOCUMENT_CACHE_SIZE && mDocuments.find(path) == mDocuments.cend())
+		{
+			mDocuments[path] = { stamp, size, result, document };
+			mOrder.push_back(path);
+			mSize += size;
+
+			while (mSize > THEME_DOCUMENT_CACHE_SIZE && mOrder.size() > 1)
+			{
+				auto oldest = mDocuments.find(mOrder.front());
+				mSize -= oldest->second.size;
+				mDocuments.erase(oldest);
+				mOrder.pop_front();
+			}
+		}
+
+		return document;
+	}
+
+	static std::string getStatistics()
+	{
+		std::unique_lock<std::mutex> lock(mLock);
+
+		return std::to_string(mDocuments.size()) + " documents (" + std::to_string(mSize / 1024) + " Kb of xml), " + 
+			std::to_string(mHits) + " hits, " + std::to_string(mMisses) + " parsed";
+	}
+
+private:
+	struct CachedDocument
+	{
+		std::string stamp;
+		size_t size;
+		pugi::xml_parse_result result;
+		std::shared_ptr<const pugi::xml_document> document;
+	};
+
+	static std::mutex mLock;
+	static std::map<std::string, CachedDocument> mDocuments;
+	static std::list<std::string> mOrder;
+	static size_t mSize;
+	static unsigned int mHits;
+	static unsigned int mMisses;
+};
+
+std::mutex ThemeDocumentCache::mLock;
+std::map<std::string, ThemeDocumentCache::CachedDocument> ThemeDocumentCache::mDocuments;
+std::list<std::string> ThemeDocumentCache::mOrder;
+size_t ThemeDocumentCache::mSize = 0;
+unsigned int ThemeDocumentCache::mHits = 0;
+unsigned int ThemeDocumentCache::mMisses = 0;
+
 
 std::string ThemeData::resolvePlaceholders(const char* in)
 {
@@ -622,12 +725,52 @@ void ThemeData::loadFile(const std::string system, std::map<std::string, std::st
 			mEvaluatorVariables[var.first] = var.second;		
 	}
 
-	pugi::xml_document doc;
-	pugi::xml_parse_result res = fromFile ? doc.load_file(path.c_str()) : doc.load_string(path.c_str());
+	StopWatch stopWatch("ThemeData::loadFile " + system + " :", LogDebug);
+
+	mLoadedFiles.clear();
+	mLoadedFiles.push_back(path);
+	mCheckedPaths.clear();
+
+	std::string compiledPath;
+	if (fromFile && Settings::getInstance()->getBool("CompiledThemeCache"))
+		compiledPath = getCompiledThemePath(system, sysDataMap, path);
+
+	if (compiledPath.empty() || !loadCompiledTheme(compiledPath))
+	{
+		parseFile(path, fromFile, error);
+
+		if (!compiledPath.empty())
+			saveCompiledTheme(compiledPath);
+	}
+
+	if (system != "splash" && system != "imageviewer")
+	{
+		mMenuTheme = nullptr;
+		mDefaultTheme = this;
+	}
+
+	if (fromFile)
+		LOG(LogDebug) << "ThemeData::loadFile " << system << " : " << ThemeDocumentCache::getStatistics();
+}
+
+void ThemeData::parseFile(const std::string& path, bool fromFile, ThemeException& error)
+{
+	std::shared_ptr<const pugi::xml_document> doc;
+	pugi::xml_parse_result res;
+
+	if (fromFile)
+		doc = ThemeDocumentCache::getDocument(path, res);
+	else
+	{
+		auto stringDoc = std::make_shared<pugi::xml_document>();
+		res = stringDoc->load_string(path.c_str());
+		doc = stringDoc;
+	}
+
 	if(!res)
 		throw error << "XML parsing error: \n    " << res.description();
 
-	pugi::xml_node root = doc.child("theme");
+	pugi::xml_node root = doc->child("theme");
 	if(!root)
 		throw error << "Missing <theme> tag!";
 
@@ -657,12 +800,6 @@ void ThemeData::loadFile(const std::string system, std::map<std::string, std::st
 			}
 		}
 	}
-
-	if (system != "splash" && system != "imageviewer")
-	{
-		mMenuTheme = nullptr;
-		mDefaultTheme = this;
-	}
 }
 
 const std::shared_ptr<ThemeData::ThemeMenu>& ThemeData::getMenuTheme()
@@ -870,11 +1007,16 @@ void ThemeData::parseInclude(const pugi::xml_node& node)
 
 	std::string path = Utils::FileSystem::resolveRelativePath(resolveSystemVariable(mSystemThemeFolder, relPath), Utils::FileSystem::getParent(mPaths.back()), true);
 
+	// Missing includes are recorded too : the compiled theme is outdated when they appear
+	mLoadedFiles.push_back(path);
+
 	if (!ResourceManager::getInstance()->fileExists(path))
 	{
 		if (relPath.find("$") != std::string::npos && relPath.find("${") == std::string::npos)
 		{
 			path = Utils::FileSystem::resolveRelativePath(resolveSystemVariable("default", relPath), Utils::FileSystem::getParent(mPaths.back()), true);
+			mLoadedFiles.push_back(path);
+
 			if (ResourceManager::getInstance()->fileExists(path))
 			{
 				if (mPaths.size() == 1)
@@ -1259,8 +1401,12 @@ void ThemeData::parseSubsetElement(const pugi::xml_node& root)
 	const std::string displayName = resolvePlaceholders(root.attribute("displayName").as_string());
 	const std::string appliesTo = root.attribute("appliesTo").as_string();
 
-	for (pugi::xml_node node = root.child("include"); node; node = node.next_sibling("include"))
+	for (pugi::xml_node include = root.child("include"); include; include = include.next_sibling("include"))
 	{
+		// The document is shared between systems : set the subset attributes on a copy of the node
+		pugi::xml_document includeCopy;
+		pugi::xml_node node = includeCopy.append_copy(include);
+
 		node.remove_attribute("subset");
 		node.append_attribute("subset") = name.c_str();
 
@@ -1541,7 +1687,7 @@ void ThemeData::processElement(const pugi::xml_node& root, ThemeElement& element
 		}
 		else
 		{
-			if (ResourceManager::getInstance()->fileExists(path))
+			if (checkMediaExists(path))
 			{
 				element.properties[name] = path;
 				break;
@@ -1549,7 +1695,7 @@ void ThemeData::processElement(const pugi::xml_node& root, ThemeElement& element
 			else if ((str[0] == '.' || str[0] == '~') && mPaths.size() > 1)
 			{
 				std::string rootPath = Utils::FileSystem::resolveRelativePath(str, Utils::FileSystem::getParent(mPaths.front()), true);
-				if (rootPath != path && ResourceManager::getInstance()->fileExists(rootPath))
+				if (rootPath != path && checkMediaExists(rootPath))
 				{
 					element.properties[name] = rootPath;
 					break;
@@ -1606,7 +1752,7 @@ void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::str
 		{
 			for (auto prop : importIt->second.properties)
 			{
-				auto typeIt = typeMap.find(prop.first);
+				auto typeIt = typeMap.find(ThemeElement::getPropertyName(prop.first));
 				if (typeIt != typeMap.cend())
 					element.properties[prop.first] = prop.second;
 			}
@@ -1693,7 +1839,11 @@ void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::str
 			if (element.type == "menuIcons")
 				type = PATH;
 			else if (name == "animate" && std::string(root.name()) == "imagegrid")
-				node.set_name("animateSelection");
+			{
+				// Documents are shared between systems : map the legacy name without renaming the node
+				name = "animateSelection";
+				type = typeMap.at(name);
+			}
 			else
 			{
 				LOG(LogWarning) << "Unknown property type \"" << name << "\" (for element of type " << root.name() << ").";
@@ -2118,7 +2268,7 @@ ThemeData::ThemeMenu::ThemeMenu(ThemeData* theme)
 		{
 			std::string path = prop.second.s;
 			if (!path.empty() && ResourceManager::getInstance()->fileExists(path))
-				mMenuIcons[prop.first] = path;
+				mMenuIcons[ThemeElement::getPropertyName(prop.first)] = path;
 		}
 	}
 }
@@ -2222,6 +2372,109 @@ ThemeData::ThemeElement::~ThemeElement()
 	mStoryBoards.clear();
 }
 
+// Names of the ThemeProperty ids, in the same order
+static const char* sComponentPropertyNames[] = 
+{
+	"", "pos", "x", "y", "size", "w", "h", "maxSize", "minSize", "origin", "rotation", "rotationOrigin", "opacity", "zIndex", "scale", "scaleOrigin",
+	"offset", "offsetX", "offsetY", "clipRect", "path", "color", "colorEnd", "centerColor", "edgeColor", "backgroundColor", "animateColor",
+	"glowColor", "glowSize", "glowOffset", "reflexion", "roundCorners", "padding", "cornerSize", "saturation", "lineSpacing", "text", "value"
+};
+
+static_assert(sizeof(sComponentPropertyNames) / sizeof(sComponentPropertyNames[0]) == ThemeProperty::COUNT, "sComponentPropertyNames must match ThemeProperty::PropertyId");
+
+// Interned property names. ThemeProperty ids come first, then the properties declared in sElementMap : these fixed ids are looked up without locking,
+// names that are only known at runtime ( menuIcons... ) are appended under a lock.
+class ThemePropertyNames
+{
+public:
+	ThemePropertyNames(const std::map<std::string, std::map<std::string, ThemeData::ElementPropertyType>>& elementMap)
+	{
+		mNames.push_back("");
+
+		for (unsigned int id = 1; id < ThemeProperty::COUNT; id++)
+		{
+			mIds[sComponentPropertyNames[id]] = id;
+			mNames.push_back(sComponentPropertyNames[id]);
+		}
+
+		for (auto& element : elementMap)
+		{
+			for (auto& property : element.second)
+			{
+				if (mIds.find(property.first) != mIds.cend())
+					continue;
+
+				mIds[property.first] = (unsigned int)mNames.size();
+				mNames.push_back(property.first);
+			}
+		}
+	}
+
+	unsigned int getId(const std::string& name, bool create)
+	{
+		auto it = mIds.find(name);
+		if (it != mIds.cend())
+			return it->second;
+
+		std::unique_lock<std::mutex> lock(mLock);
+
+		auto dyn = mDynamicIds.find(name);
+		if (dyn != mDynamicIds.cend())
+			return dyn->second;
+
+		if (!create)
+			return 0;
+
+		unsigned int id = (unsigned int)(mNames.size() + mDynamicNames.size());
+		mDynamicIds[name] = id;
+		mDynamicNames.push_back(name);
+		return id;
+	}
+
+	std::string getName(unsigned int id)
+	{
+		if (id < mNames.size())
+			return mNames[id];
+
+		std::unique_lock<std::mutex> lock(mLock);
+
+		id -= (unsigned int)mNames.size();
+		if (id < mDynamicNames.size())
+			return mDynamicNames[id];
+
+		return "";
+	}
+
+private:
+	std::unordered_map<std::string, unsigned int> mIds;
+	std::vector<std::string> mNames;
+
+	std::mutex mLock;
+	std::unordered_map<std::string, unsigned int> mDynamicIds;
+	std::vector<std::string> mDynamicNames;
+};
+
+static ThemePropertyNames& getPropertyNames(const std::map<std::string, std::map<std::string, ThemeData::ElementPropertyType>>& elementMap)
+{
+	static ThemePropertyNames names(elementMap);
+	return names;
+}
+
+unsigned int ThemeData::ThemeElement::getPropertyId(const std::string& name)
+{
+	return getPropertyNames(sElementMap).getId(name, false);
+}
+
+unsigned int ThemeData::ThemeElement::registerPropertyName(const std::string& name)
+{
+	return getPropertyNames(sElementMap).getId(name, true);
+}
+
+std::string ThemeData::ThemeElement::getPropertyName(unsigned int id)
+{
+	return getPropertyNames(sElementMap).getName(id);
+}
+
 std::shared_ptr<ThemeData> ThemeData::clone(const std::string& viewName)
 {
 	auto theme = std::make_shared<ThemeData>();
@@ -2255,8 +2508,8 @@ bool ThemeData::appendFile(const std::string& path, bool perGameOverride)
 {
 	mPaths.push_back(path);
 
-	pugi::xml_document includeDoc;
-	pugi::xml_parse_result result = includeDoc.load_file(path.c_str());
+	pugi::xml_parse_result result;
+	auto includeDoc = ThemeDocumentCache::getDocument(path, result);
 	if (!result)
 	{
 		mPaths.pop_back();
@@ -2264,7 +2517,7 @@ bool ThemeData::appendFile(const std::string& path, bool perGameOverride)
 		return false;
 	}
 
-	pugi::xml_node theme = includeDoc.child("theme");
+	pugi::xml_node theme = includeDoc->child("theme");
 	if (!theme)
 	{
 		mPaths.pop_back();
@@ -2282,4 +2535,602 @@ bool ThemeData::appendFile(const std::string& path, bool perGameOverride)
 	mPaths.pop_back();
 
 	return true;
-}
\ No newline at end of file
+}
+// Compiled themes ( cache/themes/[key].bin ) :
+//   header : "ESTC" + version, then the theme files that were read with their modification time & size,
+//            and the media paths that were looked up with whether they existed
+//   body   : the resolved theme ( variables, subsets, views, elements & storyboards ), with typed & packed property values.
+//            Property names are written once in a table, elements refer to them by index.
+// The key is a md5 of the theme path and of everything the resolution depends on ( system variables, language, region, subsets... ),
+// so each system of each theme gets its own file. A file is ignored as soon as one of its theme files changed,
+// or as soon as one of its media appeared or disappeared.
+
+#define COMPILEDTHEME_MAGIC			"ESTC"
+#define COMPILEDTHEME_VERSION		2
+#define COMPILEDTHEME_MAX_FILES		1024
+
+enum CompiledAnimationType : int32_t
+{
+	FLOAT_ANIMATION = 0,
+	COLOR_ANIMATION = 1,
+	VECTOR2_ANIMATION = 2,
+	VECTOR4_ANIMATION = 3,
+	STRING_ANIMATION = 4,
+	PATH_ANIMATION = 5
+};
+
+class ThemeBinaryWriter
+{
+public:
+	void writeInt(int32_t value) { mBuffer.append((const char*)&value, sizeof(int32_t)); }
+	void writeFloat(float value) { mBuffer.append((const char*)&value, sizeof(float)); }
+
+	void writeString(const std::string& value)
+	{
+		writeInt((int32_t)value.size());
+		mBuffer.append(value);
+	}
+
+	void writeProperty(const ThemeData::ThemeElement::Property& value)
+	{
+		writeInt((int32_t)value.type);
+
+		switch (value.type)
+		{
+		case ThemeData::ThemeElement::Property::PropertyType::String:
+			writeString(value.s);
+			break;
+		case ThemeData::ThemeElement::Property::PropertyType::Int:
+			writeInt((int32_t)value.i);
+			break;
+		case ThemeData::ThemeElement::Property::PropertyType::Float:
+			writeFloat(value.f);
+			break;
+		case ThemeData::ThemeElement::Property::PropertyType::Bool:
+			writeInt(value.b ? 1 : 0);
+			break;
+		case ThemeData::ThemeElement::Property::PropertyType::Pair:
+			writeFloat(value.v.x());
+			writeFloat(value.v.y());
+			break;
+		case ThemeData::ThemeElement::Property::PropertyType::Rect:
+			writeFloat(value.r.x());
+			writeFloat(value.r.y());
+			writeFloat(value.r.z());
+			writeFloat(value.r.w());
+			break;
+		default:
+			break;
+		}
+	}
+
+	const std::string& getBuffer() { return mBuffer; }
+
+private:
+	std::string mBuffer;
+};
+
+// Reads back ThemeBinaryWriter data. Reading past the end invalidates the reader instead of throwing
+class ThemeBinaryReader
+{
+public:
+	ThemeBinaryReader(const std::string& data) : mData(data), mPosition(0), mValid(true) { }
+
+	bool isValid() { return mValid; }
+	bool isEof() { return mPosition >= mData.size(); }
+
+	int32_t readInt()
+	{
+		int32_t value = 0;
+		read(&value, sizeof(int32_t));
+		return value;
+	}
+
+	float readFloat()
+	{
+		float value = 0;
+		read(&value, sizeof(float));
+		return value;
+	}
+
+	// Item counts can't be greater than the remaining bytes : avoids huge allocations with damaged files
+	int32_t readCount()
+	{
+		int32_t count = readInt();
+		if (count < 0 || (size_t)count > mData.size() - mPosition)
+		{
+			mValid = false;
+			return 0;
+		}
+
+		return count;
+	}
+
+	std::string readString()
+	{
+		int32_t length = readCount();
+		if (!mValid || length == 0)
+			return "";
+
+		std::string value = mData.substr(mPosition, length);
+		mPosition += length;
+		return value;
+	}
+
+	ThemeData::ThemeElement::Property readProperty()
+	{
+		ThemeData::ThemeElement::Property value;
+
+		auto type = (ThemeData::ThemeElement::Property::PropertyType) readInt();
+		switch (type)
+		{
+		case ThemeData::ThemeElement::Property::PropertyType::String:
+			value = readString();
+			break;
+		case ThemeData::ThemeElement::Property::PropertyType::Int:
+			value = (unsigned int)readInt();
+			break;
+		case ThemeData::ThemeElement::Property::PropertyType::Float:
+			value = readFloat();
+			break;
+		case ThemeData::ThemeElement::Property::PropertyType::Bool:
+			value = readInt() != 0;
+			break;
+		case ThemeData::ThemeElement::Property::PropertyType::Pair:
+			{
+				float x = readFloat();
+				float y = readFloat();
+				value = Vector2f(x, y);
+			}
+			break;
+		case ThemeData::ThemeElement::Property::PropertyType::Rect:
+			{
+				float x = readFloat();
+				float y = readFloat();
+				float z = readFloat();
+				float w = readFloat();
+				value = Vector4f(x, y, z, w);
+			}
+			break;
+		case ThemeData::ThemeElement::Property::PropertyType::Unknown:
+			value.type = type;
+			break;
+		default:
+			mValid = false;
+			break;
+		}
+
+		return value;
+	}
+
+private:
+	void read(void* data, size_t size)
+	{
+		if (!mValid || mData.size() - mPosition < size)
+		{
+			mValid = false;
+			return;
+		}
+
+		memcpy(data, mData.data() + mPosition, size);
+		mPosition += size;
+	}
+
+	const std::string& mData;
+	size_t mPosition;
+	bool mValid;
+};
+
+static std::string getCompiledThemeFolder()
+{
+	return Paths::getUserEmulationStationPath() + "/cache/themes";
+}
+
+bool ThemeData::checkMediaExists(const std::string& path)
+{
+	bool exists = ResourceManager::getInstance()->fileExists(path);
+
+	// Bundled resources can't change while ES runs, only theme & user files need to be validated by the compiled theme
+	if (!path.empty() && path[0] != ':')
+		mCheckedPaths[path] = exists;
+
+	return exists;
+}
+
+std::string ThemeData::getCompiledThemePath(const std::string& system, const std::map<std::string, std::string>& sysDataMap, const std::string& path)
+{
+	std::string key = path + "|" + system;
+
+	for (auto var : sysDataMap)
+		key += "|" + var.first + "=" + var.second;
+
+	key += "|" + mLanguage + "|" + mRegion + "|" + mColorset + "|" + mIconset + "|" + mMenu + "|" + mSystemview + "|" + mGamelistview;
+	key += "|" + Settings::getInstance()->getString("ThemeSet");
+	key += "|" + std::string(Settings::getInstance()->getBool("ShowHelpPrompts") ? "help" : "nohelp");
+	key += "|" + std::string(Renderer::isSmallScreen() ? "small" : "normal");
+
+	for (auto setting : Settings::getInstance()->getStringMap())
+		if (Utils::String::startsWith(setting.first, "subset."))
+			key += "|" + setting.first + "=" + setting.second;
+
+	return getCompiledThemeFolder() + "/" + md5(key) + ".bin";
+}
+
+bool ThemeData::loadCompiledTheme(const std::string& compiledPath)
+{
+	std::string data;
+
+	{
+		std::ifstream f(WINSTRINGW(compiledPath), std::ios::binary);
+		if (f.fail())
+			return false;
+
+		std::stringstream buffer;
+		buffer << f.rdbuf();
+		data = buffer.str();
+	}
+
+	if (data.size() < 8 || data.compare(0, 4, COMPILEDTHEME_MAGIC) != 0)
+		return false;
+
+	ThemeBinaryReader reader(data);
+	reader.readInt(); // magic
+
+	if (reader.readInt() != COMPILEDTHEME_VERSION)
+		return false;
+
+	std::vector<std::string> files;
+
+	int32_t fileCount = reader.readCount();
+	for (int32_t i = 0; i < fileCount && reader.isValid(); i++)
+	{
+		std::string file = reader.readString();
+		std::string stamp = reader.readString();
+
+		if (getThemeFileStamp(file) != stamp)
+		{
+			LOG(LogDebug) << "ThemeData::loadCompiledTheme : " << file << " has changed";
+			return false;
+		}
+
+		files.push_back(file);
+	}
+
+	// Media paths are resolved when the theme is compiled : a media that appeared or disappeared since then invalidates the file
+	std::map<std::string, bool> checkedPaths;
+
+	int32_t pathCount = reader.readCount();
+	for (int32_t i = 0; i < pathCount && reader.isValid(); i++)
+	{
+		std::string path = reader.readString();
+		bool existed = reader.readInt() != 0;
+
+		if (ResourceManager::getInstance()->fileExists(path) != existed)
+		{
+			LOG(LogDebug) << "ThemeData::loadCompiledTheme : " << path << (existed ? " has been removed" : " has been added");
+			return false;
+		}
+
+		checkedPaths[path] = existed;
+	}
+
+	float version = reader.readFloat();
+	std::string defaultView = reader.readString();
+	std::string defaultTransition = reader.readString();
+	std::string systemThemeFolder = reader.readString();
+
+	std::map<std::string, std::string> variables;
+
+	int32_t count = reader.readCount();
+	for (int32_t i = 0; i < count && reader.isValid(); i++)
+	{
+		std::string name = reader.readString();
+		variables[name] = reader.readString();
+	}
+
+	std::vector<Subset> subsets;
+
+	count = reader.readCount();
+	for (int32_t i = 0; i < count && reader.isValid(); i++)
+	{
+		std::string subset = reader.readString();
+		std::string name = reader.readString();
+		std::string displayName = reader.readString();
+		std::string subSetDisplayName = reader.readString();
+
+		Subset item(subset, name, displayName, subSetDisplayName);
+
+		int32_t appliesCount = reader.readCount();
+		for (int32_t a = 0; a < appliesCount && reader.isValid(); a++)
+			item.appliesTo.push_back(reader.readString());
+
+		subsets.push_back(item);
+	}
+
+	// Property names, referenced by index in the elements
+	std::vector<unsigned int> propertyIds;
+
+	count = reader.readCount();
+	for (int32_t i = 0; i < count && reader.isValid(); i++)
+		propertyIds.push_back(ThemeElement::registerPropertyName(reader.readString()));
+
+	UnsortedViewMap views;
+
+	count = reader.readCount();
+	for (int32_t i = 0; i < count && reader.isValid(); i++)
+	{
+		std::string viewName = reader.readString();
+
+		views.push_back(std::pair<std::string, ThemeView>(viewName, ThemeView()));
+		ThemeView& view = views.back().second;
+
+		view.baseType = reader.readString();
+		view.displayName = reader.readString();
+		view.isCustomView = reader.readInt() != 0;
+
+		int32_t itemCount = reader.readCount();
+		for (int32_t b = 0; b < itemCount && reader.isValid(); b++)
+			view.baseTypes.push_back(reader.readString());
+
+		itemCount = reader.readCount();
+		for (int32_t k = 0; k < itemCount && reader.isValid(); k++)
+			view.orderedKeys.push_back(reader.readString());
+
+		itemCount = reader.readCount();
+		for (int32_t e = 0; e < itemCount && reader.isValid(); e++)
+		{
+			std::string elementName = reader.readString();
+			ThemeElement& element = view.elements[elementName];
+
+			element.extra = reader.readInt();
+			element.type = reader.readString();
+
+			int32_t propertyCount = reader.readCount();
+			for (int32_t p = 0; p < propertyCount && reader.isValid(); p++)
+			{
+				int32_t index = reader.readInt();
+				auto value = reader.readProperty();
+
+				if (index < 0 || index >= (int32_t)propertyIds.size())
+					return false;
+
+				element.properties[propertyIds[index]] = value;
+			}
+
+			int32_t storyboardCount = reader.readCount();
+			for (int32_t sb = 0; sb < storyboardCount && reader.isValid(); sb++)
+			{
+				std::string key = reader.readString();
+
+				auto storyboard = new ThemeStoryboard();
+				storyboard->eventName = reader.readString();
+				storyboard->repeat = reader.readInt();
+				storyboard->repeatAt = reader.readInt();
+
+				auto old = element.mStoryBoards.find(key);
+				if (old != element.mStoryBoards.cend())
+					delete old->second;
+
+				element.mStoryBoards[key] = storyboard;
+
+				int32_t animationCount = reader.readCount();
+				for (int32_t a = 0; a < animationCount && reader.isValid(); a++)
+				{
+					ThemeAnimation* anim = nullptr;
+
+					switch ((CompiledAnimationType)reader.readInt())
+					{
+					case FLOAT_ANIMATION: anim = new ThemeFloatAnimation(); break;
+					case COLOR_ANIMATION: anim = new ThemeColorAnimation(); break;
+					case VECTOR2_ANIMATION: anim = new ThemeVector2Animation(); break;
+					case VECTOR4_ANIMATION: anim = new ThemeVector4Animation(); break;
+					case STRING_ANIMATION: anim = new ThemeStringAnimation(); break;
+					case PATH_ANIMATION: anim = new ThemePathAnimation(); break;
+					default: return false;
+					}
+
+					storyboard->animations.push_back(anim);
+
+					anim->propertyName = reader.readString();
+					anim->propertyId = ThemeElement::getPropertyId(anim->propertyName); // same lookup as ThemeStoryboard::fromXmlNode
+					anim->duration = reader.readInt();
+					anim->begin = reader.readInt();
+					anim->autoReverse = reader.readInt() != 0;
+					anim->repeat = reader.readInt();
+					anim->easingMode = (ThemeAnimation::EasingMode) reader.readInt();
+					anim->from = reader.readProperty();
+					anim->to = reader.readProperty();
+				}
+			}
+		}
+	}
+
+	if (!reader.isValid() || !reader.isEof())
+	{
+		LOG(LogWarning) << "ThemeData::loadCompiledTheme : " << compiledPath << " is damaged";
+		return false;
+	}
+
+	mVersion = version;
+	mDefaultView = defaultView;
+	mDefaultTransition = defaultTransition;
+	mSystemThemeFolder = systemThemeFolder;
+	mVariables = variables;
+	mSubsets = subsets;
+	mViews.swap(views);
+	mLoadedFiles = files;
+	mCheckedPaths = checkedPaths;
+
+	return true;
+}
+
+void ThemeData::saveCompiledTheme(const std::string& compiledPath)
+{
+	static std::atomic<bool> folderChecked(false);
+
+	std::string folder = getCompiledThemeFolder();
+
+	// Each theme change creates new files : start over when there are too many of them
+	if (!folderChecked.exchange(true))
+	{
+		if (Utils::FileSystem::exists(folder) && Utils::FileSystem::getDirContent(folder).size() > COMPILEDTHEME_MAX_FILES)
+			Utils::FileSystem::deleteDirectoryFiles(folder);
+	}
+
+	if (!Utils::FileSystem::exists(folder))
+		Utils::FileSystem::createDirectory(folder);
+
+	ThemeBinaryWriter writer;
+	writer.writeInt(0); // magic, replaced below
+	writer.writeInt(COMPILEDTHEME_VERSION);
+
+	std::vector<std::string> files;
+	for (auto file : mLoadedFiles)
+		if (std::find(files.cbegin(), files.cend(), file) == files.cend())
+			files.push_back(file);
+
+	writer.writeInt((int32_t)files.size());
+	for (auto file : files)
+	{
+		writer.writeString(file);
+		writer.writeString(getThemeFileStamp(file));
+	}
+
+	writer.writeInt((int32_t)mCheckedPaths.size());
+	for (auto path : mCheckedPaths)
+	{
+		writer.writeString(path.first);
+		writer.writeInt(path.second ? 1 : 0);
+	}
+
+	writer.writeFloat(mVersion);
+	writer.writeString(mDefaultView);
+	writer.writeString(mDefaultTransition);
+	writer.writeString(mSystemThemeFolder);
+
+	writer.writeInt((int32_t)mVariables.size());
+	for (auto var : mVariables)
+	{
+		writer.writeString(var.first);
+		writer.writeString(var.second);
+	}
+
+	writer.writeInt((int32_t)mSubsets.size());
+	for (auto subset : mSubsets)
+	{
+		writer.writeString(subset.subset);
+		writer.writeString(subset.name);
+		writer.writeString(subset.displayName);
+		writer.writeString(subset.subSetDisplayName);
+
+		writer.writeInt((int32_t)subset.appliesTo.size());
+		for (auto appliesTo : subset.appliesTo)
+			writer.writeString(appliesTo);
+	}
+
+	// Property names table
+	std::map<unsigned int, int32_t> propertyIndexes;
+	std::vector<unsigned int> propertyIds;
+
+	for (auto& view : mViews)
+	{
+		for (auto& element : view.second.elements)
+		{
+			for (auto& prop : element.second.properties)
+			{
+				if (propertyIndexes.find(prop.first) != propertyIndexes.cend())
+					continue;
+
+				propertyIndexes[prop.first] = (int32_t)propertyIds.size();
+				propertyIds.push_back(prop.first);
+			}
+		}
+	}
+
+	writer.writeInt((int32_t)propertyIds.size());
+	for (auto id : propertyIds)
+		writer.writeString(ThemeElement::getPropertyName(id));
+
+	writer.writeInt((int32_t)mViews.size());
+	for (auto& view : mViews)
+	{
+		writer.writeString(view.first);
+		writer.writeString(view.second.baseType);
+		writer.writeString(view.second.displayName);
+		writer.writeInt(view.second.isCustomView ? 1 : 0);
+
+		writer.writeInt((int32_t)view.second.baseTypes.size());
+		for (auto baseType : view.second.baseTypes)
+			writer.writeString(baseType);
+
+		writer.writeInt((int32_t)view.second.orderedKeys.size());
+		for (auto key : view.second.orderedKeys)
+			writer.writeString(key);
+
+		writer.writeInt((int32_t)view.second.elements.size());
+		for (auto& element : view.second.elements)
+		{
+			writer.writeString(element.first);
+			writer.writeInt(element.second.extra);
+			writer.writeString(element.second.type);
+
+			writer.writeInt((int32_t)element.second.properties.size());
+			for (auto& prop : element.second.properties)
+			{
+				writer.writeInt(propertyIndexes[prop.first]);
+				writer.writeProperty(prop.second);
+			}
+
+			writer.writeInt((int32_t)element.second.mStoryBoards.size());
+			for (auto& sb : element.second.mStoryBoards)
+			{
+				writer.writeString(sb.first);
+				writer.writeString(sb.second->eventName);
+				writer.writeInt(sb.second->repeat);
+				writer.writeInt(sb.second->repeatAt);
+
+				writer.writeInt((int32_t)sb.second->animations.size());
+				for (auto anim : sb.second->animations)
+				{
+					CompiledAnimationType type = STRING_ANIMATION;
+
+					if (dynamic_cast<ThemeFloatAnimation*>(anim) != nullptr)
+						type = FLOAT_ANIMATION;
+					else if (dynamic_cast<ThemeColorAnimation*>(anim) != nullptr)
+						type = COLOR_ANIMATION;
+					else if (dynamic_cast<ThemeVector2Animation*>(anim) != nullptr)
+						type = VECTOR2_ANIMATION;
+					else if (dynamic_cast<ThemeVector4Animation*>(anim) != nullptr)
+						type = VECTOR4_ANIMATION;
+					else if (dynamic_cast<ThemePathAnimation*>(anim) != nullptr)
+						type = PATH_ANIMATION;
+
+					writer.writeInt(type);
+					writer.writeString(anim->propertyName);
+					writer.writeInt(anim->duration);
+					writer.writeInt(anim->begin);
+					writer.writeInt(anim->autoReverse ? 1 : 0);
+					writer.writeInt(anim->repeat);
+					writer.writeInt((int32_t)anim->easingMode);
+					writer.writeProperty(anim->from);
+					writer.writeProperty(anim->to);
+				}
+			}
+		}
+	}
+
+	std::string buffer = writer.getBuffer();
+	memcpy(&buffer[0], COMPILEDTHEME_MAGIC, 4);
+
+	std::string tmpName = compiledPath + ".tmp";
+
+	std::ofstream f(WINSTRINGW(tmpName), std::ios::binary);
+	if (f.fail())
+		return;
+
+	f.write(buffer.data(), buffer.size());
+	f.close();
+
+	if (!Utils::FileSystem::renameFile(tmpName, compiledPath))
+		Utils::FileSystem::removeFile(tmpName);
+}
@@ -5,11 +5,13 @@
 #include "math/Vector2f.h"
 #include "math/Vector4f.h"
 #include "utils/FileSystemUtil.h"
+#include <algorithm>
 #include <deque>
 #include <map>
 #include <unordered_map>
 #include <memory>
 #include <sstream>
+#include <stdexcept>
 #include <vector>
 #include <pugixml/src/pugixml.hpp>
 #include "utils/MathExpr.h"
@@ -52,6 +54,55 @@ namespace ThemeFlags
 	};
 }
 
+// Ids of the properties that components expose to storyboards ( GuiComponent::getProperty/setProperty ).
+// They are interned before any other property name, so components can dispatch on them with a switch.
+namespace ThemeProperty
+{
+	enum PropertyId : unsigned int
+	{
+		UNKNOWN = 0,
+		POS,
+		X,
+		Y,
+		SIZE,
+		W,
+		H,
+		MAX_SIZE,
+		MIN_SIZE,
+		ORIGIN,
+		ROTATION,
+		ROTATION_ORIGIN,
+		OPACITY,
+		Z_INDEX,
+		SCALE,
+		SCALE_ORIGIN,
+		OFFSET,
+		OFFSET_X,
+		OFFSET_Y,
+		CLIP_RECT,
+		PATH,
+		COLOR,
+		COLOR_END,
+		CENTER_COLOR,
+		EDGE_COLOR,
+		BACKGROUND_COLOR,
+		ANIMATE_COLOR,
+		GLOW_COLOR,
+		GLOW_SIZE,
+		GLOW_OFFSET,
+		REFLEXION,
+		ROUND_CORNERS,
+		PADDING,
+		CORNER_SIZE,
+		SATURATION,
+		LINE_SPACING,
+		TEXT,
+		VALUE,
+
+		COUNT
+	};
+}
+
 class ThemeException : public std::exception
 {
 public:
@@ -221,36 +272,112 @@ public:
 				Unknown
 			};
 			
-			Property() { i = 0; type = PropertyType::String; };
+			Property() { r = Vector4f(); type = PropertyType::String; };
 			Property(const Vector2f& value) { v = value; type = PropertyType::Pair; };
 			Property(const std::string& value) { s = value; type = PropertyType::String; };
 			Property(const unsigned int& value) { i = value; type = PropertyType::Int; };
 			Property(const float& value) { f = value; type = PropertyType::Float; };
 			Property(const bool& value) { b = value; type = PropertyType::Bool; };
-			Property(const Vector4f& value) { r = value; v = Vector2f(value.x(), value.y()); type = PropertyType::Rect; };
+			Property(const Vector4f& value) { r = value; type = PropertyType::Rect; };
 
 			void operator= (const Vector2f& value)     { v = value; type = PropertyType::Pair; }
 			void operator= (const std::string& value)  { s = value; type = PropertyType::String; }
 			void operator= (const unsigned int& value) { i = value; type = PropertyType::Int; }
 			void operator= (const float& value)        { f = value; type = PropertyType::Float; }
 			void operator= (const bool& value)         { b = value; type = PropertyType::Bool; }
-			void operator= (const Vector4f& value)     { r = value; v = Vector2f(value.x(), value.y()); type = PropertyType::Rect; }
+			void operator= (const Vector4f& value)     { r = value; type = PropertyType::Rect; }
 
+			// Rect values share their storage with Pair values : v is always the position part of r
 			union
 			{
 				unsigned int i;
 				float        f;
 				bool         b;
+				Vector2f     v;
+				Vector4f     r;
 			};
 
 			std::string  s;
-			Vector2f     v;
-			Vector4f     r;
 			PropertyType type;
 
 		};
 
-		std::map< std::string, Property > properties;
+		// Properties of an element, stored in a vector sorted by interned property id
+		class PropertyMap
+		{
+		public:
+			typedef std::pair<unsigned int, Property> value_type;
+			typedef std::vector<value_type>::iterator iterator;
+			typedef std::vector<value_type>::const_iterator const_iterator;
+
+			iterator       begin()        { return mItems.begin(); }
+			iterator       end()          { return mItems.end(); }
+			const_iterator begin()  const { return mItems.cbegin(); }
+			const_iterator end()    const { return mItems.cend(); }
+			const_iterator cbegin() const { return mItems.cbegin(); }
+			const_iterator cend()   const { return mItems.cend(); }
+
+			size_t size() const { return mItems.size(); }
+			void clear() { mItems.clear(); }
+
+			iterator find(unsigned int id)
+			{
+				auto it = lowerBound(id);
+				return it != mItems.end() && it->first == id ? it : mItems.end();
+			}
+
+			const_iterator find(unsigned int id) const { return ((PropertyMap*)this)->find(id); }
+
+			iterator find(const std::string& name) 
+			{ 
+				unsigned int id = getPropertyId(name);
+				return id == 0 ? mItems.end() : find(id);
+			}
+
+			const_iterator find(const std::string& name) const { return ((PropertyMap*)this)->find(name); }
+
+			const Property& at(const std::string& name) const
+			{
+				auto it = find(name);
+				if (it == mItems.cend())
+					throw std::out_of_range("ThemeElement property " + name);
+
+				return it->second;
+			}
+
+			Property& operator[](unsigned int id)
+			{
+				auto it = lowerBound(id);
+				if (it == mItems.end() || it->first != id)
+					it = mItems.insert(it, value_type(id, Property()));
+
+				return it->second;
+			}
+
+			Property& operator[](const std::string& name) { return (*this)[registerPropertyName(name)]; }
+
+			void erase(const std::string& name)
+			{
+				auto it = find(name);
+				if (it != mItems.end())
+					mItems.erase(it);
+			}
+
+		private:
+			iterator lowerBound(unsigned int id)
+			{
+				return std::lower_bound(mItems.begin(), mItems.end(), id, [](const value_type& item, unsigned int value) { return item.first < value; });
+			}
+
+			std::vector<value_type> mItems;
+		};
+
+		// Property names are interned : ids are stable for the whole process, 0 is never a valid id
+		static unsigned int getPropertyId(const std::string& name);
+		static unsigned int registerPropertyName(const std::string& name);
+		static std::string getPropertyName(unsigned int id);
+
+		PropertyMap properties;
 
 		template<typename T>
 		const T get(const std::string& prop) const
@@ -372,6 +499,7 @@ private:
 	std::string mDefaultView;
 	std::string mDefaultTransition;
 
+	void parseFile(const std::string& path, bool fromFile, ThemeException& error);
 	void parseTheme(const pugi::xml_node& root);
 
 	void parseFeature(const pugi::xml_node& node);	
@@ -396,6 +524,11 @@ private:
 
 	static GuiComponent* createExtraComponent(Window* window, const ThemeElement& elem, bool forceLoad = false);
 
+	std::string getCompiledThemePath(const std::string& system, const std::map<std::string, std::string>& sysDataMap, const std::string& path);
+	bool loadCompiledTheme(const std::string& compiledPath);
+	bool checkMediaExists(const std::string& path);
+	void saveCompiledTheme(const std::string& compiledPath);
+
 	std::string resolveSystemVariable(const std::string& systemThemeFolder, const std::string& path);
 	std::string resolvePlaceholders(const char* in);
 
@@ -409,6 +542,12 @@ private:
 	std::string mRegion;
 
 	std::map<std::string, std::string> mVariables;
+
+	// Theme files read by the last loadFile, including the missing includes
+	std::vector<std::string> mLoadedFiles;
+
+	// Media paths looked up by the last loadFile, and whether they existed
+	std::map<std::string, bool> mCheckedPaths;
 	
 	class UnsortedViewMap : public std::vector<std::pair<std::string, ThemeView>>
 	{
@@ -116,7 +116,7 @@ void StoryboardAnimator::addNewAnimations()
 
 		if (mCurrentTime >= anim->begin)
 		{
-			anim->ensureInitialValue(mComponent->getProperty(anim->propertyName));
+			anim->ensureInitialValue(mComponent->getProperty(anim->propertyId));
 			_currentStories.push_back(new StoryAnimation(anim));
 		}
 	}
@@ -132,18 +132,18 @@ bool StoryboardAnimator::update(int elapsed)
 		mHasInitialProperties = true;
 
 		for (auto anim : mStoryBoard->animations)
-			mInitialProperties[anim->propertyName] = mComponent->getProperty(anim->propertyName);
+			mInitialProperties[anim->propertyId] = mComponent->getProperty(anim->propertyId);
 
 		for (auto anim : mStoryBoard->animations)
 		{
 			if (anim->begin == 0)
 			{
 				if (anim->to.type == ThemeData::ThemeElement::Property::Unknown)
-					anim->to = mComponent->getProperty(anim->propertyName);
+					anim->to = mComponent->getProperty(anim->propertyId);
 				if (anim->from.type == ThemeData::ThemeElement::Property::Unknown)
-					anim->from = mComponent->getProperty(anim->propertyName);
-				else if (mDisabledProperties.find(anim->propertyName) == mDisabledProperties.cend())
-					mComponent->setProperty(anim->propertyName, anim->from);
+					anim->from = mComponent->getProperty(anim->propertyId);
+				else if (mDisabledProperties.find(anim->propertyId) == mDisabledProperties.cend())
+					mComponent->setProperty(anim->propertyId, anim->from);
 			}
 		}
 	}
@@ -157,8 +157,8 @@ bool StoryboardAnimator::update(int elapsed)
 		auto story = _currentStories[i];
 		bool ended = !story->update(elapsed);
 
-		if (mDisabledProperties.find(story->animation->propertyName) == mDisabledProperties.cend())
-			mComponent->setProperty(story->animation->propertyName, story->currentValue);
+		if (mDisabledProperties.find(story->animation->propertyId) == mDisabledProperties.cend())
+			mComponent->setProperty(story->animation->propertyId, story->currentValue);
 
 		if (ended)
 		{
@@ -207,8 +207,12 @@ const std::string StoryboardAnimator::getName()
 
 void StoryboardAnimator::enableProperty(const std::string& name, bool enable)
 {
-	mDisabledProperties.erase(name);
+	unsigned int id = ThemeData::ThemeElement::getPropertyId(name);
+	if (id == ThemeProperty::UNKNOWN)
+		return;
+
+	mDisabledProperties.erase(id);
 
 	if (!enable)
-		mDisabledProperties.insert(name);
+		mDisabledProperties.insert(id);
 }
\ No newline at end of file
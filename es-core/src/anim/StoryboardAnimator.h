@@ -185,8 +185,8 @@ private:
 
 	std::vector<StoryAnimation*> _currentStories;
 	std::vector<StoryAnimation*> _finishedStories;
-	std::map<std::string, ThemeData::ThemeElement::Property> mInitialProperties;
-	std::set<std::string> mDisabledProperties;
+	std::map<unsigned int, ThemeData::ThemeElement::Property> mInitialProperties; // Keyed by property id
+	std::set<unsigned int> mDisabledProperties;
 
 	bool mHasInitialProperties;
 };
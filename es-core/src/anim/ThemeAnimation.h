@@ -22,6 +22,7 @@ public:
 
 	ThemeAnimation()
 	{
+		propertyId = ThemeProperty::UNKNOWN;
 		repeat = 1;
 		duration = 0;
 		begin = 0;
@@ -33,6 +34,7 @@ public:
 	}
 
 	std::string propertyName;
+	unsigned int propertyId; // Interned propertyName, resolved when the storyboard is loaded
 	int duration;
 	int begin;
 	bool autoReverse;	
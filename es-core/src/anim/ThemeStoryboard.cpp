@@ -123,6 +123,7 @@ bool ThemeStoryboard::fromXmlNode(const pugi::xml_node& root, const std::map<std
 		if (anim != nullptr)
 		{
 			anim->propertyName = prop;
+			anim->propertyId = ThemeData::ThemeElement::getPropertyId(prop);
 
 			std::string mode = "linear";
 
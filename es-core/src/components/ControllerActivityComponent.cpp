@@ -244,7 +244,7 @@ void ControllerActivityComponent::render(const Transform4x4f& parentTrans)
 		itemsWidth += szW + mSpacing;
 		//itemsWidth += getTextureSize(mBatteryImage).x() + mSpacing;
 
-		if (Settings::getInstance()->getString("ShowBattery") == "text")
+		if (Settings::ShowBattery() == "text")
 		{
 			if (mBatteryFont == nullptr)
 				mBatteryFont = Font::get(szH * (Renderer::isSmallScreen() ? 0.55f : 0.70f), FONT_PATH_REGULAR);
@@ -319,7 +319,7 @@ void ControllerActivityComponent::render(const Transform4x4f& parentTrans)
 	{
 		x += renderTexture(x, szW, mBatteryImage, mColorShift);
 
-		if (mBatteryFont != nullptr && Settings::getInstance()->getString("ShowBattery") == "text")
+		if (mBatteryFont != nullptr && Settings::ShowBattery() == "text")
 		{
 			if (mBatteryText == nullptr || mBatteryTextX != x)
 			{
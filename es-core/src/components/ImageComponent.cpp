@@ -947,40 +947,45 @@ bool ImageComponent::isTiled()
 	return mTexture != nullptr && mTexture->isTiled(); 
 }
 
-ThemeData::ThemeElement::Property ImageComponent::getProperty(const std::string name)
+ThemeData::ThemeElement::Property ImageComponent::getProperty(unsigned int id)
 {
 	Vector2f scale = getParent() ? getParent()->getSize() : Vector2f((float)Renderer::getScreenWidth(), (float)Renderer::getScreenHeight());
 
-	if (name == "size" || name == "maxSize" || name == "minSize")
+	switch (id)
+	{
+	case ThemeProperty::SIZE:
+	case ThemeProperty::MAX_SIZE:
+	case ThemeProperty::MIN_SIZE:
 		return mSize / scale;
-	else if (name == "color")
+	case ThemeProperty::COLOR:
 		return mColorShift;
-	else if (name == "colorEnd")
+	case ThemeProperty::COLOR_END:
 		return mColorShiftEnd;
-	else if (name == "reflexion")
+	case ThemeProperty::REFLEXION:
 		return mReflection;
-	else if (name == "roundCorners")
+	case ThemeProperty::ROUND_CORNERS:
 		return mRoundCorners;
-	else if (name == "path")
+	case ThemeProperty::PATH:
 		return mPath;
-	else if (name == "padding")
+	case ThemeProperty::PADDING:
 		return mPadding;
-	else if (name == "saturation")
+	case ThemeProperty::SATURATION:
 		return mSaturation;
+	}
 
-	return GuiComponent::getProperty(name);
+	return GuiComponent::getProperty(id);
 }
 
-void ImageComponent::setProperty(const std::string name, const ThemeData::ThemeElement::Property& value)
+void ImageComponent::setProperty(unsigned int id, const ThemeData::ThemeElement::Property& value)
 {	
 	Vector2f scale = getParent() ? getParent()->getSize() : Vector2f((float)Renderer::getScreenWidth(), (float)Renderer::getScreenHeight());
 
-	if ((name == "maxSize" || name == "minSize") && value.type == ThemeData::ThemeElement::Property::PropertyType::Pair)
+	if ((id == ThemeProperty::MAX_SIZE || id == ThemeProperty::MIN_SIZE) && value.type == ThemeData::ThemeElement::Property::PropertyType::Pair)
 	{
 		mTargetSize = Vector2f(value.v.x() * scale.x(), value.v.y() * scale.y());
 		resize();
 	}
-	else if (name == "color" && value.type == ThemeData::ThemeElement::Property::PropertyType::Int)
+	else if (id == ThemeProperty::COLOR && value.type == ThemeData::ThemeElement::Property::PropertyType::Int)
 	{
 		if (mColorShift == mColorShiftEnd)
 			setColorShift(value.i);
@@ -990,24 +995,24 @@ void ImageComponent::setProperty(const std::string name, const ThemeData::ThemeE
 			updateColors();
 		}
 	}
-	else if (name == "colorEnd" && value.type == ThemeData::ThemeElement::Property::PropertyType::Int)
+	else if (id == ThemeProperty::COLOR_END && value.type == ThemeData::ThemeElement::Property::PropertyType::Int)
 		setColorShiftEnd(value.i);
-	else if (name == "reflexion" && value.type == ThemeData::ThemeElement::Property::PropertyType::Pair)
+	else if (id == ThemeProperty::REFLEXION && value.type == ThemeData::ThemeElement::Property::PropertyType::Pair)
 		mReflection = value.v;
-	else if (name == "roundCorners" && value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
+	else if (id == ThemeProperty::ROUND_CORNERS && value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
 		setRoundCorners(value.f);
-	else if (name == "padding" && value.type == ThemeData::ThemeElement::Property::PropertyType::Rect)
+	else if (id == ThemeProperty::PADDING && value.type == ThemeData::ThemeElement::Property::PropertyType::Rect)
 		setPadding(value.r);
-	else if (name == "path" && value.type == ThemeData::ThemeElement::Property::PropertyType::String)
+	else if (id == ThemeProperty::PATH && value.type == ThemeData::ThemeElement::Property::PropertyType::String)
 	{
 		mForceLoad = true;
 		mDynamic = false;
 		setImage(value.s, false);
 	}
-	else if (name == "saturation" && value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
+	else if (id == ThemeProperty::SATURATION && value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
 		setSaturation(value.f);
 	else
-		GuiComponent::setProperty(name, value);
+		GuiComponent::setProperty(id, value);
 }
 
 void ImageComponent::setRoundCorners(float value) 
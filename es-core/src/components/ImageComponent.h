@@ -125,8 +125,8 @@ public:
 	bool isLinear() { return mLinear; }
 	void setIsLinear(bool value) { mLinear = value; }
 
-	ThemeData::ThemeElement::Property getProperty(const std::string name) override;
-	void setProperty(const std::string name, const ThemeData::ThemeElement::Property& value) override;
+	ThemeData::ThemeElement::Property getProperty(unsigned int id) override;
+	void setProperty(unsigned int id, const ThemeData::ThemeElement::Property& value) override;
 	void setTargetIsMax() { mTargetIsMax = true; }
 
 	void setSaturation(float saturation);
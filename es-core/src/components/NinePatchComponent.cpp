@@ -334,47 +334,45 @@ void NinePatchComponent::onHide()
 		mTexture->setRequired(false);	
 }
 
-ThemeData::ThemeElement::Property NinePatchComponent::getProperty(const std::string name)
+ThemeData::ThemeElement::Property NinePatchComponent::getProperty(unsigned int id)
 {
-	Vector2f scale = getParent() ? getParent()->getSize() : Vector2f((float)Renderer::getScreenWidth(), (float)Renderer::getScreenHeight());
-
-	if (name == "color")
-		return mCenterColor;
-	else if (name == "centerColor")
+	switch (id)
+	{
+	case ThemeProperty::COLOR:
+	case ThemeProperty::CENTER_COLOR:
 		return mCenterColor;
-	else if (name == "edgeColor")
+	case ThemeProperty::EDGE_COLOR:
 		return mEdgeColor;
-	else if (name == "cornerSize")
+	case ThemeProperty::CORNER_SIZE:
 		return mCornerSize;
-	else if (name == "animateColor")
+	case ThemeProperty::ANIMATE_COLOR:
 		return mAnimateColor;
-	else if (name == "padding")
+	case ThemeProperty::PADDING:
 		return mPadding;
+	}
 
-	return GuiComponent::getProperty(name);
+	return GuiComponent::getProperty(id);
 }
 
-void NinePatchComponent::setProperty(const std::string name, const ThemeData::ThemeElement::Property& value)
+void NinePatchComponent::setProperty(unsigned int id, const ThemeData::ThemeElement::Property& value)
 {
-	Vector2f scale = getParent() ? getParent()->getSize() : Vector2f((float)Renderer::getScreenWidth(), (float)Renderer::getScreenHeight());
-
-	if (name == "color" && value.type == ThemeData::ThemeElement::Property::PropertyType::Int)
+	if (id == ThemeProperty::COLOR && value.type == ThemeData::ThemeElement::Property::PropertyType::Int)
 	{
 		setCenterColor(value.i);
 		setEdgeColor(value.i);
 	}
-	else if (name == "centerColor" && value.type == ThemeData::ThemeElement::Property::PropertyType::Int)
+	else if (id == ThemeProperty::CENTER_COLOR && value.type == ThemeData::ThemeElement::Property::PropertyType::Int)
 		setCenterColor(value.i);
-	else if (name == "edgeColor" && value.type == ThemeData::ThemeElement::Property::PropertyType::Int)
+	else if (id == ThemeProperty::EDGE_COLOR && value.type == ThemeData::ThemeElement::Property::PropertyType::Int)
 		setEdgeColor(value.i);
-	else if (name == "animateColor" && value.type == ThemeData::ThemeElement::Property::PropertyType::Int)
+	else if (id == ThemeProperty::ANIMATE_COLOR && value.type == ThemeData::ThemeElement::Property::PropertyType::Int)
 		setAnimateColor(value.i);
-	else if (name == "cornerSize" && value.type == ThemeData::ThemeElement::Property::PropertyType::Pair)
+	else if (id == ThemeProperty::CORNER_SIZE && value.type == ThemeData::ThemeElement::Property::PropertyType::Pair)
 		setCornerSize(value.v);
-	else if (name == "padding" && value.type == ThemeData::ThemeElement::Property::PropertyType::Rect)
+	else if (id == ThemeProperty::PADDING && value.type == ThemeData::ThemeElement::Property::PropertyType::Rect)
 		setPadding(value.r);
 	else
-		GuiComponent::setProperty(name, value);
+		GuiComponent::setProperty(id, value);
 }
 
 void NinePatchComponent::setPadding(const Vector4f padding) 
@@ -49,8 +49,8 @@ public:
 	virtual void onShow() override;
 	virtual void onHide() override;
 
-	ThemeData::ThemeElement::Property getProperty(const std::string name) override;
-	void setProperty(const std::string name, const ThemeData::ThemeElement::Property& value) override;
+	ThemeData::ThemeElement::Property getProperty(unsigned int id) override;
+	void setProperty(unsigned int id, const ThemeData::ThemeElement::Property& value) override;
 
 	Vector4f getPadding() { return mPadding; }
 	void setPadding(const Vector4f padding);
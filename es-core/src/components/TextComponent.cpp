@@ -606,58 +606,62 @@ void TextComponent::setAutoScroll(AutoScrollType value)
 	onSizeChanged();	
 }
 
-ThemeData::ThemeElement::Property TextComponent::getProperty(const std::string name)
+ThemeData::ThemeElement::Property TextComponent::getProperty(unsigned int id)
 {
 	Vector2f scale = getParent() ? getParent()->getSize() : Vector2f((float)Renderer::getScreenWidth(), (float)Renderer::getScreenHeight());
 
-	if (name == "size" || name == "maxSize" || name == "minSize")
+	switch (id)
+	{
+	case ThemeProperty::SIZE:
+	case ThemeProperty::MAX_SIZE:
+	case ThemeProperty::MIN_SIZE:
 		return mSize / scale;
-	else if (name == "color")
+	case ThemeProperty::COLOR:
 		return mColor;
-	else if (name == "backgroundColor")
+	case ThemeProperty::BACKGROUND_COLOR:
 		return mBgColor;
-	else if (name == "glowColor")
+	case ThemeProperty::GLOW_COLOR:
 		return mGlowColor;
-	else if (name == "glowSize")
+	case ThemeProperty::GLOW_SIZE:
 		return mGlowSize;
-	else if (name == "glowOffset")
+	case ThemeProperty::GLOW_OFFSET:
 		return mGlowOffset;
-	else if (name == "reflexion")
+	case ThemeProperty::REFLEXION:
 		return mReflection;
-	else if (name == "lineSpacing")
+	case ThemeProperty::LINE_SPACING:
 		return mLineSpacing;
-	else if (name == "text")
-		return mText;
-	else if (name == "value")
+	case ThemeProperty::TEXT:
+	case ThemeProperty::VALUE:
 		return mText;
+	}
 
-	return GuiComponent::getProperty(name);
+	return GuiComponent::getProperty(id);
 }
 
-void TextComponent::setProperty(const std::string name, const ThemeData::ThemeElement::Property& value)
+void TextComponent::setProperty(unsigned int id, const ThemeData::ThemeElement::Property& value)
 {
 	Vector2f scale = getParent() ? getParent()->getSize() : Vector2f((float)Renderer::getScreenWidth(), (float)Renderer::getScreenHeight());
 
-	if (name == "color" && value.type == ThemeData::ThemeElement::Property::PropertyType::Int)
+	if (id == ThemeProperty::COLOR && value.type == ThemeData::ThemeElement::Property::PropertyType::Int)
 		setColor(value.i);
-	else if (name == "backgroundColor" && value.type == ThemeData::ThemeElement::Property::PropertyType::Int)
+	else if (id == ThemeProperty::BACKGROUND_COLOR && value.type == ThemeData::ThemeElement::Property::PropertyType::Int)
 		setBackgroundColor(value.i);
-	else if (name == "glowColor" && value.type == ThemeData::ThemeElement::Property::PropertyType::Int)
+	else if (id == ThemeProperty::GLOW_COLOR && value.type == ThemeData::ThemeElement::Property::PropertyType::Int)
 		setGlowColor(value.i);
-	else if (name == "glowSize" && value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
+	else if (id == ThemeProperty::GLOW_SIZE && value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
 		setGlowSize(value.f);
-	else if (name == "glowOffset" && value.type == ThemeData::ThemeElement::Property::PropertyType::Pair)
+	else if (id == ThemeProperty::GLOW_OFFSET && value.type == ThemeData::ThemeElement::Property::PropertyType::Pair)
 		setGlowOffset(value.v.x(), value.v.y());
-	else if (name == "reflexion" && value.type == ThemeData::ThemeElement::Property::PropertyType::Pair)
+	else if (id == ThemeProperty::REFLEXION && value.type == ThemeData::ThemeElement::Property::PropertyType::Pair)
 		mReflection = value.v;
-	else if (name == "lineSpacing" && value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
+	else if (id == ThemeProperty::LINE_SPACING && value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
 		setLineSpacing(value.f);
-	else if (name == "text" && value.type == ThemeData::ThemeElement::Property::PropertyType::String)
+	else if (id == ThemeProperty::TEXT && value.type == ThemeData::ThemeElement::Property::PropertyType::String)
 		setText(value.s);	
-	else if (name == "value" && value.type == ThemeData::ThemeElement::Property::PropertyType::String)
+	else if (id == ThemeProperty::VALUE && value.type == ThemeData::ThemeElement::Property::PropertyType::String)
 		setValue(value.s);
 	else
-		GuiComponent::setProperty(name, value);
+		GuiComponent::setProperty(id, value);
 }
 
 void TextComponent::setPadding(const Vector4f padding) 
@@ -67,8 +67,8 @@ public:
 
 	std::string getOriginalThemeText() { return mSourceText; }
 
-	ThemeData::ThemeElement::Property getProperty(const std::string name) override;
-	void setProperty(const std::string name, const ThemeData::ThemeElement::Property& value) override;
+	ThemeData::ThemeElement::Property getProperty(unsigned int id) override;
+	void setProperty(unsigned int id, const ThemeData::ThemeElement::Property& value) override;
 
 	virtual void onShow() override;
 
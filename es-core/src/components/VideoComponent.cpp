@@ -615,14 +615,14 @@ void VideoComponent::setRoundCorners(float value)
 	mStaticImage.setRoundCorners(value);
 }
 
-void VideoComponent::setProperty(const std::string name, const ThemeData::ThemeElement::Property& value)
+void VideoComponent::setProperty(unsigned int id, const ThemeData::ThemeElement::Property& value)
 {
-	GuiComponent::setProperty(name, value);
+	GuiComponent::setProperty(id, value);
 
 	if (hasStoryBoard() && !mStaticImage.hasStoryBoard("snapshot"))
 	{
-		if (name == "offset" || name == "offsetX" || name == "offsetY" || name == "scale")
-			mStaticImage.setProperty(name, value);
+		if (id == ThemeProperty::OFFSET || id == ThemeProperty::OFFSET_X || id == ThemeProperty::OFFSET_Y || id == ThemeProperty::SCALE)
+			mStaticImage.setProperty(id, value);
 	}
 }
 
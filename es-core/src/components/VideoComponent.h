@@ -79,6 +79,9 @@ public:
 
 	virtual void update(int deltaTime);
 
+	// Prepares the videos that are likely to be played next (neighbour entries) without playing them
+	virtual void prewarmVideos(const std::vector<std::string>& paths) { }
+
 	// Resize the video to fit this size. If one axis is zero, scale that axis to maintain aspect ratio.
 	// If both are non-zero, potentially break the aspect ratio.  If both are zero, no resizing.
 	// Can be set before or after a video is loaded.
@@ -150,7 +153,7 @@ public:
 	bool getPlayAudio() { return mPlayAudio; }
 	void setPlayAudio(bool value) { mPlayAudio = value; }
 
-	void setProperty(const std::string name, const ThemeData::ThemeElement::Property& value) override;
+	void setProperty(unsigned int id, const ThemeData::ThemeElement::Property& value) override;
 
 	virtual void setClipRect(const Vector4f& vec);
 
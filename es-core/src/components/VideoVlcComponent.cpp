@@ -8,6 +8,10 @@
 #include <vlc/vlc.h>
 #include <SDL_mutex.h>
 #include <cmath>
+#include <cstring>
+#include <list>
+#include <thread>
+#include <condition_variable>
 #include "SystemConf.h"
 #include "ThemeData.h"
 #include <SDL_timer.h>
@@ -18,11 +22,231 @@
 #endif
 
 #include "ImageIO.h"
+#include "Log.h"
 
 #define MATHPI          3.141592653589793238462643383279502884L
 
+#define VIDEO_PLAYER_POOL_BUDGET	(48 * 1024 * 1024)	// Estimated bytes the idle players may keep
+#define VIDEO_PLAYER_POOL_FRAMES	3					// Pictures VLC may keep allocated for the last output of a player
+#define VIDEO_PLAYER_OVERHEAD		(1024 * 1024)		// Estimated memory of a player, without its pictures
+#define VIDEO_PREWARM_CACHE_SIZE	4
+
 libvlc_instance_t* VideoVlcComponent::mVLC = NULL;
 
+struct VlcMediaInfo
+{
+	VlcMediaInfo() : media(nullptr), width(0), height(0), hasAudioTrack(false) { }
+
+	std::string			path;
+	libvlc_media_t*		media;
+	unsigned int		width;
+	unsigned int		height;
+	bool				hasAudioTrack;
+};
+
+// Get the media metadata so we can find the aspect ratio
+static void parseMediaTracks(VlcMediaInfo& info)
+{
+	libvlc_media_parse(info.media);
+
+	libvlc_media_track_t** tracks;
+	unsigned track_count = libvlc_media_tracks_get(info.media, &tracks);
+	for (unsigned track = 0; track < track_count; ++track)
+	{
+		if (tracks[track]->i_type == libvlc_track_audio)
+			info.hasAudioTrack = true;
+		else if (tracks[track]->i_type == libvlc_track_video)
+		{
+			info.width = tracks[track]->video->i_width;
+			info.height = tracks[track]->video->i_height;
+
+			if (info.hasAudioTrack)
+				break;
+		}
+	}
+	libvlc_media_tracks_release(tracks, track_count);
+}
+
+// Idle media players, and medias of the neighbour entries already opened & demuxed by a worker thread, so starting them only needs the playback.
+// Idle players are stopped and parsed medias are not playing : none of them holds decoders, but a player may keep the pictures of its last output.
+class VlcMediaPool
+{
+public:
+	VlcMediaPool() : mVLC(nullptr), mRunning(false), mPooledBytes(0), mHits(0), mMisses(0) { }
+
+	~VlcMediaPool()
+	{
+		{
+			std::unique_lock<std::mutex> lock(mLock);
+			mRunning = false;
+		}
+
+		mEvent.notify_one();
+
+		if (mThread.joinable())
+			mThread.join();
+	}
+
+	// Only the latest requests matter : the previous ones are for entries the user already went through
+	void prewarm(libvlc_instance_t* vlc, const std::vector<std::string>& paths)
+	{
+		std::unique_lock<std::mutex> lock(mLock);
+
+		mVLC = vlc;
+		mQueue.clear();
+
+		for (auto path : paths)
+		{
+			if (path == mParsing || std::find_if(mMedias.cbegin(), mMedias.cend(), [path](const VlcMediaInfo& info) { return info.path == path; }) != mMedias.cend())
+				continue;
+
+			mQueue.push_back(path);
+		}
+
+		if (mQueue.empty())
+			return;
+
+		if (!mRunning)
+		{
+			mRunning = true;
+			mThread = std::thread(&VlcMediaPool::run, this);
+		}
+
+		mEvent.notify_one();
+	}
+
+	bool takeMedia(const std::string& path, VlcMediaInfo& info)
+	{
+		std::unique_lock<std::mutex> lock(mLock);
+
+		for (auto it = mMedias.begin(); it != mMedias.end(); ++it)
+		{
+			if (it->path != path)
+				continue;
+
+			info = *it;
+			mMedias.erase(it);
+			mHits++;
+			return true;
+		}
+
+		mMisses++;
+		return false;
+	}
+
+	libvlc_media_player_t* acquirePlayer(libvlc_media_t* media)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mLock);
+			if (!mPlayers.empty())
+			{
+				auto player = mPlayers.back();
+				mPlayers.pop_back();
+				mPooledBytes -= player.second;
+
+				libvlc_media_player_set_media(player.first, media);
+				return player.first;
+			}
+		}
+
+		return libvlc_media_player_new_from_media(media);
+	}
+
+	// The player must have been stopped. The pool is bounded by memory, not by count : VLC may keep the pictures of the last
+	// output of a player for reuse, so a player that rendered a large video costs much more to keep than one that rendered a small one.
+	void releasePlayer(libvlc_media_player_t* player, unsigned int width, unsigned int height)
+	{
+		size_t bytes = VIDEO_PLAYER_OVERHEAD + (size_t)width * height * 4 * VIDEO_PLAYER_POOL_FRAMES;
+
+		{
+			std::unique_lock<std::mutex> lock(mLock);
+			if (mPooledBytes + bytes <= VIDEO_PLAYER_POOL_BUDGET)
+			{
+				// The next owner sets its own output : the format callbacks must not point to this one's
+				libvlc_video_set_format_callbacks(player, NULL, NULL);
+				libvlc_media_player_set_media(player, NULL);
+				mPlayers.push_back(std::make_pair(player, bytes));
+				mPooledBytes += bytes;
+				return;
+			}
+		}
+
+		libvlc_media_player_release(player);
+	}
+
+	std::string getStatistics()
+	{
+		std::unique_lock<std::mutex> lock(mLock);
+		return "prewarmed " + std::to_string(mHits) + "/" + std::to_string(mHits + mMisses);
+	}
+
+private:
+	void run()
+	{
+		while (true)
+		{
+			VlcMediaInfo info;
+			libvlc_instance_t* vlc;
+
+			{
+				std::unique_lock<std::mutex> lock(mLock);
+				mEvent.wait(lock, [this] { return !mRunning || !mQueue.empty(); });
+
+				if (!mRunning)
+					return;
+
+				info.path = mQueue.front();
+				mQueue.pop_front();
+
+				mParsing = info.path;
+				vlc = mVLC;
+			}
+
+			info.media = libvlc_media_new_path(vlc, info.path.c_str());
+			if (info.media)
+				parseMediaTracks(info);
+
+			std::unique_lock<std::mutex> lock(mLock);
+			mParsing.clear();
+
+			if (info.media == nullptr)
+				continue;
+
+			if (info.width == 0 || info.height == 0)
+			{
+				libvlc_media_release(info.media);
+				continue;
+			}
+
+			mMedias.push_front(info);
+
+			while (mMedias.size() > VIDEO_PREWARM_CACHE_SIZE)
+			{
+				libvlc_media_release(mMedias.back().media);
+				mMedias.pop_back();
+			}
+		}
+	}
+
+	std::mutex							mLock;
+	std::condition_variable				mEvent;
+	std::thread							mThread;
+
+	libvlc_instance_t*					mVLC;
+	bool								mRunning;
+
+	std::list<std::string>				mQueue;
+	std::string							mParsing;
+	std::list<VlcMediaInfo>				mMedias;	// Most recent first
+	std::vector<std::pair<libvlc_media_player_t*, size_t>> mPlayers;	// Idle players & their estimated memory
+	size_t								mPooledBytes;
+
+	int									mHits;
+	int									mMisses;
+};
+
+static VlcMediaPool sMediaPool;
+
 // VLC prepares to render a video frame.
 static void *lock(void *data, void **p_pixels) 
 {
@@ -32,10 +256,39 @@ static void *lock(void *data, void **p_pixels)
 	
 	c->mutexes[frame].lock();
 	c->hasFrame[frame] = false;
-	*p_pixels = c->surfaces[frame];
+	p_pixels[0] = c->surfaces[frame];
+
+	if (c->planar)
+	{
+		unsigned char* planes[3];
+		unsigned int widths[3], heights[3];
+		c->getPlanes(c->surfaces[frame], planes, widths, heights);
+
+		p_pixels[1] = planes[1];
+		p_pixels[2] = planes[2];
+	}
+
 	return NULL; // Picture identifier, not needed here.
 }
 
+// VLC negociates the output format : ask for I420 planes at the size we computed, VLC scales & converts if needed.
+static unsigned setupPlanarFormat(void** opaque, char* chroma, unsigned* width, unsigned* height, unsigned* pitches, unsigned* lines)
+{
+	struct VideoContext *c = (struct VideoContext *)*opaque;
+	if (c == NULL || !c->valid || !c->planar)
+		return 0;
+
+	memcpy(chroma, "I420", 4);
+
+	*width = c->width;
+	*height = c->height;
+
+	unsigned char* planes[3];
+	c->getPlanes(c->surfaces[0], planes, pitches, lines);
+
+	return 1;
+}
+
 // VLC just rendered a video frame.
 static void unlock(void *data, void* /*id*/, void *const* /*p_pixels*/) 
 {
@@ -64,6 +317,7 @@ VideoVlcComponent::VideoVlcComponent(Window* window) :
 	mMediaPlayer(nullptr), 
 	mMedia(nullptr)
 {
+	mPlanes[0] = mPlanes[1] = mPlanes[2] = 0;
 	mSaturation = 1.0f;
 	mElapsed = 0;
 	mColorShift = 0xFFFFFFFF;
@@ -71,6 +325,7 @@ VideoVlcComponent::VideoVlcComponent(Window* window) :
 
 	mLoops = -1;
 	mCurrentLoop = 0;
+	mStartTime = 0;
 
 	// Get an empty texture for rendering the video
 	mTexture = nullptr;// TextureResource::get("");
@@ -83,6 +338,7 @@ VideoVlcComponent::VideoVlcComponent(Window* window) :
 VideoVlcComponent::~VideoVlcComponent()
 {
 	stopVideo();
+	releasePlanes();
 }
 
 void VideoVlcComponent::setResize(float width, float height)
@@ -125,11 +381,41 @@ void VideoVlcComponent::onVideoStarted()
 {
 	VideoComponent::onVideoStarted();
 	resize();
+
+	if (mStartTime != 0)
+	{
+		LOG(LogDebug) << "VideoVlcComponent : " << mPlayingVideoPath << " started in " << (SDL_GetTicks() - mStartTime) << "ms (" << sMediaPool.getStatistics() << ")";
+		mStartTime = 0;
+	}
+}
+
+void VideoVlcComponent::prewarmVideos(const std::vector<std::string>& paths)
+{
+	init();
+
+	if (mVLC == nullptr)
+		return;
+
+	std::vector<std::string> medias;
+
+	for (auto path : paths)
+	{
+		if (path.empty() || path == mVideoPath)
+			continue;
+
+#ifdef WIN32
+		medias.push_back(Utils::String::replace(path, "/", "\\"));
+#else
+		medias.push_back(path);
+#endif
+	}
+
+	sMediaPool.prewarm(mVLC, medias);
 }
 
 void VideoVlcComponent::resize()
 {
-	if(!mTexture)
+	if (!mTexture && mPlanes[0] == 0)
 		return;
 
 	const Vector2f textureSize((float)mVideoWidth, (float)mVideoHeight);
@@ -187,7 +473,8 @@ void VideoVlcComponent::resize()
 		}
 
 	// mSize.y() should already be rounded
-	mTexture->rasterizeAt((size_t)Math::round(mSize.x()), (size_t)Math::round(mSize.y()));
+	if (mTexture)
+		mTexture->rasterizeAt((size_t)Math::round(mSize.x()), (size_t)Math::round(mSize.y()));
 
 	onSizeChanged();
 }
@@ -210,7 +497,7 @@ void VideoVlcComponent::render(const Transform4x4f& parentTrans)
 	{
 		// If video is still attached to the path & texture is initialized, we suppose it had just been stopped (onhide, ondisable, screensaver...)
 		// still render the last frame
-		if (mTexture != nullptr && !mVideoPath.empty() && mPlayingVideoPath == mVideoPath && mTexture->isLoaded())
+		if (!mVideoPath.empty() && mPlayingVideoPath == mVideoPath && ((mTexture != nullptr && mTexture->isLoaded()) || mPlanes[0] != 0))
 			initFromPixels = false;
 		else
 			return;
@@ -242,10 +529,25 @@ void VideoVlcComponent::render(const Transform4x4f& parentTrans)
 	// Build a texture for the video frame
 	if (initFromPixels)
 	{		
+		// Frames are only uploaded when VLC has delivered a new one since the last upload
 		int frame = mContext.surfaceId;
 		if (mContext.hasFrame[frame])
 		{
-			if (mTexture == nullptr)
+			if (mContext.planar)
+			{
+				if (mPlanes[0] == 0)
+				{
+					mContext.mutexes[frame].lock();
+					uploadPlanes(mContext.surfaces[frame]);
+					mContext.hasFrame[frame] = false;
+					mContext.mutexes[frame].unlock();
+
+					resize();
+					trans = parentTrans * getTransform();
+					Renderer::setMatrix(trans);
+				}
+			}
+			else if (mTexture == nullptr)
 			{
 				mTexture = TextureResource::get("", false, mLinearSmooth);
 
@@ -257,12 +559,21 @@ void VideoVlcComponent::render(const Transform4x4f& parentTrans)
 #ifdef _RPI_
 			// Rpi : A lot of videos are encoded in 60fps on screenscraper
 			// Try to limit transfert to opengl textures to 30fps to save CPU
-			if (!Settings::getInstance()->getBool("OptimizeVideo") || mElapsed >= 40) // 40ms = 25fps, 33.33 = 30 fps
+			if (!Settings::OptimizeVideo() || mElapsed >= 40) // 40ms = 25fps, 33.33 = 30 fps
 #endif
 			{
 				mContext.mutexes[frame].lock();
-				mTexture->updateFromExternalPixels(mContext.surfaces[frame], mVideoWidth, mVideoHeight);
-				mContext.hasFrame[frame] = false;
+
+				if (mContext.hasFrame[frame])
+				{
+					if (mContext.planar)
+						uploadPlanes(mContext.surfaces[frame]);
+					else
+						mTexture->updateFromExternalPixels(mContext.surfaces[frame], mVideoWidth, mVideoHeight);
+
+					mContext.hasFrame[frame] = false;
+				}
+
 				mContext.mutexes[frame].unlock();
 
 				mElapsed = 0;
@@ -270,7 +581,8 @@ void VideoVlcComponent::render(const Transform4x4f& parentTrans)
 		}
 	}
 
-	if (mTexture == nullptr)
+	bool planar = mPlanes[0] != 0 && mTexture == nullptr;
+	if (mTexture == nullptr && !planar)
 		return;
 		
 	float opacity = (mOpacity / 255.0f) * t;
@@ -345,7 +657,7 @@ void VideoVlcComponent::render(const Transform4x4f& parentTrans)
 	for(int i = 0; i < 4; ++i)
 		vertices[i].pos.round();
 	
-	if (mTexture->bind())
+	if (planar || mTexture->bind())
 	{
 		beginCustomClipRect();
 
@@ -376,14 +688,18 @@ void VideoVlcComponent::render(const Transform4x4f& parentTrans)
 			float radius = Math::max(size_x, size_y) * mRoundCorners;
 			Renderer::enableRoundCornerStencil(x, y, size_x, size_y, radius);
 
-			mTexture->bind();
+			if (!planar)
+				mTexture->bind();
 		}
 
 		// Render it
 		vertices->saturation = mSaturation;
 		vertices->customShader = mCustomShader.empty() ? nullptr : (char*)mCustomShader.c_str();
 
-		Renderer::drawTriangleStrips(&vertices[0], 4);
+		if (planar)
+			Renderer::drawYuvTriangleStrips(&vertices[0], 4, mPlanes);
+		else
+			Renderer::drawTriangleStrips(&vertices[0], 4);
 
 		if (mRoundCorners > 0)
 			Renderer::disableStencil();
@@ -402,9 +718,11 @@ void VideoVlcComponent::setupContext()
 	if (mContext.valid)
 		return;
 	
-	// Create an RGBA surface to render the video into
-	mContext.surfaces[0] = new unsigned char[mVideoWidth * mVideoHeight * 4];
-	mContext.surfaces[1] = new unsigned char[mVideoWidth * mVideoHeight * 4];
+	// Create an RGBA or I420 surface to render the video into
+	mContext.width = mVideoWidth;
+	mContext.height = mVideoHeight;
+	mContext.surfaces[0] = new unsigned char[mContext.getSurfaceSize()];
+	mContext.surfaces[1] = new unsigned char[mContext.getSurfaceSize()];
 	mContext.hasFrame[0] = false;	
 	mContext.hasFrame[1] = false;
 	mContext.component = this;
@@ -421,6 +739,7 @@ void VideoVlcComponent::freeContext()
 	{
 		// Release texture memory -> except if mDisable by topWindow ( ex: menu was poped )
 		mTexture = nullptr;
+		releasePlanes();
 	}
 
 	delete[] mContext.surfaces[0];
@@ -430,9 +749,36 @@ void VideoVlcComponent::freeContext()
 	mContext.hasFrame[0] = false;
 	mContext.hasFrame[1] = false;
 	mContext.component = NULL;
+	mContext.planar = false;
 	mContext.valid = false;			
 }
 
+void VideoVlcComponent::uploadPlanes(unsigned char* surface)
+{
+	unsigned char* planes[3];
+	unsigned int widths[3], heights[3];
+	mContext.getPlanes(surface, planes, widths, heights);
+
+	for (int i = 0; i < 3; i++)
+	{
+		if (mPlanes[i] == 0)
+			mPlanes[i] = Renderer::createTexture(Renderer::Texture::LUMINANCE, i > 0 || mLinearSmooth, false, widths[i], heights[i], planes[i]);
+		else
+			Renderer::updateTexture(mPlanes[i], Renderer::Texture::LUMINANCE, 0, 0, widths[i], heights[i], planes[i]);
+	}
+}
+
+void VideoVlcComponent::releasePlanes()
+{
+	for (int i = 0; i < 3; i++)
+	{
+		if (mPlanes[i] != 0)
+			Renderer::destroyTexture(mPlanes[i]);
+
+		mPlanes[i] = 0;
+	}
+}
+
 void VideoVlcComponent::init()
 {
 	if (mVLC != nullptr)
@@ -525,6 +871,7 @@ void VideoVlcComponent::startVideo()
 		startStoryboard();
 
 	mTexture = nullptr;
+	releasePlanes();
 	mCurrentLoop = 0;
 	mVideoWidth = 0;
 	mVideoHeight = 0;
@@ -540,8 +887,18 @@ void VideoVlcComponent::startVideo()
 		// Set the video that we are going to be playing so we don't attempt to restart it
 		mPlayingVideoPath = mVideoPath;
 
-		// Open the media
-		mMedia = libvlc_media_new_path(mVLC, path.c_str());
+		mStartTime = SDL_GetTicks();
+
+		// Open the media, unless it has been prewarmed
+		VlcMediaInfo info;
+		bool prewarmed = sMediaPool.takeMedia(path, info);
+		if (!prewarmed)
+		{
+			info.path = path;
+			info.media = libvlc_media_new_path(mVLC, path.c_str());
+		}
+
+		mMedia = info.media;
 		if (mMedia)
 		{			
 			// use : vlc long-help
@@ -560,27 +917,12 @@ void VideoVlcComponent::startVideo()
 			if (mPlaylist != nullptr && mConfig.startDelay == 0 && !mConfig.showSnapshotDelay && !mConfig.showSnapshotNoVideo)
 				libvlc_media_add_option(mMedia, ":start-time=0.7");			
 
-			bool hasAudioTrack = false;
+			if (!prewarmed)
+				parseMediaTracks(info);
 
-			unsigned track_count;
-			// Get the media metadata so we can find the aspect ratio
-			libvlc_media_parse(mMedia);
-			libvlc_media_track_t** tracks;
-			track_count = libvlc_media_tracks_get(mMedia, &tracks);
-			for (unsigned track = 0; track < track_count; ++track)
-			{
-				if (tracks[track]->i_type == libvlc_track_audio)
-					hasAudioTrack = true;
-				else if (tracks[track]->i_type == libvlc_track_video)
-				{
-					mVideoWidth = tracks[track]->video->i_width;
-					mVideoHeight = tracks[track]->video->i_height;		
-
-					if (hasAudioTrack)
-						break;
-				}
-			}
-			libvlc_media_tracks_release(tracks, track_count);
+			bool hasAudioTrack = info.hasAudioTrack;
+			mVideoWidth = info.width;
+			mVideoHeight = info.height;
 
 			// Make sure we found a valid video track
 			if ((mVideoWidth > 0) && (mVideoHeight > 0))
@@ -610,23 +952,47 @@ void VideoVlcComponent::startVideo()
 					}
 				}
 
+				// Let the GPU convert planar YUV frames, instead of having VLC converting them to RGBA on the CPU.
+				// Custom shaders expect RGBA textures.
+				mContext.planar = mCustomShader.empty() && Settings::getInstance()->getBool("VideoPlanarYuv") && Renderer::supportsYuvTextures();
+				if (mContext.planar)
+				{
+					// I420 chroma planes are half sized
+					mVideoWidth &= ~1;
+					mVideoHeight &= ~1;
+				}
+
 				PowerSaver::pause();
 				setupContext();
 
-				// Setup the media player
-				mMediaPlayer = libvlc_media_player_new_from_media(mMedia);
+				// Setup the media player, reusing an idle one if possible
+				mMediaPlayer = sMediaPool.acquirePlayer(mMedia);
 			
 				if (hasAudioTrack)
 				{
 					if (!getPlayAudio() || (!mScreensaverMode && !Settings::getInstance()->getBool("VideoAudio")) || (Settings::getInstance()->getBool("ScreenSaverVideoMute") && mScreensaverMode))
 						libvlc_audio_set_mute(mMediaPlayer, 1);
 					else
+					{
+						// A pooled player may have been muted by its previous owner
+						libvlc_audio_set_mute(mMediaPlayer, 0);
 						AudioManager::setVideoPlaying(true);
+					}
 				}
 
-				libvlc_media_player_play(mMediaPlayer);
 				libvlc_video_set_callbacks(mMediaPlayer, lock, unlock, display, (void*)&mContext);
-				libvlc_video_set_format(mMediaPlayer, "RGBA", (int)mVideoWidth, (int)mVideoHeight, (int)mVideoWidth * 4);
+
+				if (mContext.planar)
+					libvlc_video_set_format_callbacks(mMediaPlayer, setupPlanarFormat, NULL);
+				else
+				{
+					// A pooled player may still have the planar format callbacks of its previous owner
+					libvlc_video_set_format_callbacks(mMediaPlayer, NULL, NULL);
+					libvlc_video_set_format(mMediaPlayer, "RGBA", (int)mVideoWidth, (int)mVideoHeight, (int)mVideoWidth * 4);
+				}
+
+				// Output format must be set before the video output is created
+				libvlc_media_player_play(mMediaPlayer);
 			}
 		}
 	}
@@ -638,14 +1004,16 @@ void VideoVlcComponent::stopVideo()
 	mIsWaitingForVideoToStart = false;
 	mStartDelayed = false;
 
-	// Release the media player so it stops calling back to us
+	// Stop the media player so it stops calling back to us, then give it back to the pool
 	if (mMediaPlayer)
 	{
 		libvlc_media_player_stop(mMediaPlayer);
-		libvlc_media_player_release(mMediaPlayer);
+		sMediaPool.releasePlayer(mMediaPlayer, mVideoWidth, mVideoHeight);
 		mMediaPlayer = NULL;
 	}
 
+	mStartTime = 0;
+
 	// Release the media
 	if (mMedia)
 	{
@@ -730,42 +1098,44 @@ void VideoVlcComponent::onShow()
 		pauseStoryboard();
 }
 
-ThemeData::ThemeElement::Property VideoVlcComponent::getProperty(const std::string name)
+ThemeData::ThemeElement::Property VideoVlcComponent::getProperty(unsigned int id)
 {
 	Vector2f scale = getParent() ? getParent()->getSize() : Vector2f((float)Renderer::getScreenWidth(), (float)Renderer::getScreenHeight());
 
-	if (name == "size" || name == "maxSize" || name == "minSize")
+	switch (id)
+	{
+	case ThemeProperty::SIZE:
+	case ThemeProperty::MAX_SIZE:
+	case ThemeProperty::MIN_SIZE:
 		return mSize / scale;
-
-	if (name == "color")
+	case ThemeProperty::COLOR:
 		return mColorShift;
-
-	if (name == "roundCorners")
+	case ThemeProperty::ROUND_CORNERS:
 		return mRoundCorners;
-
-	if (name == "saturation")
+	case ThemeProperty::SATURATION:
 		return mSaturation;
+	}
 
-	return VideoComponent::getProperty(name);
+	return VideoComponent::getProperty(id);
 }
 
-void VideoVlcComponent::setProperty(const std::string name, const ThemeData::ThemeElement::Property& value)
+void VideoVlcComponent::setProperty(unsigned int id, const ThemeData::ThemeElement::Property& value)
 {
 	Vector2f scale = getParent() ? getParent()->getSize() : Vector2f((float)Renderer::getScreenWidth(), (float)Renderer::getScreenHeight());
 
-	if ((name == "maxSize" || name == "minSize") && value.type == ThemeData::ThemeElement::Property::PropertyType::Pair)
+	if ((id == ThemeProperty::MAX_SIZE || id == ThemeProperty::MIN_SIZE) && value.type == ThemeData::ThemeElement::Property::PropertyType::Pair)
 	{
 		mTargetSize = Vector2f(value.v.x() * scale.x(), value.v.y() * scale.y());
 		resize();
 	}
-	else if (name == "color" && value.type == ThemeData::ThemeElement::Property::PropertyType::Int)
+	else if (id == ThemeProperty::COLOR && value.type == ThemeData::ThemeElement::Property::PropertyType::Int)
 		setColorShift(value.i);
-	else if (name == "roundCorners" && value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
+	else if (id == ThemeProperty::ROUND_CORNERS && value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
 		setRoundCorners(value.f);
-	else if (name == "saturation" && value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
+	else if (id == ThemeProperty::SATURATION && value.type == ThemeData::ThemeElement::Property::PropertyType::Float)
 		setSaturation(value.f);
 	else
-		VideoComponent::setProperty(name, value);
+		VideoComponent::setProperty(id, value);
 }
 
 
@@ -21,6 +21,9 @@ struct VideoContext
 		hasFrame[0] = false;
 		hasFrame[1] = false;
 		surfaceId = 0;
+		planar = false;
+		width = 0;
+		height = 0;
 	}
 
 	int					surfaceId;
@@ -28,6 +31,32 @@ struct VideoContext
 	std::mutex			mutexes[2];
 	bool				hasFrame[2];
 
+	// Planar frames are I420 : Y plane, then U & V planes at half resolution, in the same surface
+	bool				planar;
+	unsigned int		width;
+	unsigned int		height;
+
+	size_t getSurfaceSize() const
+	{
+		if (!planar)
+			return (size_t)width * height * 4;
+
+		return (size_t)width * height + 2 * (size_t)(width / 2) * (height / 2);
+	}
+
+	// Start & size of the Y, U and V planes of a planar surface. Rows are not padded : the pitch is the width
+	void getPlanes(unsigned char* surface, unsigned char** planes, unsigned int* widths, unsigned int* heights) const
+	{
+		widths[0] = width;
+		heights[0] = height;
+		widths[1] = widths[2] = width / 2;
+		heights[1] = heights[2] = height / 2;
+
+		planes[0] = surface;
+		planes[1] = planes[0] + (size_t)widths[0] * heights[0];
+		planes[2] = planes[1] + (size_t)widths[1] * heights[1];
+	}
+
 	VideoComponent*		component;
 	bool				valid;	
 };
@@ -82,8 +111,8 @@ public:
 
 	virtual void onShow() override;
 
-	ThemeData::ThemeElement::Property getProperty(const std::string name) override;
-	void setProperty(const std::string name, const ThemeData::ThemeElement::Property& value) override;
+	ThemeData::ThemeElement::Property getProperty(unsigned int id) override;
+	void setProperty(unsigned int id, const ThemeData::ThemeElement::Property& value) override;
 
 	void setEffect(VideoVlcFlags::VideoVlcEffect effect) { mEffect = effect; }
 
@@ -92,6 +121,8 @@ public:
 
 	void setSaturation(float saturation);
 
+	void prewarmVideos(const std::vector<std::string>& paths) override;
+
 private:
 	// Calculates the correct mSize from our resizing information (set by setResize/setMaxSize).
 	// Used internally whenever the resizing parameters or texture change.
@@ -113,12 +144,16 @@ private:
 	void setupContext();
 	void freeContext();
 
+	void uploadPlanes(unsigned char* surface);
+	void releasePlanes();
+
 private:
 	static libvlc_instance_t*		mVLC;
 	libvlc_media_t*					mMedia;
 	libvlc_media_player_t*			mMediaPlayer;
 	VideoContext					mContext;
 	std::shared_ptr<TextureResource> mTexture;
+	unsigned int					mPlanes[3];
 
 	std::string					    mSubtitlePath;
 	std::string					    mSubtitleTmpFile;
@@ -134,6 +169,8 @@ private:
 
 	bool							mLinearSmooth;
 	float							mSaturation;
+
+	unsigned int					mStartTime;
 };
 
 #endif // ES_CORE_COMPONENTS_VIDEO_VLC_COMPONENT_H
@@ -890,4 +890,14 @@ namespace Renderer
 		return Instance()->getTotalMemUsage();
 	}
 
+	bool supportsYuvTextures()
+	{
+		return Instance()->supportsYuvTextures();
+	}
+
+	bool drawYuvTriangleStrips(const Vertex* _vertices, const unsigned int _numVertices, const unsigned int* _planes, const Blend::Factor _srcBlendFactor, const Blend::Factor _dstBlendFactor)
+	{
+		return Instance()->drawYuvTriangleStrips(_vertices, _numVertices, _planes, _srcBlendFactor, _dstBlendFactor);
+	}
+
 } // Renderer::
@@ -35,8 +35,9 @@ namespace Renderer
 	{
 		enum Type
 		{
-			RGBA  = 0,
-			ALPHA = 1
+			RGBA      = 0,
+			ALPHA     = 1,
+			LUMINANCE = 2	// Single 8 bit channel, used for the planes of YUV video frames
 
 		}; // Type
 
@@ -119,6 +120,10 @@ namespace Renderer
 		virtual void         swapBuffers() = 0;
 
 		virtual size_t		 getTotalMemUsage() { return (size_t) -1; };
+
+		// Planar YUV (I420) rendering : Y, U & V planes are LUMINANCE textures converted to RGB by a shader
+		virtual bool		 supportsYuvTextures() { return false; }
+		virtual bool		 drawYuvTriangleStrips(const Vertex* _vertices, const unsigned int _numVertices, const unsigned int* _planes, const Blend::Factor _srcBlendFactor = Blend::SRC_ALPHA, const Blend::Factor _dstBlendFactor = Blend::ONE_MINUS_SRC_ALPHA) { return false; }
 	};
 	
 	std::vector<std::string> getRendererNames();
@@ -171,6 +176,9 @@ namespace Renderer
 
 	size_t		 getTotalMemUsage  ();
 
+	bool		 supportsYuvTextures  ();
+	bool		 drawYuvTriangleStrips(const Vertex* _vertices, const unsigned int _numVertices, const unsigned int* _planes, const Blend::Factor _srcBlendFactor = Blend::SRC_ALPHA, const Blend::Factor _dstBlendFactor = Blend::ONE_MINUS_SRC_ALPHA);
+
 	std::string  getDriverName();
 	std::vector<std::pair<std::string, std::string>> getDriverInformation();
 
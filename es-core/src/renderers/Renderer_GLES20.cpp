@@ -34,6 +34,8 @@ namespace Renderer
 	static ShaderProgram    shaderProgramColorTexture;
 	static ShaderProgram    shaderProgramColorNoTexture;
 	static ShaderProgram    shaderProgramAlpha;
+	static ShaderProgram    shaderProgramYuv;
+	static bool				shaderProgramYuvLinked = false;
 
 	static GLuint			vertexBuffer     = 0;
 
@@ -221,7 +223,47 @@ namespace Renderer
 		auto fragmentShaderAlpha = Shader::createShader(GL_FRAGMENT_SHADER, fragmentSourceAlpha);
 
 		shaderProgramAlpha.createShaderProgram(vertexShaderAlpha, fragmentShaderAlpha);
-		
+
+		// fragment shader (planar YUV video frames, BT.601 limited range)
+		std::string fragmentSourceYuv =
+			SHADER_VERSION_STRING +
+			R"=====(
+			#ifdef GL_ES
+			precision mediump float;
+			precision mediump sampler2D;
+			#endif		
+
+			varying   vec4      v_col;
+			varying   vec2      v_tex;
+			uniform   sampler2D u_tex;
+			uniform   sampler2D u_texU;
+			uniform   sampler2D u_texV;
+			uniform   float saturation;
+			void main(void)
+			{
+			    float y = 1.1643 * (texture2D(u_tex, v_tex).r - 0.0625);
+			    float u = texture2D(u_texU, v_tex).r - 0.5;
+			    float v = texture2D(u_texV, v_tex).r - 0.5;
+
+			    vec4 clr = vec4(y + 1.5958 * v, y - 0.39173 * u - 0.8129 * v, y + 2.017 * u, 1.0) * v_col;
+
+			    if (saturation != 1.0) {
+			    	vec3 gray = vec3(dot(clr.rgb, vec3(0.34, 0.55, 0.11)));
+			    	vec3 blend = mix(gray, clr.rgb, saturation);
+			    	clr = vec4(blend, clr.a);
+			    }
+
+			    gl_FragColor = clr;
+			}
+			)=====";
+
+		auto vertexShaderYuv = Shader::createShader(GL_VERTEX_SHADER, vertexSourceTexture);
+		auto fragmentShaderYuv = Shader::createShader(GL_FRAGMENT_SHADER, fragmentSourceYuv);
+
+		shaderProgramYuvLinked = shaderProgramYuv.createShaderProgram(vertexShaderYuv, fragmentShaderYuv);
+		if (!shaderProgramYuvLinked)
+			LOG(LogWarning) << "YUV shader is not available, videos will be converted to RGBA";
+
 		useProgram(nullptr);
 
 	} // setupDefaultShaders
@@ -268,6 +310,7 @@ namespace Renderer
 #else
 			case Texture::ALPHA: { return GL_LUMINANCE_ALPHA; } break;
 #endif
+			case Texture::LUMINANCE: { return GL_LUMINANCE; } break;
 			default:             { return GL_ZERO;            }
 		}
 
@@ -866,13 +909,67 @@ namespace Renderer
 		{
 			if (tex.first != 0 && tex.second)
 			{
-				size_t size = tex.second->size.x() * tex.second->size.y() * (tex.second->type == GL_ALPHA ? 1 : 4);
+				size_t size = tex.second->size.x() * tex.second->size.y() * (tex.second->type == GL_ALPHA || tex.second->type == GL_LUMINANCE ? 1 : 4);
 				total += size;
 			}
 		}	
 
 		return total;
 	}
+
+	static void activeTexture(GLenum _unit)
+	{
+#if OPENGL_EXTENSIONS
+		GL_CHECK_ERROR(glActiveTexture_(_unit));
+#else
+		GL_CHECK_ERROR(glActiveTexture(_unit));
+#endif
+	}
+
+	bool GLES20Renderer::supportsYuvTextures()
+	{
+		return shaderProgramYuvLinked;
+	}
+
+	bool GLES20Renderer::drawYuvTriangleStrips(const Vertex* _vertices, const unsigned int _numVertices, const unsigned int* _planes, const Blend::Factor _srcBlendFactor, const Blend::Factor _dstBlendFactor)
+	{
+		if (!shaderProgramYuvLinked || _planes == nullptr || _planes[0] == 0 || _planes[1] == 0 || _planes[2] == 0)
+			return false;
+
+		// Chroma planes go to units 1 & 2, the luma plane is bound on unit 0 like any other texture
+		activeTexture(GL_TEXTURE1);
+		GL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, _planes[1]));
+		activeTexture(GL_TEXTURE2);
+		GL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, _planes[2]));
+		activeTexture(GL_TEXTURE0);
+		bindTexture(_planes[0]);
+
+		GL_CHECK_ERROR(glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * _numVertices, _vertices, GL_DYNAMIC_DRAW));
+
+		useProgram(&shaderProgramYuv);
+		shaderProgramYuv.setSaturation(_vertices->saturation);
+
+		if (_srcBlendFactor != Blend::ONE && _dstBlendFactor != Blend::ONE)
+		{
+			GL_CHECK_ERROR(glEnable(GL_BLEND));
+			GL_CHECK_ERROR(glBlendFunc(convertBlendFactor(_srcBlendFactor), convertBlendFactor(_dstBlendFactor)));
+			GL_CHECK_ERROR(glDrawArrays(GL_TRIANGLE_STRIP, 0, _numVertices));
+			GL_CHECK_ERROR(glDisable(GL_BLEND));
+		}
+		else
+		{
+			GL_CHECK_ERROR(glDisable(GL_BLEND));
+			GL_CHECK_ERROR(glDrawArrays(GL_TRIANGLE_STRIP, 0, _numVertices));
+		}
+
+		activeTexture(GL_TEXTURE1);
+		GL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, 0));
+		activeTexture(GL_TEXTURE2);
+		GL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, 0));
+		activeTexture(GL_TEXTURE0);
+
+		return true;
+	}
 } // Renderer::
 
 #endif // USE_OPENGLES_20
@@ -45,6 +45,9 @@ namespace Renderer
 		void         swapBuffers() override;
 
 		size_t		getTotalMemUsage() override;
+
+		bool		supportsYuvTextures() override;
+		bool		drawYuvTriangleStrips(const Vertex* _vertices, const unsigned int _numVertices, const unsigned int* _planes, const Blend::Factor _srcBlendFactor = Blend::SRC_ALPHA, const Blend::Factor _dstBlendFactor = Blend::ONE_MINUS_SRC_ALPHA) override;
 	};
 }
 
@@ -216,6 +216,21 @@ namespace Renderer
 			GL_CHECK_ERROR(glUseProgram(mId));
 			GL_CHECK_ERROR(glUniform1i(texUniform, 0));
 		}
+
+		// Chroma planes of YUV programs are bound to the next texture units
+		GLint texUUniform = glGetUniformLocation(mId, "u_texU");
+		GLint texVUniform = glGetUniformLocation(mId, "u_texV");
+
+		if (texUUniform != -1 || texVUniform != -1)
+		{
+			GL_CHECK_ERROR(glUseProgram(mId));
+
+			if (texUUniform != -1)
+				GL_CHECK_ERROR(glUniform1i(texUUniform, 1));
+
+			if (texVUniform != -1)
+				GL_CHECK_ERROR(glUniform1i(texVUniform, 2));
+		}
 	}
 
 	void ShaderProgram::setSaturation(GLfloat saturation)
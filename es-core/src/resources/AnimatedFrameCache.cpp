@@ -0,0 +1,221 @@
+#include "resources/AnimatedFrameCache.h"
+
+#include "resources/ResourceManager.h"
+#include "utils/FileSystemUtil.h"
+#include "Log.h"
+#include <string.h>
+
+// Modification time & size of the file : a changed file is decoded again
+static std::string getFileStamp(const std::string& path)
+{
+	auto resPath = ResourceManager::getInstance()->getResourcePath(path);
+	return std::to_string(Utils::FileSystem::getFileModificationDate(resPath).getTime()) + "-" + std::to_string(Utils::FileSystem::getFileSize(resPath));
+}
+
+AnimatedFrameCache::AnimatedFrameCache(size_t maxCost, size_t maxCount) : mMaxCost(maxCost), mMaxCount(maxCount), mRunning(false), mCost(0)
+{
+}
+
+AnimatedFrameCache::~AnimatedFrameCache()
+{
+	{
+		std::unique_lock<std::mutex> lock(mLock);
+		mRunning = false;
+	}
+
+	mEvent.notify_one();
+	mFrameDecoded.notify_all();
+
+	if (mThread.joinable())
+		mThread.join();
+}
+
+unsigned char* AnimatedFrameCache::getFrame(const std::string& path, int index, MaxSizeInfo& maxSize, size_t& width, size_t& height, Vector2i& baseSize, Vector2i& packedSize)
+{
+	std::string stamp = getFileStamp(path);
+	std::string key = path + "|" + std::to_string((int)maxSize.x()) + "x" + std::to_string((int)maxSize.y()) + (maxSize.externalZoom() ? "z" : "");
+
+	std::unique_lock<std::mutex> lock(mLock);
+
+	std::shared_ptr<Source> source;
+
+	auto it = mSources.find(key);
+	if (it != mSources.cend())
+	{
+		if (it->second->stamp == stamp)
+		{
+			source = it->second;
+			mOrder.remove(key);
+			mOrder.push_back(key);
+
+			// Still waiting for the worker : it will be the next source decoded
+			if (source->state == FRAMES_QUEUED)
+			{
+				mQueue.remove(source);
+				mQueue.push_front(source);
+			}
+		}
+		else
+			evict(it->second);
+	}
+
+	if (source == nullptr)
+	{
+		source = std::make_shared<Source>();
+		source->path = path;
+		source->key = key;
+		source->stamp = stamp;
+		source->maxSize = maxSize;
+
+		mSources[key] = source;
+		mOrder.push_back(key);
+
+		// The source being displayed is decoded before the ones that were requested earlier
+		mQueue.push_front(source);
+
+		if (!mRunning)
+		{
+			mRunning = true;
+			mThread = std::thread(&AnimatedFrameCache::run, this);
+		}
+
+		mEvent.notify_one();
+	}
+
+	// The worker may be busy with other sources : rather than waiting behind them, the caller decodes the frame itself
+	if (source->state == FRAMES_QUEUED)
+		return nullptr;
+
+	// Frames are published as soon as they are decoded : only the requested one is waited for
+	mFrameDecoded.wait(lock, [source, index, this] { return !mRunning || source->state == FRAMES_DECODED || source->state == FRAMES_UNCACHEABLE || (int)source->frames.size() > index; });
+
+	if (index < 0 || index >= (int)source->frames.size())
+		return nullptr;
+
+	auto& frame = source->frames[index];
+
+	width = frame.width;
+	height = frame.height;
+	baseSize = frame.baseSize;
+	packedSize = frame.packedSize;
+
+	size_t size = frame.width * frame.height * 4;
+	unsigned char* dataRGBA = new unsigned char[size];
+	memcpy(dataRGBA, frame.data.get(), size);
+	return dataRGBA;
+}
+
+size_t AnimatedFrameCache::getCost()
+{
+	std::unique_lock<std::mutex> lock(mLock);
+	return mCost;
+}
+
+size_t AnimatedFrameCache::getSourceCount()
+{
+	std::unique_lock<std::mutex> lock(mLock);
+	return mSources.size();
+}
+
+void AnimatedFrameCache::run()
+{
+	while (true)
+	{
+		std::shared_ptr<Source> source;
+
+		{
+			std::unique_lock<std::mutex> lock(mLock);
+			mEvent.wait(lock, [this] { return !mRunning || !mQueue.empty(); });
+
+			if (!mRunning)
+				return;
+
+			source = mQueue.front();
+			mQueue.pop_front();
+
+			if (source->evicted)
+				continue;
+
+			source->state = FRAMES_DECODING;
+		}
+
+		decode(source);
+
+		std::unique_lock<std::mutex> lock(mLock);
+
+		if (source->state == FRAMES_DECODING)
+			source->state = source->frames.empty() ? FRAMES_UNCACHEABLE : FRAMES_DECODED;
+
+		mFrameDecoded.notify_all();
+	}
+}
+
+void AnimatedFrameCache::decode(const std::shared_ptr<Source>& source)
+{
+	StopWatch stopWatch("AnimatedFrameCache::decode " + source->path, LogDebug);
+
+	int totalFrames, frameTime;
+	ImageIO::getMultiBitmapInformation(ResourceManager::getInstance()->getResourcePath(source->path), totalFrames, frameTime);
+
+	const ResourceData& data = ResourceManager::getInstance()->getFileData(source->path);
+	if (data.ptr == nullptr || data.length == 0)
+		return;
+
+	{
+		std::unique_lock<std::mutex> lock(mLock);
+		source->frames.reserve(totalFrames);
+	}
+
+	MaxSizeInfo maxSize = source->maxSize;
+
+	ImageIO::loadFramesFromMemoryRGBA32(data.ptr.get(), data.length, &maxSize, [this, source, totalFrames](int index, unsigned char* dataRGBA, size_t width, size_t height, const Vector2i& baseSize, const Vector2i& packedSize)
+	{
+		std::unique_ptr<unsigned char[]> frameData(dataRGBA);
+		size_t size = width * height * 4;
+
+		std::unique_lock<std::mutex> lock(mLock);
+
+		if (!mRunning || source->evicted)
+			return false;
+
+		if (index == 0 && size * totalFrames > mMaxCost / 2)
+		{
+			LOG(LogDebug) << "AnimatedFrameCache : " << source->path << " is too large to be cached";
+			source->state = FRAMES_UNCACHEABLE;
+			return false;
+		}
+
+		Frame frame;
+		frame.data = std::move(frameData);
+		frame.width = width;
+		frame.height = height;
+		frame.baseSize = baseSize;
+		frame.packedSize = packedSize;
+		source->frames.push_back(std::move(frame));
+
+		source->cost += size;
+		mCost += size;
+
+		while ((mCost > mMaxCost || mOrder.size() > mMaxCount) && mOrder.front() != source->key)
+			evict(mSources[mOrder.front()]);
+
+		mFrameDecoded.notify_all();
+		return true;
+	});
+}
+
+// mLock must be locked by the caller
+void AnimatedFrameCache::evict(std::shared_ptr<Source> source)
+{
+	source->evicted = true;
+	mCost -= source->cost;
+
+	mSources.erase(source->key);
+	mOrder.remove(source->key);
+
+	// Waiters keep their own reference and are released by the state change
+	if (source->state == FRAMES_QUEUED || source->state == FRAMES_DECODING)
+		source->state = FRAMES_UNCACHEABLE;
+
+	mFrameDecoded.notify_all();
+}
@@ -0,0 +1,86 @@
+#pragma once
+#ifndef ES_CORE_RESOURCES_ANIMATED_FRAME_CACHE_H
+#define ES_CORE_RESOURCES_ANIMATED_FRAME_CACHE_H
+
+#include "ImageIO.h"
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define ANIMATED_FRAME_CACHE_SIZE	(48 * 1024 * 1024)
+#define ANIMATED_FRAME_CACHE_COUNT	64
+
+// Decoded frames of animated images (gif), shared by all the components and kept between revisits.
+// A source is decoded once, in a single pass on a worker thread that runs ahead of the playback, and its frames are kept
+// as RGBA buffers ready to be uploaded. Sources are evicted by memory cost, least recently used first.
+class AnimatedFrameCache
+{
+public:
+	AnimatedFrameCache(size_t maxCost = ANIMATED_FRAME_CACHE_SIZE, size_t maxCount = ANIMATED_FRAME_CACHE_COUNT);
+	~AnimatedFrameCache();
+
+	// Returns a copy of the frame, or nullptr if the source can't be cached and must be decoded by the caller
+	unsigned char* getFrame(const std::string& path, int index, MaxSizeInfo& maxSize, size_t& width, size_t& height, Vector2i& baseSize, Vector2i& packedSize);
+
+	// Bytes held by the decoded frames
+	size_t getCost();
+	size_t getSourceCount();
+
+private:
+	enum SourceState
+	{
+		FRAMES_QUEUED,
+		FRAMES_DECODING,
+		FRAMES_DECODED,
+		FRAMES_UNCACHEABLE	// Unreadable or too large to be kept : the caller decodes the frames itself
+	};
+
+	struct Frame
+	{
+		std::unique_ptr<unsigned char[]> data;
+		size_t width;
+		size_t height;
+		Vector2i baseSize;
+		Vector2i packedSize;
+	};
+
+	struct Source
+	{
+		Source() : state(FRAMES_QUEUED), cost(0), evicted(false) { }
+
+		std::string path;
+		std::string key;
+		std::string stamp;
+		MaxSizeInfo maxSize;
+
+		SourceState state;
+		std::vector<Frame> frames;
+		size_t cost;
+		bool evicted;
+	};
+
+	void run();
+	void decode(const std::shared_ptr<Source>& source);
+	void evict(std::shared_ptr<Source> source);
+
+	size_t											mMaxCost;
+	size_t											mMaxCount;
+
+	std::mutex										mLock;
+	std::condition_variable							mEvent;
+	std::condition_variable							mFrameDecoded;
+	std::thread										mThread;
+	bool											mRunning;
+
+	std::map<std::string, std::shared_ptr<Source>>	mSources;
+	std::list<std::string>							mOrder;		// Least recently used first
+	std::list<std::shared_ptr<Source>>				mQueue;
+	size_t											mCost;
+};
+
+#endif // ES_CORE_RESOURCES_ANIMATED_FRAME_CACHE_H
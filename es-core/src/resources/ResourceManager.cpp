@@ -4,17 +4,321 @@
 #include "utils/StringUtil.h"
 #include <fstream>
 #include <algorithm>
+#include <unordered_map>
+#include <string.h>
+#include <stdint.h>
 #include "Log.h"
 #include "Settings.h"
 #include "Paths.h"
 
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define RESOURCE_PACK_NAME			"resources.pack"
+#define RESOURCE_PACK_MAGIC			"ESRPACK3"
+#define RESOURCE_PACK_HEADER_SIZE	32
+#define RESOURCE_PACK_ALIGNMENT		16
+
 auto array_deleter = [](unsigned char* p) { delete[] p; };
 auto nop_deleter = [](unsigned char* /*p*/) { };
 
+// The files to pack, sorted
+static std::vector<std::string> getResourceFolderFiles(const std::string& root)
+{
+	std::vector<std::string> files;
+	for (auto file : Utils::FileSystem::getDirContent(root, true))
+		if (Utils::FileSystem::isRegularFile(file) && Utils::String::startsWith(file, root + "/"))
+			files.push_back(file);
+
+	std::sort(files.begin(), files.end());
+	return files;
+}
+
+// Newest modification time of the folder and its direct subfolders : it changes when the resources are installed again,
+// as installers replace the files. Checked at each start, so it must not walk & stat every resource file.
+static uint64_t getResourceFolderTime(const std::string& root)
+{
+	uint64_t time = (uint64_t)Utils::FileSystem::getFileModificationDate(root).getTime();
+
+	for (auto folder : Utils::FileSystem::getDirContent(root, false))
+		if (Utils::FileSystem::isDirectory(folder))
+			time = std::max(time, (uint64_t)Utils::FileSystem::getFileModificationDate(folder).getTime());
+
+	return time;
+}
+
+// Pack layout (little endian) :
+//   header : magic (8 bytes), entry count (uint32), index size (uint32), newest folder time of the packed resources (uint64), reserved (8 bytes)
+//   index  : for each entry, offset (uint64), size (uint64), name length (uint32), name (relative path, '/' separated)
+//   data   : the files, each one starting on a RESOURCE_PACK_ALIGNMENT boundary
+class ResourcePack
+{
+public:
+	static std::shared_ptr<ResourcePack> open(const std::string& path)
+	{
+		std::shared_ptr<ResourcePack> pack(new ResourcePack());
+		if (!pack->map(path) || !pack->readIndex())
+		{
+			LOG(LogError) << "ResourcePack : Invalid resource pack " << path;
+			return nullptr;
+		}
+
+		LOG(LogInfo) << "ResourcePack : " << pack->mEntries.size() << " resources in " << path;
+		return pack;
+	}
+
+	~ResourcePack()
+	{
+		if (mData == nullptr)
+			return;
+
+#if defined(_WIN32)
+		delete[] mData;
+#else
+		munmap(mData, mSize);
+#endif
+	}
+
+	bool find(const std::string& name, const unsigned char*& data, size_t& size) const
+	{
+		auto it = mEntries.find(name);
+		if (it == mEntries.cend())
+			return false;
+
+		data = mData + it->second.first;
+		size = it->second.second;
+		return true;
+	}
+
+	bool contains(const std::string& name) const
+	{
+		return mEntries.find(name) != mEntries.cend();
+	}
+
+	uint64_t getFolderTime() const { return mFolderTime; }
+
+private:
+	ResourcePack() : mData(nullptr), mSize(0), mFolderTime(0) { }
+
+	bool map(const std::string& path)
+	{
+#if defined(_WIN32)
+		// No mapping here : the pack is read once, the resources are still served without copy
+		std::ifstream stream(Utils::String::convertToWideString(path), std::ios::binary);
+		if (!stream.is_open())
+			return false;
+
+		stream.seekg(0, stream.end);
+		mSize = (size_t)stream.tellg();
+		stream.seekg(0, stream.beg);
+
+		mData = new unsigned char[mSize];
+		stream.read((char*)mData, mSize);
+		return stream.good();
+#else
+		int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+			return false;
+
+		struct stat info;
+		if (fstat(fd, &info) != 0 || info.st_size < RESOURCE_PACK_HEADER_SIZE)
+		{
+			close(fd);
+			return false;
+		}
+
+		void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+
+		if (data == MAP_FAILED)
+			return false;
+
+		mData = (unsigned char*)data;
+		mSize = (size_t)info.st_size;
+		return true;
+#endif
+	}
+
+	bool readIndex()
+	{
+		if (mSize < RESOURCE_PACK_HEADER_SIZE || memcmp(mData, RESOURCE_PACK_MAGIC, 8) != 0)
+			return false;
+
+		uint32_t count, indexSize;
+		memcpy(&count, mData + 8, sizeof(uint32_t));
+		memcpy(&indexSize, mData + 12, sizeof(uint32_t));
+
+		memcpy(&mFolderTime, mData + 16, sizeof(uint64_t));
+
+		if ((size_t)indexSize > mSize - RESOURCE_PACK_HEADER_SIZE)
+			return false;
+
+		const unsigned char* ptr = mData + RESOURCE_PACK_HEADER_SIZE;
+		const unsigned char* end = ptr + indexSize;
+
+		mEntries.reserve(count);
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			uint64_t offset, size;
+			uint32_t nameLength;
+
+			if (end - ptr < 20)
+				return false;
+
+			memcpy(&offset, ptr, sizeof(uint64_t));
+			memcpy(&size, ptr + 8, sizeof(uint64_t));
+			memcpy(&nameLength, ptr + 16, sizeof(uint32_t));
+			ptr += 20;
+
+			if ((size_t)(end - ptr) < nameLength || offset > mSize || size > mSize - offset)
+				return false;
+
+			mEntries[std::string((const char*)ptr, nameLength)] = std::pair<size_t, size_t>((size_t)offset, (size_t)size);
+			ptr += nameLength;
+		}
+
+		return true;
+	}
+
+	unsigned char*	mData;
+	size_t			mSize;
+
+	uint64_t		mFolderTime;
+
+	std::unordered_map<std::string, std::pair<size_t, size_t>> mEntries; // name -> offset, size
+};
+
 std::shared_ptr<ResourceManager> ResourceManager::sInstance = nullptr;
 
 ResourceManager::ResourceManager()
 {
+	mPackLoaded = false;
+}
+
+std::shared_ptr<ResourcePack> ResourceManager::getResourcePack() const
+{
+	std::unique_lock<std::mutex> lock(mPackLock);
+
+	if (!mPackLoaded)
+	{
+		mPackLoaded = true;
+
+		std::string packPath = Paths::getEmulationStationPath() + "/" + RESOURCE_PACK_NAME;
+		if (Utils::FileSystem::exists(packPath))
+			mPack = ResourcePack::open(packPath);
+
+		// The loose bundled resources may have been updated without creating the pack again : a stale pack is ignored
+		std::string bundledPath = Paths::getEmulationStationPath() + "/resources";
+		if (mPack != nullptr && Utils::FileSystem::isDirectory(bundledPath))
+		{
+			if (getResourceFolderTime(bundledPath) > mPack->getFolderTime())
+			{
+				LOG(LogWarning) << "ResourcePack : " << packPath << " doesn't match " << bundledPath << ", ignoring it";
+				mPack = nullptr;
+			}
+		}
+	}
+
+	return mPack;
+}
+
+// The pack replaces the bundled resources folder : the folders searched before it still override its files
+bool ResourceManager::isOverridenResource(const std::string& path) const
+{
+	std::string bundledPath = Paths::getEmulationStationPath() + "/resources";
+
+	for (auto testPath : getResourcePaths())
+	{
+		if (testPath == bundledPath)
+			break;
+
+		if (Utils::FileSystem::exists(testPath + "/" + &path[2]))
+			return true;
+	}
+
+	return false;
+}
+
+bool ResourceManager::createResourcePack(const std::string& folder, const std::string& packPath)
+{
+	std::string root = Utils::FileSystem::getGenericPath(folder);
+
+	std::vector<std::string> files = getResourceFolderFiles(root);
+	uint64_t folderTime = getResourceFolderTime(root);
+	uint64_t reserved = 0;
+
+	std::string index;
+	std::vector<uint64_t> sizes;
+
+	uint64_t indexSize = 0;
+	for (auto file : files)
+		indexSize += 20 + file.size() - root.size() - 1;
+
+	uint64_t offset = RESOURCE_PACK_HEADER_SIZE + indexSize;
+
+	for (auto file : files)
+	{
+		std::string name = file.substr(root.size() + 1);
+		uint64_t size = Utils::FileSystem::getFileSize(file);
+		uint32_t nameLength = (uint32_t)name.size();
+
+		offset = (offset + RESOURCE_PACK_ALIGNMENT - 1) & ~(uint64_t)(RESOURCE_PACK_ALIGNMENT - 1);
+
+		index.append((const char*)&offset, sizeof(uint64_t));
+		index.append((const char*)&size, sizeof(uint64_t));
+		index.append((const char*)&nameLength, sizeof(uint32_t));
+		index.append(name);
+
+		sizes.push_back(size);
+		offset += size;
+	}
+
+#if defined(_WIN32)
+	std::ofstream stream(Utils::String::convertToWideString(packPath), std::ios::binary);
+#else
+	std::ofstream stream(packPath, std::ios::binary);
+#endif
+	if (!stream.is_open())
+		return false;
+
+	uint32_t count = (uint32_t)files.size();
+	uint32_t size32 = (uint32_t)index.size();
+
+	stream.write(RESOURCE_PACK_MAGIC, 8);
+	stream.write((const char*)&count, sizeof(uint32_t));
+	stream.write((const char*)&size32, sizeof(uint32_t));
+	stream.write((const char*)&folderTime, sizeof(uint64_t));
+	stream.write((const char*)&reserved, sizeof(uint64_t));
+	stream.write(index.c_str(), index.size());
+
+	uint64_t position = RESOURCE_PACK_HEADER_SIZE + index.size();
+
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		uint64_t aligned = (position + RESOURCE_PACK_ALIGNMENT - 1) & ~(uint64_t)(RESOURCE_PACK_ALIGNMENT - 1);
+		if (aligned != position)
+			stream.write(std::string((size_t)(aligned - position), '\0').c_str(), aligned - position);
+
+#if defined(_WIN32)
+		std::ifstream input(Utils::String::convertToWideString(files[i]), std::ios::binary);
+#else
+		std::ifstream input(files[i], std::ios::binary);
+#endif
+		std::vector<char> data((size_t)sizes[i]);
+		if (data.size() > 0 && !input.read(data.data(), data.size()))
+			return false;
+
+		stream.write(data.data(), data.size());
+		position = aligned + data.size();
+	}
+
+	stream.close();
+	return stream.good();
 }
 
 std::shared_ptr<ResourceManager>& ResourceManager::getInstance()
@@ -88,6 +392,11 @@ std::string ResourceManager::getResourcePath(const std::string& path) const
 	}
 #endif
 
+	// Only in the resource pack : there is no file to give
+	auto pack = getResourcePack();
+	if (pack != nullptr && pack->contains(&path[2]))
+		return path;
+
 	LOG(LogError) << "Resource path not found: " << path;
 
 	// not a resource, return unmodified path
@@ -96,6 +405,22 @@ std::string ResourceManager::getResourcePath(const std::string& path) const
 
 const ResourceData ResourceManager::getFileData(const std::string& path) const
 {
+	// Bundled resources are served from the pack, pointing to its mapping, unless a theme or the user overrides them
+	if (path.size() > 2 && path[0] == ':' && path[1] == '/')
+	{
+		auto pack = getResourcePack();
+
+		const unsigned char* packData;
+		size_t packSize;
+
+		if (pack != nullptr && pack->find(&path[2], packData, packSize) && packSize > 0 && !isOverridenResource(path))
+		{
+			// The data shares the ownership of the pack, which stays mapped as long as the resource is used
+			ResourceData data = { std::shared_ptr<unsigned char>(pack, (unsigned char*)packData), packSize };
+			return data;
+		}
+	}
+
 	//check if its a resource
 	const std::string respath = getResourcePath(path);
 
@@ -151,6 +476,13 @@ bool ResourceManager::fileExists(const std::string& path) const
 	//if it exists as a resource file, return true
 	if(getResourcePath(path) != path)
 		return true;
+
+	if (path.size() > 2 && path[0] == ':' && path[1] == '/')
+	{
+		auto pack = getResourcePack();
+		if (pack != nullptr && pack->contains(&path[2]))
+			return true;
+	}
 		
 	return Utils::FileSystem::exists(Utils::FileSystem::getCanonicalPath(path));
 }
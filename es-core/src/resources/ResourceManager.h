@@ -4,12 +4,14 @@
 
 #include <list>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 //The ResourceManager exists to...
 //Allow loading resources embedded into the executable like an actual file.
 //Allow embedded resources to be optionally remapped to actual files for further customization.
+//Allow the bundled resources to be served from a single memory-mapped pack (resources.pack), without copy.
 
 struct ResourceData
 {
@@ -18,6 +20,7 @@ struct ResourceData
 };
 
 class ResourceManager;
+class ResourcePack;
 
 class IReloadable
 {
@@ -43,9 +46,19 @@ public:
 	const ResourceData getFileData(const std::string& path) const;
 	bool fileExists(const std::string& path) const;
 
+	// Writes all the files of a resources folder into a pack
+	static bool createResourcePack(const std::string& folder, const std::string& packPath);
+
 private:
 	ResourceManager();
 
+	std::shared_ptr<ResourcePack> getResourcePack() const;
+	bool isOverridenResource(const std::string& path) const;
+
+	mutable std::mutex						mPackLock;
+	mutable std::shared_ptr<ResourcePack>	mPack;
+	mutable bool							mPackLoaded;
+
 	static std::shared_ptr<ResourceManager> sInstance;
 
 	ResourceData loadFile(const std::string& path, size_t size) const;
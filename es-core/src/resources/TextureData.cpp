@@ -2,6 +2,7 @@
 
 #include "math/Misc.h"
 #include "renderers/Renderer.h"
+#include "resources/AnimatedFrameCache.h"
 #include "resources/ResourceManager.h"
 #include "ImageIO.h"
 #include "Log.h"
@@ -9,6 +10,11 @@
 #include <nanosvg/nanosvgrast.h>
 #include <string.h>
 #include <algorithm>
+#include <list>
+#include <map>
+#include <memory>
+#include <thread>
+#include <condition_variable>
 #include <vlc/vlc.h>
 
 #include "Settings.h"
@@ -20,10 +26,166 @@
 
 #define DPI 96
 
+#define SVG_PARSED_CACHE_COUNT	128
+#define SVG_RASTER_CACHE_SIZE	(16 * 1024 * 1024)
+
 #define OPTIMIZEVRAM Settings::getInstance()->getBool("OptimizeVRAM")
 
 IPdfHandler* TextureData::PdfHandler = nullptr;
 
+// Modification time & size of a file, used to invalidate the cached decodings
+static std::string getFileStamp(const std::string& path)
+{
+	auto resPath = ResourceManager::getInstance()->getResourcePath(path);
+	return std::to_string(Utils::FileSystem::getFileModificationDate(resPath).getTime()) + "-" + std::to_string(Utils::FileSystem::getFileSize(resPath));
+}
+
+// Parsed SVG documents keyed by path & file stamp, and rasterized bitmaps keyed by target size.
+// Themes use the same logos & icons for many systems, often at different sizes.
+class SVGCache
+{
+public:
+	// stamp receives the modification time & size of the file when it was parsed, used to key the rasterized bitmaps, and length the size of its data.
+	// A trusted file, already known by the image cache, is not checked on disk again.
+	static std::shared_ptr<NSVGimage> getImage(const std::string& path, bool trusted, std::string& stamp, size_t& length)
+	{
+		std::string fileStamp;
+		if (!trusted)
+			fileStamp = getFileStamp(path);
+
+		{
+			std::unique_lock<std::mutex> lock(mLock);
+
+			auto it = mImages.find(path);
+			if (it != mImages.cend())
+			{
+				if (trusted || it->second.stamp == fileStamp)
+				{
+					mImageOrder.remove(path);
+					mImageOrder.push_back(path);
+
+					stamp = it->second.stamp;
+					length = it->second.length;
+					return it->second.image;
+				}
+
+				mImages.erase(it);
+				mImageOrder.remove(path);
+			}
+		}
+
+		if (fileStamp.empty())
+			fileStamp = getFileStamp(path);
+
+		// Pack resources have no file on disk : the size comes from the data
+		const ResourceData& data = ResourceManager::getInstance()->getFileData(path);
+		if (data.ptr == nullptr || data.length == 0)
+			return nullptr;
+
+		stamp = fileStamp;
+		length = data.length;
+
+		// nsvgParse excepts a modifiable, null-terminated string
+		std::string copy((const char*)data.ptr.get(), data.length);
+
+		NSVGimage* svgImage = nsvgParse((char*)copy.c_str(), "px", DPI);
+		if (svgImage == nullptr)
+			return nullptr;
+
+		std::shared_ptr<NSVGimage> image(svgImage, [](NSVGimage* img) { nsvgDelete(img); });
+
+		std::unique_lock<std::mutex> lock(mLock);
+
+		if (mImages.find(path) == mImages.cend())
+		{
+			mImages[path] = { stamp, length, image };
+			mImageOrder.push_back(path);
+
+			while (mImageOrder.size() > SVG_PARSED_CACHE_COUNT)
+			{
+				mImages.erase(mImageOrder.front());
+				mImageOrder.pop_front();
+			}
+		}
+
+		return image;
+	}
+
+	static unsigned char* getBitmap(const std::string& key, size_t width, size_t height)
+	{
+		std::unique_lock<std::mutex> lock(mLock);
+
+		auto it = mBitmaps.find(getBitmapKey(key, width, height));
+		if (it == mBitmaps.cend())
+			return nullptr;
+
+		mBitmapOrder.remove(it->first);
+		mBitmapOrder.push_back(it->first);
+
+		auto& bitmap = *it->second;
+
+		unsigned char* dataRGBA = new unsigned char[bitmap.size()];
+		memcpy(dataRGBA, bitmap.data(), bitmap.size());
+		return dataRGBA;
+	}
+
+	static void putBitmap(const std::string& key, size_t width, size_t height, const unsigned char* dataRGBA)
+	{
+		size_t size = width * height * 4;
+		if (size > SVG_RASTER_CACHE_SIZE / 4)
+			return;
+
+		std::unique_lock<std::mutex> lock(mLock);
+
+		auto bitmapKey = getBitmapKey(key, width, height);
+		if (mBitmaps.find(bitmapKey) != mBitmaps.cend())
+			return;
+
+		mBitmaps[bitmapKey] = std::make_shared<std::vector<unsigned char>>(dataRGBA, dataRGBA + size);
+		mBitmapOrder.push_back(bitmapKey);
+		mBitmapsSize += size;
+
+		while (mBitmapsSize > SVG_RASTER_CACHE_SIZE && mBitmapOrder.size() > 0)
+		{
+			auto oldest = mBitmaps.find(mBitmapOrder.front());
+			mBitmapsSize -= oldest->second->size();
+			mBitmaps.erase(oldest);
+			mBitmapOrder.pop_front();
+		}
+	}
+
+private:
+	struct ParsedImage
+	{
+		std::string stamp;
+		size_t length;
+		std::shared_ptr<NSVGimage> image;
+	};
+
+	static std::string getBitmapKey(const std::string& key, size_t width, size_t height)
+	{
+		return key + "|" + std::to_string(width) + "x" + std::to_string(height);
+	}
+
+	static std::mutex mLock;
+
+	static std::map<std::string, ParsedImage> mImages;
+	static std::list<std::string> mImageOrder;
+
+	static std::map<std::string, std::shared_ptr<std::vector<unsigned char>>> mBitmaps;
+	static std::list<std::string> mBitmapOrder;
+	static size_t mBitmapsSize;
+};
+
+std::mutex SVGCache::mLock;
+std::map<std::string, SVGCache::ParsedImage> SVGCache::mImages;
+std::list<std::string> SVGCache::mImageOrder;
+std::map<std::string, std::shared_ptr<std::vector<unsigned char>>> SVGCache::mBitmaps;
+std::list<std::string> SVGCache::mBitmapOrder;
+size_t SVGCache::mBitmapsSize = 0;
+
+static AnimatedFrameCache sFrameCache;
+
 TextureData::TextureData(bool tile, bool linear) : mTile(tile), mLinear(linear), mTextureID(0), mDataRGBA(nullptr), mScalable(false),
 									  mWidth(0), mHeight(0), mSourceWidth(0.0f), mSourceHeight(0.0f),
 									  mPackedSize(Vector2i(0, 0)), mBaseSize(Vector2i(0, 0))
@@ -69,6 +231,35 @@ bool TextureData::initSVGFromMemory(const unsigned char* fileData, size_t length
 		return false;
 	}
 
+	bool ret = initSVGFromImage(svgImage, "");
+	nsvgDelete(svgImage);
+	return ret;
+}
+
+bool TextureData::initSVGFromCache(const std::string& path, size_t& length)
+{
+	// If already initialised then don't read again
+	std::unique_lock<std::mutex> lock(mMutex);
+	if (mDataRGBA || (mTextureID != 0))
+		return true;
+
+	int cachedSize;
+	bool trusted = ImageIO::getImageCacheFileSize(mPath, cachedSize);
+
+	std::string stamp;
+	std::shared_ptr<NSVGimage> svgImage = SVGCache::getImage(path, trusted, stamp, length);
+	if (svgImage == nullptr)
+	{
+		LOG(LogError) << "Error parsing SVG image.";
+		return false;
+	}
+
+	return initSVGFromImage(svgImage.get(), path + "|" + stamp);
+}
+
+// mMutex must be locked by the caller. svgImage is only read, so it can be shared with the SVGCache
+bool TextureData::initSVGFromImage(NSVGimage* svgImage, const std::string& cacheKey)
+{
 	if (svgImage->width == 0 || svgImage->height == 0)
 		return false;
 
@@ -135,6 +326,16 @@ bool TextureData::initSVGFromMemory(const unsigned char* fileData, size_t length
 		return false;
 	}
 
+	if (!cacheKey.empty())
+	{
+		unsigned char* cachedRGBA = SVGCache::getBitmap(cacheKey, mWidth, mHeight);
+		if (cachedRGBA != nullptr)
+		{
+			mDataRGBA = cachedRGBA;
+			return true;
+		}
+	}
+
 	unsigned char* dataRGBA = new unsigned char[mWidth * mHeight * 4];
 
 	double scale = ((float)((int)mHeight)) / svgImage->height;
@@ -145,10 +346,12 @@ bool TextureData::initSVGFromMemory(const unsigned char* fileData, size_t length
 	NSVGrasterizer* rast = nsvgCreateRasterizer();
 	nsvgRasterize(rast, svgImage, 0, 0, scale, dataRGBA, (int)mWidth, (int)mHeight, (int)mWidth * 4);
 	nsvgDeleteRasterizer(rast);
-	nsvgDelete(svgImage);
 
 	ImageIO::flipPixelsVert(dataRGBA, mWidth, mHeight);
 
+	if (!cacheKey.empty())
+		SVGCache::putBitmap(cacheKey, mWidth, mHeight, dataRGBA);
+
 	mDataRGBA = dataRGBA;
 
 	return true;
@@ -189,6 +392,30 @@ bool TextureData::initImageFromMemory(const unsigned char* fileData, size_t leng
 	return initFromRGBA(imageRGBA, width, height, false);
 }
 
+bool TextureData::initFrameFromCache(const std::string& path, int frameIndex)
+{
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		if (mDataRGBA || (mTextureID != 0))
+			return true;
+	}
+
+	MaxSizeInfo maxSize(Renderer::getScreenWidth(), Renderer::getScreenHeight(), false);
+	if (!mMaxSize.empty())
+		maxSize = mMaxSize;
+
+	size_t width, height;
+	unsigned char* imageRGBA = sFrameCache.getFrame(path, frameIndex, maxSize, width, height, mBaseSize, mPackedSize);
+	if (imageRGBA == nullptr)
+		return false;
+
+	mSourceWidth = (float)width;
+	mSourceHeight = (float)height;
+	mScalable = false;
+
+	return initFromRGBA(imageRGBA, width, height, false);
+}
+
 bool TextureData::initFromRGBA(unsigned char* dataRGBA, size_t width, size_t height, bool copyData)
 {
 	// If already initialised then don't read again
@@ -447,16 +674,33 @@ bool TextureData::load(bool updateCache)
 			path = mPath.substr(0, idx);			
 		}
 
-		std::shared_ptr<ResourceManager>& rm = ResourceManager::getInstance();
-		const ResourceData& data = rm->getFileData(path);
-		// is it an SVG?
+		// is it an SVG? Parsed documents & bitmaps are shared through the SVGCache, the file is only read when it changed
 		if (mPath.substr(mPath.size() - 4, std::string::npos) == ".svg")
 		{
 			mScalable = true;
-			retval = initSVGFromMemory((const unsigned char*)data.ptr.get(), data.length);
+
+			size_t length = 0;
+			retval = initSVGFromCache(path, length);
+
+			if (updateCache && retval && length > 0)
+				ImageIO::updateImageCache(mPath, (int)length, mBaseSize.x(), mBaseSize.y());
+
+			return retval;
 		}
-		else
-			retval = initImageFromMemory((const unsigned char*)data.ptr.get(), data.length, subImageIndex);
+
+		std::shared_ptr<ResourceManager>& rm = ResourceManager::getInstance();
+
+		// Frames of animated images are decoded once for all the components & revisits
+		if (subImageIndex >= 0 && initFrameFromCache(path, subImageIndex))
+		{
+			if (updateCache)
+				ImageIO::updateImageCache(mPath, Utils::FileSystem::getFileSize(rm->getResourcePath(path)), mBaseSize.x(), mBaseSize.y());
+
+			return true;
+		}
+
+		const ResourceData& data = rm->getFileData(path);
+		retval = initImageFromMemory((const unsigned char*)data.ptr.get(), data.length, subImageIndex);
 
 		if (updateCache && retval)
 			ImageIO::updateImageCache(mPath, data.length, mBaseSize.x(), mBaseSize.y());
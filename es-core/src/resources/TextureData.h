@@ -8,6 +8,7 @@
 #include "ImageIO.h"
 
 class TextureResource;
+struct NSVGimage;
 
 class IPdfHandler
 {
@@ -78,6 +79,10 @@ public:
 	void setRequired(bool value) { mRequired = value; };
 
 private:
+	bool initSVGFromCache(const std::string& path, size_t& length);
+	bool initSVGFromImage(NSVGimage* svgImage, const std::string& cacheKey);
+	bool initFrameFromCache(const std::string& path, int frameIndex);
+
 	bool			mRequired;
 
 	std::mutex		mMutex;
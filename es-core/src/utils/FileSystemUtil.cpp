@@ -25,6 +25,7 @@
 #define S_ISDIR(x) (((x) & S_IFMT) == S_IFDIR)
 #else // _WIN32
 #include <dirent.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <mutex>
 #endif // _WIN32
@@ -1404,78 +1405,80 @@ namespace Utils
 			return pdfpath;
 		}
 		
-		std::string getFileCrc32(const std::string& filename)
-		{
-			std::string hex;
+		// Retroarch CRC calculations are limited in size. See encoding_crc32.c
+		#define CRC32_MAX_SIZE (64 * 1024 * 1024)
+		#define HASH_BUFFER_SIZE (1024 * 1024)
 
+		bool getFileHashes(const std::string& filename, std::string* crc32, std::string* md5, const std::function<bool(const void* data, size_t size)>& onData)
+		{
 #if defined(_WIN32)
 			FILE* file = _wfopen(Utils::String::convertToWideString(filename).c_str(), L"rb");
 #else			
 			FILE* file = fopen(filename.c_str(), "rb");
 #endif
-			if (file)
-			{
-				// Retroarch CRC calculations are limited in size. See encoding_crc32.c
-				#define CRC32_BUFFER_SIZE 1048576
-				#define CRC32_MAX_MB 64
+			if (file == nullptr)
+				return false;
 
-				char* buffer = new char[CRC32_BUFFER_SIZE];
-				if (buffer)
-				{
-					size_t size;
-					unsigned int file_crc32 = 0;
+			// Reads go straight to our buffer, stdio buffering would only add a copy
+			setvbuf(file, nullptr, _IONBF, 0);
 
-					for (int i = 0; i < CRC32_MAX_MB; i++)
-					{
-						size = fread(buffer, 1, CRC32_BUFFER_SIZE, file);
-						if (size == 0)
-							break;
+#if !defined(_WIN32) && !defined(__APPLE__)
+			posix_fadvise(fileno(file), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
 
-						file_crc32 = Utils::Zip::ZipFile::computeCRC(file_crc32, buffer, size);
-					}
+			std::vector<char> buffer(HASH_BUFFER_SIZE);
 
-					hex = Utils::String::toHexString(file_crc32);
+			MD5 md5hash;
+			unsigned int file_crc32 = 0;
+			size_t crcSize = 0;
+			bool sendData = (onData != nullptr);
 
-					delete buffer;
+			size_t size;
+			while ((size = fread(buffer.data(), 1, buffer.size(), file)) > 0)
+			{
+				if (crc32 != nullptr && crcSize < CRC32_MAX_SIZE)
+				{
+					size_t len = std::min(size, (size_t)CRC32_MAX_SIZE - crcSize);
+					file_crc32 = Utils::Zip::ZipFile::computeCRC(file_crc32, buffer.data(), len);
+					crcSize += len;
 				}
 
-				fclose(file);
-			}
+				if (md5 != nullptr)
+					md5hash.update(buffer.data(), size);
 
-			return hex;
-		}
+				if (sendData)
+					sendData = onData(buffer.data(), size);
 
-		std::string getFileMd5(const std::string& filename)
-		{
-			std::string hex;
-
-#if defined(_WIN32)
-			FILE* file = _wfopen(Utils::String::convertToWideString(filename).c_str(), L"rb");
-#else			
-			FILE* file = fopen(filename.c_str(), "rb");
-#endif
-			if (file)
-			{
-				#define CRCBUFFERSIZE 64 * 1024
-				char* buffer = new char[CRCBUFFERSIZE];
+				// Nothing more to compute
+				if (md5 == nullptr && !sendData && (crc32 == nullptr || crcSize >= CRC32_MAX_SIZE))
+					break;
+			}
 
-				if (buffer)
-				{
-					MD5 md5;
+			fclose(file);
 
-					size_t size;
-					while (size = fread(buffer, 1, CRCBUFFERSIZE, file))
-						md5.update(buffer, size);
+			if (crc32 != nullptr)
+				*crc32 = Utils::String::toHexString(file_crc32);
 
-					md5.finalize();
-					hex = md5.hexdigest();
+			if (md5 != nullptr)
+			{
+				md5hash.finalize();
+				*md5 = md5hash.hexdigest();
+			}
 
-					delete buffer;
-				}
+			return true;
+		}
 
-				fclose(file);
-			}
+		std::string getFileCrc32(const std::string& filename)
+		{
+			std::string hex;
+			getFileHashes(filename, &hex, nullptr);
+			return hex;
+		}
 
+		std::string getFileMd5(const std::string& filename)
+		{
+			std::string hex;
+			getFileHashes(filename, nullptr, &hex);
 			return hex;
 		}		
 
@@ -2,6 +2,7 @@
 #ifndef ES_CORE_UTILS_FILE_SYSTEM_UTIL_H
 #define ES_CORE_UTILS_FILE_SYSTEM_UTIL_H
 
+#include <functional>
 #include <list>
 #include <string>
 #include <vector>
@@ -78,6 +79,9 @@ namespace Utils
 		std::string getFileCrc32(const std::string& filename);
 		std::string getFileMd5(const std::string& filename);
 
+		// Computes the requested hashes with a single read of the file. onData receives each chunk, until it returns false
+		bool getFileHashes(const std::string& filename, std::string* crc32, std::string* md5, const std::function<bool(const void* data, size_t size)>& onData = nullptr);
+
 		std::string changeExtension(const std::string& _path, const std::string& extension);
 
 		class FileSystemCacheActivator
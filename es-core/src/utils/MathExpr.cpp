@@ -5,15 +5,21 @@
 // Modifications: www.K3A.me (changed token class, float numbers, added support for boolean operators, added support for strings)
 // Licence: MIT
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
 #include <math.h>
 #include <stdio.h>
+#include <mutex>
+#include <list>
+#include <unordered_map>
 
 #include "MathExpr.h"
 
+#define PROGRAM_CACHE_SIZE 4096
+
 namespace Utils
 {
 	float MathExpr::Value::toNumber()
@@ -32,8 +38,8 @@ namespace Utils
 		if (isToken()) return string;
 		if (isString()) return string;
 
-		char str[16];
-		sprintf(str, "%f", number);
+		char str[64];
+		snprintf(str, sizeof(str), "%f", number);
 		string = str;
 		type |= STRING;
 
@@ -57,11 +63,17 @@ namespace Utils
 
 #define isvariablechar(c) (isalpha(c) || c == '_')
 
-	MathExpr::ValuePtrQueue MathExpr::toRPN(const char* expr, ValueMap* vars, IntMap opPrecedence)
+	std::vector<MathExpr::Value> MathExpr::toRPN(const char* expr, const IntMap& opPrecedence)
 	{
-		ValuePtrQueue rpnQueue; std::stack<std::string> operatorStack;
+		std::vector<Value> rpnQueue; std::stack<std::string> operatorStack;
 		bool lastTokenWasOp = true;
 
+		auto precedence = [&opPrecedence](const std::string& op)
+		{
+			auto it = opPrecedence.find(op);
+			return it == opPrecedence.cend() ? 0 : it->second;
+		};
+
 		// In one pass, ignore whitespace and parse the expression into RPN
 		// using Dijkstra's Shunting-yard algorithm.
 		while (*expr && isspace(*expr)) ++expr;
@@ -74,17 +86,14 @@ namespace Utils
 				char* nextChar = 0;
 				float digit = strtod(expr, &nextChar);
 
-				rpnQueue.push(new Value(digit));
+				rpnQueue.push_back(Value(digit));
 				expr = nextChar;
 				lastTokenWasOp = false;
 			}
 			else if (isvariablechar(*expr) || *expr == '{' || *expr == '$')
 			{
-				// If the function is a variable, resolve it and
-				// add the parsed number to the output queue.
-				if (!vars)
-					throw std::domain_error("Detected variable, but the variable map is null.");
-
+				// If the function is a variable, add a reference to it to the output queue.
+				// It is resolved when the expression is evaluated.
 				std::stringstream ss;
 
 				if (*expr == '$' && *(expr+1) == '{')
@@ -115,16 +124,11 @@ namespace Utils
 
 				std::string key = ss.str();
 				if (key == "true")
-					rpnQueue.push(new Value(1));
+					rpnQueue.push_back(Value(1));
 				else if (key == "false")
-					rpnQueue.push(new Value(0));
-				else {
-					ValueMap::iterator it = vars->find(key);
-					if (it == vars->end())
-						throw std::domain_error("Unable to find the variable '" + key + "'.");
-
-					rpnQueue.push(new Value(it->second));
-				}
+					rpnQueue.push_back(Value(0));
+				else
+					rpnQueue.push_back(Value(key, VARIABLE));
 
 				lastTokenWasOp = false;
 			}
@@ -143,7 +147,7 @@ namespace Utils
 				}
 				if (*expr) expr++;
 
-				rpnQueue.push(new Value(ss.str()));
+				rpnQueue.push_back(Value(ss.str()));
 				lastTokenWasOp = false;
 			}
 			else
@@ -156,11 +160,13 @@ namespace Utils
 					++expr;
 					break;
 				case ')':
-					while (operatorStack.top().compare("("))
+					while (!operatorStack.empty() && operatorStack.top().compare("("))
 					{
-						rpnQueue.push(new Value(operatorStack.top(), TOKEN));
+						rpnQueue.push_back(Value(operatorStack.top(), TOKEN));
 						operatorStack.pop();
 					}
+					if (operatorStack.empty())
+						throw std::domain_error("Mismatched parenthesis.");
 					operatorStack.pop();
 					++expr;
 					break;
@@ -192,15 +198,15 @@ namespace Utils
 					{
 						// Convert unary operators to binary in the RPN.
 						if (!str.compare("-") || !str.compare("+") || !str.compare("!"))
-							rpnQueue.push(new Value(0));
+							rpnQueue.push_back(Value(0));
 						else
 							throw std::domain_error("Unrecognized unary operator: '" + str + "'");
 
 					}
 
-					while (!operatorStack.empty() && opPrecedence[str] <= opPrecedence[operatorStack.top()])
+					while (!operatorStack.empty() && precedence(str) <= precedence(operatorStack.top()))
 					{
-						rpnQueue.push(new Value(operatorStack.top(), TOKEN));
+						rpnQueue.push_back(Value(operatorStack.top(), TOKEN));
 						operatorStack.pop();
 					}
 					operatorStack.push(str);
@@ -212,105 +218,319 @@ namespace Utils
 		}
 		while (!operatorStack.empty())
 		{
-			rpnQueue.push(new Value(operatorStack.top(), TOKEN));
+			rpnQueue.push_back(Value(operatorStack.top(), TOKEN));
 			operatorStack.pop();
 		}
 		return rpnQueue;
 	}
 
-	MathExpr::Value MathExpr::eval(const char* expr, ValueMap* vars) 
+	enum OpCode : unsigned char
+	{
+		OP_CONSTANT,
+		OP_VARIABLE,
+		OP_ADD,
+		OP_SUB,
+		OP_MUL,
+		OP_DIV,
+		OP_POW,
+		OP_SHL,
+		OP_SHR,
+		OP_GT,
+		OP_GE,
+		OP_LT,
+		OP_LE,
+		OP_AND,
+		OP_OR,
+		OP_EQ,
+		OP_NE,
+		OP_NOT,
+		OP_UNKNOWN
+	};
+
+	static OpCode getOpCode(const std::string& op)
+	{
+		static const std::map<std::string, OpCode> opCodes =
+		{
+			{ "+", OP_ADD }, { "-", OP_SUB }, { "*", OP_MUL }, { "/", OP_DIV }, { "^", OP_POW },
+			{ "<<", OP_SHL }, { ">>", OP_SHR },
+			{ ">", OP_GT }, { ">=", OP_GE }, { "<", OP_LT }, { "<=", OP_LE },
+			{ "&&", OP_AND }, { "||", OP_OR }, { "==", OP_EQ }, { "!=", OP_NE }, { "!", OP_NOT }
+		};
+
+		auto it = opCodes.find(op);
+		return it == opCodes.cend() ? OP_UNKNOWN : it->second;
+	}
+
+	static inline void setNumber(MathExpr::Value& value, float number)
+	{
+		value.type = MathExpr::NUMBER;
+		value.number = number;
+		value.string.clear();
+	}
+
+	// Applies a binary operator, the result replaces the left operand.
+	static void applyOperator(unsigned char op, MathExpr::Value& left, MathExpr::Value& right)
+	{
+		switch (op)
+		{
+		case OP_ADD:
+			// Only strings can be the left operand of '+' : like the historical interpreter, a numeric left operand is an error
+			if (left.isNumber() || !left.isString())
+				throw std::domain_error("Unknown operator: " + left.toString() + " + " + right.toString() + ".");
+
+			left.string += right.toString();
+			left.type = MathExpr::STRING;
+			break;
+		case OP_SUB:
+			setNumber(left, left.toNumber() - right.toNumber());
+			break;
+		case OP_MUL:
+			setNumber(left, left.toNumber() * right.toNumber());
+			break;
+		case OP_DIV:
+		{
+			float r = right.toNumber();
+			setNumber(left, r == 0 ? 0 : left.toNumber() / r);
+			break;
+		}
+		case OP_POW:
+			setNumber(left, pow(left.toNumber(), right.toNumber()));
+			break;
+		case OP_SHL:
+			setNumber(left, (int)left.toNumber() << (int)right.toNumber());
+			break;
+		case OP_SHR:
+			setNumber(left, (int)left.toNumber() >> (int)right.toNumber());
+			break;
+		case OP_GT:
+			setNumber(left, left.toNumber() > right.toNumber());
+			break;
+		case OP_GE:
+			setNumber(left, left.toNumber() >= right.toNumber());
+			break;
+		case OP_LT:
+			setNumber(left, left.toNumber() < right.toNumber());
+			break;
+		case OP_LE:
+			setNumber(left, left.toNumber() <= right.toNumber());
+			break;
+		case OP_AND:
+			setNumber(left, left.toNumber() && right.toNumber());
+			break;
+		case OP_OR:
+			setNumber(left, left.toNumber() || right.toNumber());
+			break;
+		case OP_EQ:
+		case OP_NE:
+		{
+			bool equals;
+			if (left.isNumber() && right.isNumber())
+				equals = left.number == right.number;
+			else if (left.isString() && right.isString())
+				equals = left.string == right.string;
+			else if (left.isString())
+				equals = left.string == right.toString();
+			else
+				equals = left.toNumber() == right.toNumber();
+
+			setNumber(left, op == OP_EQ ? equals : !equals);
+			break;
+		}
+		case OP_NOT:
+			setNumber(left, !right.toNumber());
+			break;
+		default:
+			throw std::domain_error("Unknown operator.");
+		}
+	}
+
+	std::shared_ptr<const MathExpr::Program> MathExpr::compile(const char* expr)
 	{
-		// Convert to RPN with Dijkstra's Shunting-yard algorithm.
-		ValuePtrQueue rpn = toRPN(expr, vars, opPrecedence);
+		// Least recently used programs are evicted first : the front of the list is the most recently used expression
+		typedef std::list<std::pair<std::string, std::shared_ptr<const Program>>> ProgramList;
+
+		static std::mutex programsLock;
+		static ProgramList programList;
+		static std::unordered_map<std::string, ProgramList::iterator> programs;
 
-		// Evaluate the expression in RPN form.
-		ValueStack evaluation;
+		std::string key = expr;
 
-		while (!rpn.empty()) 
 		{
-			Value* tok = rpn.front();
-			rpn.pop();
+			std::unique_lock<std::mutex> lock(programsLock);
 
-			if (tok->isToken())
+			auto it = programs.find(key);
+			if (it != programs.cend())
 			{
-				std::string str = tok->string;
-				if (evaluation.size() < 2) {
-					throw std::domain_error("Invalid equation.");
-				}
-				Value right = evaluation.top(); evaluation.pop();
-				Value left = evaluation.top(); evaluation.pop();
-				if (!str.compare("+") && left.isNumber())
-					evaluation.push(left.number + right.toNumber());
-				if (!str.compare("+") && left.isString())
-					evaluation.push(left.string + right.toString());
-				else if (!str.compare("*"))
-					evaluation.push(left.toNumber() * right.toNumber());
-				else if (!str.compare("-"))
-					evaluation.push(left.toNumber() - right.toNumber());
-				else if (!str.compare("/"))
+				programList.splice(programList.begin(), programList, it->second);
+				return it->second->second;
+			}
+		}
+
+		auto program = std::make_shared<Program>();
+		program->maxStackSize = 0;
+
+		try
+		{
+			// Each entry tells if the value is a compile-time constant, in which case its instruction is the last one emitted for it
+			std::vector<bool> stack;
+
+			for (auto& tok : toRPN(expr, opPrecedence))
+			{
+				Program::Instruction instruction;
+
+				if (tok.type == VARIABLE)
 				{
-					float r = right.toNumber();
-					if (r == 0)
-						evaluation.push(0);
-					else
-						evaluation.push(left.toNumber() / r);
+					auto it = std::find(program->variables.cbegin(), program->variables.cend(), tok.string);
+
+					instruction.op = OP_VARIABLE;
+					instruction.arg = (unsigned short)(it - program->variables.cbegin());
+
+					if (it == program->variables.cend())
+						program->variables.push_back(tok.string);
+
+					program->code.push_back(instruction);
+					stack.push_back(false);
 				}
-				else if (!str.compare("<<"))
-					evaluation.push((int)left.toNumber() << (int)right.toNumber());
-				else if (!str.compare("^"))
-					evaluation.push(pow(left.toNumber(), right.toNumber()));
-				else if (!str.compare(">>"))
-					evaluation.push((int)left.toNumber() >> (int)right.toNumber());
-				else if (!str.compare(">"))
-					evaluation.push(left.toNumber() > right.toNumber());
-				else if (!str.compare(">="))
-					evaluation.push(left.toNumber() >= right.toNumber());
-				else if (!str.compare("<"))
-					evaluation.push(left.toNumber() < right.toNumber());
-				else if (!str.compare("<="))
-					evaluation.push(left.toNumber() <= right.toNumber());
-				else if (!str.compare("&&"))
-					evaluation.push(left.toNumber() && right.toNumber());
-				else if (!str.compare("||"))
-					evaluation.push(left.toNumber() || right.toNumber());
-				else if (!str.compare("=="))
+				else if (tok.isToken())
 				{
-					if (left.isNumber() && right.isNumber())
-						evaluation.push(left.number == right.number);
-					else if (left.isString() && right.isString())
-						evaluation.push(left.string == right.string);
-					else if (left.isString())
-						evaluation.push(left.string == right.toString());
-					else
-						evaluation.push(left.toNumber() == right.toNumber());
+					if (stack.size() < 2)
+						throw std::domain_error("Invalid equation.");
+
+					auto op = getOpCode(tok.string);
+					if (op == OP_UNKNOWN)
+						throw std::domain_error("Unknown operator: " + tok.string + ".");
+
+					bool constant = stack[stack.size() - 1] && stack[stack.size() - 2];
+
+					stack.pop_back();
+					stack.back() = false;
+
+					if (constant)
+					{
+						// Both operands are the last constants pushed : evaluate the operator now
+						auto& right = program->code[program->code.size() - 1];
+						auto& left = program->code[program->code.size() - 2];
+
+						Value result = program->constants[left.arg];
+						Value rightValue = program->constants[right.arg];
+
+						try
+						{
+							applyOperator(op, result, rightValue);
+
+							program->constants.push_back(result);
+
+							program->code.pop_back();
+							program->code.back().arg = (unsigned short)(program->constants.size() - 1);
+							stack.back() = true;
+							continue;
+						}
+						catch (std::domain_error&)
+						{
+							// Keep the error for evaluation time
+						}
+					}
+
+					instruction.op = op;
+					instruction.arg = 0;
+					program->code.push_back(instruction);
 				}
-				else if (!str.compare("!="))
+				else if (tok.isNumber() || tok.isString())
 				{
-					if (left.isNumber() && right.isNumber())
-						evaluation.push(left.number != right.number);
-					else if (left.isString() && right.isString())
-						evaluation.push(left.string != right.string);
-					else if (left.isString())
-						evaluation.push(left.string != right.toString());
-					else
-						evaluation.push(left.toNumber() != right.toNumber());
+					instruction.op = OP_CONSTANT;
+					instruction.arg = (unsigned short)program->constants.size();
+
+					program->constants.push_back(tok);
+					program->code.push_back(instruction);
+					stack.push_back(true);
 				}
-				else if (!str.compare("!"))
-					evaluation.push(!right.toNumber());
 				else
-					throw std::domain_error("Unknown operator: " + left.toString() + " " + str + " " + right.toString() + ".");
+					throw std::domain_error("Invalid token '" + tok.toString() + "'.");
+
+				if (stack.size() > program->maxStackSize)
+					program->maxStackSize = stack.size();
 			}
-			else if (tok->isNumber() || tok->isString())
+
+			if (stack.empty())
+				throw std::domain_error("Invalid equation.");
+		}
+		catch (std::domain_error& e)
+		{
+			program->code.clear();
+			program->error = e.what();
+		}
+
+		std::unique_lock<std::mutex> lock(programsLock);
+
+		// Another thread may have compiled the same expression meanwhile
+		auto it = programs.find(key);
+		if (it != programs.cend())
+		{
+			programList.splice(programList.begin(), programList, it->second);
+			return it->second->second;
+		}
+
+		if (programs.size() >= PROGRAM_CACHE_SIZE)
+		{
+			programs.erase(programList.back().first);
+			programList.pop_back();
+		}
+
+		programList.push_front(std::make_pair(key, std::shared_ptr<const Program>(program)));
+		programs[key] = programList.begin();
+		return program;
+	}
+
+	MathExpr::Value MathExpr::eval(const Program& program, ValueMap* vars)
+	{
+		if (!program.error.empty())
+			throw std::domain_error(program.error);
+
+		if (!program.variables.empty())
+		{
+			if (!vars)
+				throw std::domain_error("Detected variable, but the variable map is null.");
+
+			mSlots.resize(program.variables.size());
+
+			for (size_t i = 0; i < program.variables.size(); i++)
 			{
-				evaluation.push(*tok);
+				ValueMap::iterator it = vars->find(program.variables[i]);
+				if (it == vars->end())
+					throw std::domain_error("Unable to find the variable '" + program.variables[i] + "'.");
+
+				mSlots[i] = &it->second;
 			}
-			else
+		}
+
+		if (mStack.size() < program.maxStackSize)
+			mStack.resize(program.maxStackSize);
+
+		// The stack is reused between evaluations, so its values keep their string buffers
+		size_t top = 0;
+
+		for (auto& instruction : program.code)
+		{
+			switch (instruction.op)
 			{
-				throw std::domain_error("Invalid token '" + tok->toString() + "'.");
+			case OP_CONSTANT:
+				mStack[top++] = program.constants[instruction.arg];
+				break;
+			case OP_VARIABLE:
+				mStack[top++] = *mSlots[instruction.arg];
+				break;
+			default:
+				applyOperator(instruction.op, mStack[top - 2], mStack[top - 1]);
+				top--;
+				break;
 			}
-
-			delete tok;
 		}
-		return evaluation.top();
+
+		return mStack[top - 1];
+	}
+
+	MathExpr::Value MathExpr::eval(const char* expr, ValueMap* vars)
+	{
+		return eval(*compile(expr), vars);
 	}
-}
\ No newline at end of file
+}
@@ -11,6 +11,8 @@
 #include <string>
 #include <queue>
 #include <stack>
+#include <vector>
+#include <memory>
 
 namespace Utils
 {
@@ -24,7 +26,7 @@ namespace Utils
 			TOKEN = 1,
 			NUMBER = 2,
 			STRING = 4,
-
+			VARIABLE = 8	// Reference to a ValueMap entry, only used while compiling
 		};
 		struct Value
 		{
@@ -60,15 +62,41 @@ namespace Utils
 		typedef std::stack<Value> ValueStack;
 		typedef std::map<std::string, int> IntMap;
 
+		// An expression compiled to a stack bytecode. Constant sub-expressions are folded, and variables are referenced
+		// by slot, so they are looked up once per evaluation whatever the number of times they are used.
+		struct Program
+		{
+			struct Instruction
+			{
+				unsigned char op;
+				unsigned short arg;
+			};
+
+			std::vector<Instruction> code;
+			std::vector<Value> constants;
+			std::vector<std::string> variables;
+			unsigned int maxStackSize;
+
+			std::string error; // Set if the expression is invalid
+		};
+
 	public:
 		MathExpr();
 
 		MathExpr::Value eval(const char* expr, ValueMap* vars = 0);
+		MathExpr::Value eval(const Program& program, ValueMap* vars = 0);
+
+		// Programs are immutable & cached by expression, so they can be shared by all the evaluators
+		std::shared_ptr<const Program> compile(const char* expr);
 
 	private:
-		static ValuePtrQueue toRPN(const char* expr, ValueMap* vars, IntMap opPrecedence);
+		static std::vector<Value> toRPN(const char* expr, const IntMap& opPrecedence);
 
 		IntMap opPrecedence;
+
+		// Evaluation stack & variable slots, reused between evaluations
+		std::vector<Value> mStack;
+		std::vector<const Value*> mSlots;
 	};
 }
 
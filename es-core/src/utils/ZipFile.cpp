@@ -16,13 +16,83 @@
 #include "md5.h"
 #include "Log.h"
 
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
 namespace Utils
 {
 	namespace Zip
 	{
+		// Slice-by-8 tables for the zlib polynomial : miniz's nibble table only handles 4 bits per lookup
+		class Crc32Tables
+		{
+		public:
+			Crc32Tables()
+			{
+				for (unsigned int i = 0; i < 256; i++)
+				{
+					unsigned int crc = i;
+					for (int j = 0; j < 8; j++)
+						crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+
+					table[0][i] = crc;
+				}
+
+				for (unsigned int i = 0; i < 256; i++)
+					for (int slice = 1; slice < 8; slice++)
+						table[slice][i] = (table[slice - 1][i] >> 8) ^ table[0][table[slice - 1][i] & 0xFF];
+			}
+
+			unsigned int table[8][256];
+		};
+
+		static const Crc32Tables sCrc32Tables;
+
 		unsigned int ZipFile::computeCRC(unsigned int crc, const void* ptr, size_t buf_len)
-		{			
-			return (mz_uint32)mz_crc32((mz_uint32)crc, (const mz_uint8 *)ptr, buf_len);
+		{
+			if (ptr == nullptr)
+				return 0;
+
+			const unsigned char* data = (const unsigned char*)ptr;
+			uint32_t crcu32 = ~(uint32_t)crc;
+
+			// Align the pointer before the 8 bytes loop
+			while (buf_len > 0 && ((uintptr_t)data & 7) != 0)
+			{
+				crcu32 = (crcu32 >> 8) ^ sCrc32Tables.table[0][(crcu32 ^ *data++) & 0xFF];
+				buf_len--;
+			}
+
+#if defined(__ARM_FEATURE_CRC32)
+			// ARMv8 CRC32 instructions use the same polynomial as zlib
+			for (; buf_len >= 8; buf_len -= 8, data += 8)
+				crcu32 = __crc32d(crcu32, *(const uint64_t*)data);
+#else
+			const unsigned int (&t)[8][256] = sCrc32Tables.table;
+
+			for (; buf_len >= 8; buf_len -= 8, data += 8)
+			{
+				uint32_t lo, hi;
+				memcpy(&lo, data, 4);
+				memcpy(&hi, data + 4, 4);
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+				lo = __builtin_bswap32(lo);
+				hi = __builtin_bswap32(hi);
+#endif
+				lo ^= crcu32;
+
+				crcu32 =
+					t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+					t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+			}
+#endif
+
+			while (buf_len-- > 0)
+				crcu32 = (crcu32 >> 8) ^ sCrc32Tables.table[0][(crcu32 ^ *data++) & 0xFF];
+
+			return ~crcu32;
 		}
 
 		#define mZipArchive   ((mz_zip_archive*) mZipFile)
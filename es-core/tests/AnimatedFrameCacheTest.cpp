@@ -0,0 +1,201 @@
+#include "Test.h"
+
+#include "resources/AnimatedFrameCache.h"
+#include "resources/ResourceManager.h"
+#include "utils/FileSystemUtil.h"
+#include "ImageIO.h"
+#include <FreeImage.h>
+#include <chrono>
+#include <iostream>
+#include <string.h>
+#include <thread>
+
+// Writes an animated gif whose frames are full size greyscale gradients, a different one per frame
+static void writeGif(const std::string& path, int width, int height, int frameCount)
+{
+	Utils::FileSystem::removeFile(path);
+
+	FIMULTIBITMAP* gif = FreeImage_OpenMultiBitmap(FIF_GIF, path.c_str(), true, false);
+	CHECK(gif != nullptr);
+
+	for (int frame = 0; frame < frameCount; frame++)
+	{
+		FIBITMAP* image = FreeImage_Allocate(width, height, 8);
+		CHECK(image != nullptr);
+
+		for (int y = 0; y < height; y++)
+		{
+			BYTE* line = FreeImage_GetScanLine(image, y);
+			for (int x = 0; x < width; x++)
+				line[x] = (BYTE)(x + y * 3 + frame * 40);
+		}
+
+		FreeImage_AppendPage(gif, image);
+		FreeImage_Unload(image);
+	}
+
+	CHECK(FreeImage_CloseMultiBitmap(gif));
+}
+
+// The previous decoding of a frame : the multibitmap is opened & played up to the frame
+static unsigned char* loadSubImage(const std::string& path, int index, size_t& width, size_t& height)
+{
+	const ResourceData& data = ResourceManager::getInstance()->getFileData(path);
+
+	MaxSizeInfo maxSize(1000, 1000, false);
+	return ImageIO::loadFromMemoryRGBA32(data.ptr.get(), data.length, width, height, &maxSize, nullptr, nullptr, index);
+}
+
+// The first request of a source may return nothing while the worker has not started it : the caller decodes the frame itself then
+static unsigned char* getCachedFrame(AnimatedFrameCache& cache, const std::string& path, int index, size_t& width, size_t& height)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	while (true)
+	{
+		MaxSizeInfo maxSize(1000, 1000, false);
+		Vector2i baseSize, packedSize;
+
+		unsigned char* data = cache.getFrame(path, index, maxSize, width, height, baseSize, packedSize);
+		if (data != nullptr)
+			return data;
+
+		if (std::chrono::steady_clock::now() - start > std::chrono::seconds(10))
+			Test::fail(__FILE__, __LINE__, "no frame " + std::to_string(index) + " for " + path);
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+static void checkFrames(AnimatedFrameCache& cache, const std::string& path, int frameCount)
+{
+	for (int i = 0; i < frameCount; i++)
+	{
+		size_t expectedWidth, expectedHeight;
+		unsigned char* expected = loadSubImage(path, i, expectedWidth, expectedHeight);
+		CHECK(expected != nullptr);
+
+		size_t width, height;
+		unsigned char* frame = getCachedFrame(cache, path, i, width, height);
+
+		CHECK_EQUAL(expectedWidth, width);
+		CHECK_EQUAL(expectedHeight, height);
+		CHECK(memcmp(expected, frame, width * height * 4) == 0);
+
+		delete[] expected;
+		delete[] frame;
+	}
+}
+
+// The single multibitmap pass gives the frames the per frame decoding gives
+TEST(AnimatedFrameCache_framesMatchSubImages)
+{
+	std::string root = Test::getTempPath();
+	FreeImage_Initialise();
+
+	writeGif(root + "/a.gif", 40, 30, 6);
+
+	AnimatedFrameCache cache;
+	checkFrames(cache, root + "/a.gif", 6);
+
+	// Revisits are served from the cache
+	CHECK_EQUAL((size_t)1, cache.getSourceCount());
+	CHECK_EQUAL((size_t)6 * 40 * 30 * 4, cache.getCost());
+	checkFrames(cache, root + "/a.gif", 6);
+	CHECK_EQUAL((size_t)6 * 40 * 30 * 4, cache.getCost());
+
+	// A changed file is decoded again
+	writeGif(root + "/a.gif", 20, 30, 3);
+	checkFrames(cache, root + "/a.gif", 3);
+	CHECK_EQUAL((size_t)1, cache.getSourceCount());
+	CHECK_EQUAL((size_t)3 * 20 * 30 * 4, cache.getCost());
+
+	FreeImage_DeInitialise();
+}
+
+TEST(AnimatedFrameCache_evictsLeastRecentlyUsed)
+{
+	std::string root = Test::getTempPath();
+	FreeImage_Initialise();
+
+	const size_t sourceCost = 4 * 40 * 30 * 4;
+
+	for (auto name : { "a", "b", "c" })
+		writeGif(root + "/" + name + ".gif", 40, 30, 4);
+
+	writeGif(root + "/large.gif", 40, 30, 8);
+
+	// Room for two sources
+	AnimatedFrameCache cache(sourceCost * 5 / 2);
+
+	checkFrames(cache, root + "/a.gif", 4);
+	checkFrames(cache, root + "/b.gif", 4);
+	CHECK_EQUAL(2 * sourceCost, cache.getCost());
+
+	// a is used again, so b goes when c comes
+	checkFrames(cache, root + "/a.gif", 4);
+	checkFrames(cache, root + "/c.gif", 4);
+	CHECK_EQUAL((size_t)2, cache.getSourceCount());
+	CHECK_EQUAL(2 * sourceCost, cache.getCost());
+
+	// b is decoded again : a is the least recently used now
+	checkFrames(cache, root + "/b.gif", 4);
+	CHECK_EQUAL(2 * sourceCost, cache.getCost());
+
+	// A source taking more than half of the budget is never kept : the caller decodes it
+	for (int i = 0; i < 50; i++)
+	{
+		MaxSizeInfo maxSize(1000, 1000, false);
+		size_t width, height;
+		Vector2i baseSize, packedSize;
+
+		CHECK(cache.getFrame(root + "/large.gif", 0, maxSize, width, height, baseSize, packedSize) == nullptr);
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	}
+
+	CHECK_EQUAL(2 * sourceCost, cache.getCost());
+
+	FreeImage_DeInitialise();
+}
+
+// Playing an animation twice : every frame decoded by replaying the gif up to it, against the cache
+BENCHMARK(AnimatedFrameCache_playback)
+{
+	const int frameCount = 60;
+
+	std::string root = Test::getTempPath();
+	FreeImage_Initialise();
+
+	writeGif(root + "/anim.gif", 480, 270, frameCount);
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (int i = 0; i < frameCount; i++)
+		{
+			size_t width, height;
+			delete[] loadSubImage(root + "/anim.gif", i, width, height);
+		}
+	}
+
+	auto subImages = std::chrono::steady_clock::now();
+
+	AnimatedFrameCache cache;
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (int i = 0; i < frameCount; i++)
+		{
+			size_t width, height;
+			delete[] getCachedFrame(cache, root + "/anim.gif", i, width, height);
+		}
+	}
+
+	auto cached = std::chrono::steady_clock::now();
+
+	std::cout << "  " << frameCount << " frames 480x270 played twice : per frame decoding " << std::chrono::duration<double, std::milli>(subImages - start).count()
+		<< " ms, frame cache " << std::chrono::duration<double, std::milli>(cached - subImages).count() << " ms" << std::endl;
+
+	FreeImage_DeInitialise();
+}
@@ -0,0 +1,57 @@
+#include "Test.h"
+
+#include "utils/FileSystemUtil.h"
+#include "utils/ZipFile.h"
+#include "utils/md5.h"
+#include "utils/StringUtil.h"
+#include <fstream>
+#include <random>
+#include <vector>
+
+static std::string createFile(const std::string& path, size_t size)
+{
+	std::mt19937 random(size);
+
+	std::string data(size, '\0');
+	for (auto& value : data)
+		value = (char)random();
+
+	std::ofstream(path, std::ios::binary).write(data.data(), data.size());
+	return data;
+}
+
+// One read gives the crc32, the md5 and the data itself, each the same as computed separately
+TEST(FileSystem_getFileHashesSingleRead)
+{
+	std::string root = Test::getTempPath();
+
+	// Empty, smaller than the read buffer, and spanning several reads
+	for (size_t size : { 0, 1000, 3 * 1024 * 1024 + 17 })
+	{
+		std::string path = root + "/rom" + std::to_string(size) + ".bin";
+		std::string data = createFile(path, size);
+
+		std::string expectedCrc = Utils::String::toHexString(Utils::Zip::ZipFile::computeCRC(0, data.data(), data.size()));
+		std::string expectedMd5 = MD5(data).hexdigest();
+
+		std::string crc32;
+		std::string md5;
+		std::string received;
+
+		CHECK(Utils::FileSystem::getFileHashes(path, &crc32, &md5, [&received](const void* buffer, size_t length)
+		{
+			received.append((const char*)buffer, length);
+			return true;
+		}));
+
+		CHECK_EQUAL(expectedCrc, crc32);
+		CHECK_EQUAL(expectedMd5, md5);
+		CHECK(received == data);
+
+		CHECK_EQUAL(expectedCrc, Utils::FileSystem::getFileCrc32(path));
+		CHECK_EQUAL(expectedMd5, Utils::FileSystem::getFileMd5(path));
+	}
+
+	std::string crc32;
+	CHECK(!Utils::FileSystem::getFileHashes(root + "/missing.bin", &crc32, nullptr));
+}
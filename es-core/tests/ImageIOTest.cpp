@@ -0,0 +1,139 @@
+#include "Test.h"
+
+#include "ImageIO.h"
+#include <FreeImage.h>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+// The value of a channel of pixel x on scanline y, far enough from the neighbouring ones to catch swapped channels
+static unsigned char getChannel(int x, int y, int channel)
+{
+	return (unsigned char)(x * 7 + y * 31 + channel * 64 + 1);
+}
+
+static FIBITMAP* createBitmap(int width, int height, int bpp)
+{
+	FIBITMAP* image = FreeImage_Allocate(width, height, bpp);
+	CHECK(image != nullptr);
+
+	for (int y = 0; y < height; y++)
+	{
+		BYTE* line = FreeImage_GetScanLine(image, y);
+		for (int x = 0; x < width; x++)
+		{
+			if (bpp == 8)
+			{
+				line[x] = getChannel(x, y, 0);
+				continue;
+			}
+
+			BYTE* px = line + x * bpp / 8;
+			px[FI_RGBA_RED] = getChannel(x, y, 0);
+			px[FI_RGBA_GREEN] = getChannel(x, y, 1);
+			px[FI_RGBA_BLUE] = getChannel(x, y, 2);
+
+			if (bpp == 32)
+				px[FI_RGBA_ALPHA] = getChannel(x, y, 3);
+		}
+	}
+
+	return image;
+}
+
+static std::vector<unsigned char> saveToMemory(FIBITMAP* image, FREE_IMAGE_FORMAT format)
+{
+	FIMEMORY* memory = FreeImage_OpenMemory();
+	CHECK(memory != nullptr);
+	CHECK(FreeImage_SaveToMemory(format, image, memory));
+
+	BYTE* data = nullptr;
+	DWORD size = 0;
+	FreeImage_AcquireMemory(memory, &data, &size);
+
+	std::vector<unsigned char> file(data, data + size);
+	FreeImage_CloseMemory(memory);
+
+	return file;
+}
+
+// Widths up to 69 go through the 4 & 16 pixels loops and every length of scalar tail
+TEST(ImageIO_loadFromMemoryRGBA32Conversion)
+{
+	FreeImage_Initialise();
+
+	const int height = 3;
+
+	for (int bpp : { 8, 24, 32 })
+	{
+		for (int width = 1; width < 70; width++)
+		{
+			FIBITMAP* image = createBitmap(width, height, bpp);
+			auto file = saveToMemory(image, FIF_PNG);
+			FreeImage_Unload(image);
+
+			size_t outWidth = 0;
+			size_t outHeight = 0;
+			unsigned char* data = ImageIO::loadFromMemoryRGBA32(file.data(), file.size(), outWidth, outHeight);
+			CHECK(data != nullptr);
+			CHECK_EQUAL((size_t)width, outWidth);
+			CHECK_EQUAL((size_t)height, outHeight);
+
+			for (int y = 0; y < height; y++)
+			{
+				for (int x = 0; x < width; x++)
+				{
+					const unsigned char* px = data + (y * width + x) * 4;
+
+					if (bpp == 8)
+					{
+						CHECK_EQUAL((int)getChannel(x, y, 0), (int)px[0]);
+						CHECK_EQUAL((int)getChannel(x, y, 0), (int)px[1]);
+						CHECK_EQUAL((int)getChannel(x, y, 0), (int)px[2]);
+						CHECK_EQUAL(255, (int)px[3]);
+						continue;
+					}
+
+					CHECK_EQUAL((int)getChannel(x, y, 0), (int)px[0]);
+					CHECK_EQUAL((int)getChannel(x, y, 1), (int)px[1]);
+					CHECK_EQUAL((int)getChannel(x, y, 2), (int)px[2]);
+					CHECK_EQUAL(bpp == 32 ? (int)getChannel(x, y, 3) : 255, (int)px[3]);
+				}
+			}
+
+			delete[] data;
+		}
+	}
+
+	FreeImage_DeInitialise();
+}
+
+// Uncompressed bitmaps, so the time is mostly the conversion to RGBA
+BENCHMARK(ImageIO_loadFromMemoryRGBA32)
+{
+	const int count = 20;
+
+	FreeImage_Initialise();
+
+	for (int bpp : { 24, 32 })
+	{
+		FIBITMAP* image = createBitmap(1920, 1080, bpp);
+		auto file = saveToMemory(image, FIF_BMP);
+		FreeImage_Unload(image);
+
+		auto start = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < count; i++)
+		{
+			size_t width = 0;
+			size_t height = 0;
+			delete[] ImageIO::loadFromMemoryRGBA32(file.data(), file.size(), width, height);
+		}
+
+		auto end = std::chrono::steady_clock::now();
+
+		std::cout << "  1920x1080 " << bpp << " bits bmp : " << std::chrono::duration<double, std::milli>(end - start).count() / count << " ms per image" << std::endl;
+	}
+
+	FreeImage_DeInitialise();
+}
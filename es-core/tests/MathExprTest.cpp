@@ -0,0 +1,406 @@
+#include "Test.h"
+
+#include "utils/MathExpr.h"
+#include <chrono>
+#include <iostream>
+#include <math.h>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <stdio.h>
+
+// The tree-walking interpreter MathExpr used before expressions were compiled to a bytecode, kept as the reference
+// the compiled programs are checked against. Only changed to hold its tokens by value and to throw on an empty stack.
+namespace Reference
+{
+	typedef Utils::MathExpr::Value Value;
+	typedef Utils::MathExpr::ValueMap ValueMap;
+
+	#define isvariablechar(c) (isalpha(c) || c == '_')
+
+	static std::queue<Value> toRPN(const char* expr, ValueMap* vars, std::map<std::string, int> opPrecedence)
+	{
+		std::queue<Value> rpnQueue; std::stack<std::string> operatorStack;
+		bool lastTokenWasOp = true;
+
+		while (*expr && isspace(*expr)) ++expr;
+
+		while (*expr)
+		{
+			if (isdigit(*expr))
+			{
+				char* nextChar = 0;
+				float digit = strtod(expr, &nextChar);
+
+				rpnQueue.push(Value(digit));
+				expr = nextChar;
+				lastTokenWasOp = false;
+			}
+			else if (isvariablechar(*expr) || *expr == '{' || *expr == '$')
+			{
+				if (!vars)
+					throw std::domain_error("Detected variable, but the variable map is null.");
+
+				std::stringstream ss;
+
+				if (*expr == '$' && *(expr + 1) == '{')
+					expr++;
+
+				if (*expr == '{')
+				{
+					++expr;
+					while (*expr != '}' && *expr != 0)
+					{
+						ss << *expr;
+						++expr;
+					}
+
+					if (*expr == '}')
+						expr++;
+				}
+				else
+				{
+					ss << *expr;
+					++expr;
+					while (isvariablechar(*expr))
+					{
+						ss << *expr;
+						++expr;
+					}
+				}
+
+				std::string key = ss.str();
+				if (key == "true")
+					rpnQueue.push(Value(1));
+				else if (key == "false")
+					rpnQueue.push(Value(0));
+				else
+				{
+					ValueMap::iterator it = vars->find(key);
+					if (it == vars->end())
+						throw std::domain_error("Unable to find the variable '" + key + "'.");
+
+					rpnQueue.push(Value(it->second));
+				}
+
+				lastTokenWasOp = false;
+			}
+			else if (*expr == '\'' || *expr == '"')
+			{
+				char startChr = *expr;
+
+				std::stringstream ss;
+				++expr;
+				while (*expr && *expr != startChr)
+				{
+					ss << *expr;
+					++expr;
+				}
+				if (*expr) expr++;
+
+				rpnQueue.push(Value(ss.str()));
+				lastTokenWasOp = false;
+			}
+			else
+			{
+				switch (*expr)
+				{
+				case '(':
+					operatorStack.push("(");
+					++expr;
+					break;
+				case ')':
+					while (!operatorStack.empty() && operatorStack.top().compare("("))
+					{
+						rpnQueue.push(Value(operatorStack.top(), Utils::MathExpr::TOKEN));
+						operatorStack.pop();
+					}
+					if (operatorStack.empty())
+						throw std::domain_error("Invalid equation.");
+					operatorStack.pop();
+					++expr;
+					break;
+				default:
+				{
+					std::stringstream ss;
+					ss << *expr;
+					++expr;
+					while (*expr && !isspace(*expr) && !isdigit(*expr) && !isvariablechar(*expr) && *expr != '(' && *expr != ')')
+					{
+						ss << *expr;
+						++expr;
+					}
+
+					ss.clear();
+					std::string str;
+					ss >> str;
+
+					if (lastTokenWasOp)
+					{
+						if (!str.compare("-") || !str.compare("+") || !str.compare("!"))
+							rpnQueue.push(Value(0));
+						else
+							throw std::domain_error("Unrecognized unary operator: '" + str + "'");
+					}
+
+					while (!operatorStack.empty() && opPrecedence[str] <= opPrecedence[operatorStack.top()])
+					{
+						rpnQueue.push(Value(operatorStack.top(), Utils::MathExpr::TOKEN));
+						operatorStack.pop();
+					}
+					operatorStack.push(str);
+					lastTokenWasOp = true;
+				}
+				}
+			}
+			while (*expr && isspace(*expr)) ++expr;
+		}
+		while (!operatorStack.empty())
+		{
+			rpnQueue.push(Value(operatorStack.top(), Utils::MathExpr::TOKEN));
+			operatorStack.pop();
+		}
+		return rpnQueue;
+	}
+
+	static Value eval(const char* expr, ValueMap* vars)
+	{
+		std::map<std::string, int> opPrecedence;
+		opPrecedence["("] = -10;
+		opPrecedence["&&"] = -2; opPrecedence["||"] = -3;
+		opPrecedence[">"] = -1; opPrecedence[">="] = -1;
+		opPrecedence["<"] = -1; opPrecedence["<="] = -1;
+		opPrecedence["=="] = -1; opPrecedence["!="] = -1;
+		opPrecedence["<<"] = 1; opPrecedence[">>"] = 1;
+		opPrecedence["+"] = 2; opPrecedence["-"] = 2;
+		opPrecedence["*"] = 3; opPrecedence["/"] = 3;
+		opPrecedence["^"] = 4;
+		opPrecedence["!"] = 5;
+
+		std::queue<Value> rpn = toRPN(expr, vars, opPrecedence);
+		std::stack<Value> evaluation;
+
+		while (!rpn.empty())
+		{
+			Value tok = rpn.front();
+			rpn.pop();
+
+			if (tok.isToken())
+			{
+				std::string str = tok.string;
+				if (evaluation.size() < 2)
+					throw std::domain_error("Invalid equation.");
+
+				Value right = evaluation.top(); evaluation.pop();
+				Value left = evaluation.top(); evaluation.pop();
+				if (!str.compare("+") && left.isNumber())
+					evaluation.push(left.number + right.toNumber());
+				if (!str.compare("+") && left.isString())
+					evaluation.push(left.string + right.toString());
+				else if (!str.compare("*"))
+					evaluation.push(left.toNumber() * right.toNumber());
+				else if (!str.compare("-"))
+					evaluation.push(left.toNumber() - right.toNumber());
+				else if (!str.compare("/"))
+				{
+					float r = right.toNumber();
+					if (r == 0)
+						evaluation.push(0);
+					else
+						evaluation.push(left.toNumber() / r);
+				}
+				else if (!str.compare("<<"))
+					evaluation.push((int)left.toNumber() << (int)right.toNumber());
+				else if (!str.compare("^"))
+					evaluation.push(pow(left.toNumber(), right.toNumber()));
+				else if (!str.compare(">>"))
+					evaluation.push((int)left.toNumber() >> (int)right.toNumber());
+				else if (!str.compare(">"))
+					evaluation.push(left.toNumber() > right.toNumber());
+				else if (!str.compare(">="))
+					evaluation.push(left.toNumber() >= right.toNumber());
+				else if (!str.compare("<"))
+					evaluation.push(left.toNumber() < right.toNumber());
+				else if (!str.compare("<="))
+					evaluation.push(left.toNumber() <= right.toNumber());
+				else if (!str.compare("&&"))
+					evaluation.push(left.toNumber() && right.toNumber());
+				else if (!str.compare("||"))
+					evaluation.push(left.toNumber() || right.toNumber());
+				else if (!str.compare("=="))
+				{
+					if (left.isNumber() && right.isNumber())
+						evaluation.push(left.number == right.number);
+					else if (left.isString() && right.isString())
+						evaluation.push(left.string == right.string);
+					else if (left.isString())
+						evaluation.push(left.string == right.toString());
+					else
+						evaluation.push(left.toNumber() == right.toNumber());
+				}
+				else if (!str.compare("!="))
+				{
+					if (left.isNumber() && right.isNumber())
+						evaluation.push(left.number != right.number);
+					else if (left.isString() && right.isString())
+						evaluation.push(left.string != right.string);
+					else if (left.isString())
+						evaluation.push(left.string != right.toString());
+					else
+						evaluation.push(left.toNumber() != right.toNumber());
+				}
+				else if (!str.compare("!"))
+					evaluation.push(!right.toNumber());
+				else
+					throw std::domain_error("Unknown operator: " + left.toString() + " " + str + " " + right.toString() + ".");
+			}
+			else if (tok.isNumber() || tok.isString())
+				evaluation.push(tok);
+			else
+				throw std::domain_error("Invalid token '" + tok.toString() + "'.");
+		}
+
+		if (evaluation.empty())
+			throw std::domain_error("Invalid equation.");
+
+		return evaluation.top();
+	}
+
+	#undef isvariablechar
+}
+
+static Utils::MathExpr::ValueMap getTestVariables()
+{
+	Utils::MathExpr::ValueMap vars;
+	vars["x"] = Utils::MathExpr::Value(2.0f);
+	vars["y"] = Utils::MathExpr::Value(std::string("7"));
+	vars["s"] = Utils::MathExpr::Value(std::string("hello"));
+	vars["screen.width"] = Utils::MathExpr::Value(1920.0f);
+	vars["system.theme"] = Utils::MathExpr::Value(std::string("snes"));
+	return vars;
+}
+
+// Formats the result, or the error, so both evaluators can be compared
+template<typename Evaluator>
+static std::string evaluate(Evaluator evaluator, const std::string& expr)
+{
+	auto vars = getTestVariables();
+
+	try
+	{
+		auto value = evaluator(expr.c_str(), &vars);
+
+		char number[64];
+		snprintf(number, sizeof(number), "%g", value.isNumber() ? (double)value.number : 0.0);
+		return std::to_string(value.type & (Utils::MathExpr::NUMBER | Utils::MathExpr::STRING)) + "|" + number + "|" + (value.isString() ? value.string : "");
+	}
+	catch (std::domain_error&)
+	{
+		return "error";
+	}
+}
+
+static std::string generateExpression(std::mt19937& random)
+{
+	static const char* tokens[] = {
+		"1", "2", "0", "3.5", "10", "x", "y", "s", "'ab'", "\"5\"", "true", "false", "{screen.width}", "${system.theme}", "unknown",
+		"+", "-", "*", "/", "^", "<<", ">>", ">", ">=", "<", "<=", "==", "!=", "&&", "||", "!", "%", "(", ")", " " };
+
+	const int tokenCount = sizeof(tokens) / sizeof(tokens[0]);
+
+	std::string expr;
+
+	int count = 1 + random() % 10;
+	for (int i = 0; i < count; i++)
+	{
+		expr += tokens[random() % tokenCount];
+		if (random() % 2)
+			expr += " ";
+	}
+
+	return expr;
+}
+
+TEST(MathExpr_matchesReference)
+{
+	static const char* expressions[] = {
+		"1 + 2 * 3", "(1 + 2) * 3", "-x + 4", "!x", "x ^ 3 / 4", "10 / 0", "1 << 4 >> 2",
+		"${screen.width} > 1280 && ${system.theme} == 'snes'", "{screen.width} >= 1920 || x", "s + ' world'", "s + x",
+		"y == 7", "y != '7'", "s == 'hello'", "x == '2.000000'", "'a' + 'b' + 'c'", "true && !false", "unknown + 1", "1 +", "()", "" };
+
+	Utils::MathExpr mathExpr;
+	auto compiled = [&mathExpr](const char* expr, Utils::MathExpr::ValueMap* vars) { return mathExpr.eval(expr, vars); };
+
+	for (auto expr : expressions)
+		CHECK_EQUAL(evaluate(Reference::eval, expr), evaluate(compiled, expr));
+}
+
+TEST(MathExpr_fuzzAgainstReference)
+{
+	std::mt19937 random(1234);
+
+	Utils::MathExpr mathExpr;
+	auto compiled = [&mathExpr](const char* expr, Utils::MathExpr::ValueMap* vars) { return mathExpr.eval(expr, vars); };
+
+	for (int i = 0; i < 50000; i++)
+	{
+		std::string expr = generateExpression(random);
+
+		auto expected = evaluate(Reference::eval, expr);
+		auto actual = evaluate(compiled, expr);
+
+		if (expected != actual)
+			Test::fail(__FILE__, __LINE__, "[" + expr + "] gives " + actual + ", expected " + expected);
+	}
+}
+
+TEST(MathExpr_programCacheKeepsRecentPrograms)
+{
+	Utils::MathExpr mathExpr;
+
+	auto hot = mathExpr.compile("${screen.width} * 2");
+
+	// More distinct expressions than the cache holds, the hot one being used all along
+	for (int i = 0; i < 10000; i++)
+	{
+		mathExpr.compile(("x + " + std::to_string(i)).c_str());
+
+		if (i % 100 == 0)
+			CHECK(mathExpr.compile("${screen.width} * 2") == hot);
+	}
+
+	CHECK(mathExpr.compile("${screen.width} * 2") == hot);
+}
+
+BENCHMARK(MathExpr_evaluation)
+{
+	static const char* expressions[] = {
+		"${screen.width} > 1280 && ${system.theme} == 'snes'",
+		"(x * 4 - 1) / 2 >= 3",
+		"s + ' world'" };
+
+	const int iterations = 200000;
+
+	Utils::MathExpr mathExpr;
+
+	for (auto expr : expressions)
+	{
+		auto vars = getTestVariables();
+		float sum = 0;
+
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; i++)
+			sum += Reference::eval(expr, &vars).toNumber();
+
+		auto reference = std::chrono::steady_clock::now();
+
+		auto program = mathExpr.compile(expr);
+		for (int i = 0; i < iterations; i++)
+			sum += mathExpr.eval(*program, &vars).toNumber();
+
+		auto compiled = std::chrono::steady_clock::now();
+
+		std::cout << "  " << expr << " : interpreter " << std::chrono::duration_cast<std::chrono::nanoseconds>(reference - start).count() / iterations << " ns"
+			<< ", compiled " << std::chrono::duration_cast<std::chrono::nanoseconds>(compiled - reference).count() / iterations << " ns (" << sum << ")" << std::endl;
+	}
+}
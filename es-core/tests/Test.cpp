@@ -0,0 +1,128 @@
+#include "Test.h"
+
+#include "utils/FileSystemUtil.h"
+#include "utils/StringUtil.h"
+#include "Paths.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+namespace Test
+{
+	class TestFailure : public std::runtime_error
+	{
+	public:
+		TestFailure(const std::string& message) : std::runtime_error(message) { }
+	};
+
+	static std::string sRootPath;
+	static std::string sTempPath;
+	static int sTempCount = 0;
+
+	std::vector<TestCase>& getTestCases()
+	{
+		static std::vector<TestCase> testCases;
+		return testCases;
+	}
+
+	void fail(const char* file, int line, const std::string& message)
+	{
+		throw TestFailure(Utils::FileSystem::getFileName(file) + ":" + std::to_string(line) + " : " + message);
+	}
+
+	std::string getTempPath()
+	{
+		std::string path = sTempPath + "/" + std::to_string(++sTempCount);
+		Utils::FileSystem::createDirectory(path);
+		return path;
+	}
+
+	static bool runTestCase(const TestCase& testCase)
+	{
+		sTempPath = sRootPath + "/" + testCase.name;
+		sTempCount = 0;
+
+		Utils::FileSystem::deleteDirectoryFiles(sTempPath, true);
+		Utils::FileSystem::createDirectory(sTempPath);
+
+		std::string error;
+		auto start = std::chrono::steady_clock::now();
+
+		try
+		{
+			testCase.function();
+		}
+		catch (TestFailure& e)
+		{
+			error = e.what();
+		}
+		catch (std::exception& e)
+		{
+			error = std::string("Exception : ") + e.what();
+		}
+		catch (...)
+		{
+			error = "Unknown exception";
+		}
+
+		auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+		Utils::FileSystem::deleteDirectoryFiles(sTempPath, true);
+
+		if (!error.empty())
+		{
+			std::cout << "FAILED " << testCase.name << " : " << error << std::endl;
+			return false;
+		}
+
+		std::cout << "passed " << testCase.name << " (" << elapsed << " ms)" << std::endl;
+		return true;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	bool benchmarks = false;
+	std::vector<std::string> filters;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--benchmark")
+			benchmarks = true;
+		else
+			filters.push_back(argv[i]);
+	}
+
+	// Settings & caches are written to a folder of their own, never to the user's one
+	Test::sRootPath = Utils::FileSystem::getGenericPath(Utils::FileSystem::getCWDPath()) + "/es-tests.tmp";
+	Utils::FileSystem::createDirectory(Test::sRootPath);
+
+	Paths::getUserEmulationStationPath() = Test::sRootPath + "/home";
+	Utils::FileSystem::createDirectory(Paths::getUserEmulationStationPath());
+
+	int count = 0;
+	int failed = 0;
+
+	for (auto& testCase : Test::getTestCases())
+	{
+		if (testCase.benchmark != benchmarks)
+			continue;
+
+		if (!filters.empty() && std::none_of(filters.cbegin(), filters.cend(), [&testCase](const std::string& filter) { return Utils::String::startsWith(testCase.name, filter); }))
+			continue;
+
+		count++;
+		if (!Test::runTestCase(testCase))
+			failed++;
+	}
+
+	if (count == 0)
+	{
+		std::cout << "No test found" << std::endl;
+		return 1;
+	}
+
+	std::cout << (count - failed) << "/" << count << " passed" << std::endl;
+	return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#ifndef ES_CORE_TESTS_TEST_H
+#define ES_CORE_TESTS_TEST_H
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Minimal unit test harness, shared by the es-core and es-app test executables.
+//
+// TEST(name) registers a test, CHECK / CHECK_EQUAL stop it on the first failure.
+// BENCHMARK(name) registers a benchmark, which only runs when asked for with --benchmark.
+//
+//   es-core-tests                  runs every test
+//   es-core-tests MathExpr         runs the tests whose name starts with "MathExpr"
+//   es-core-tests --benchmark      runs the benchmarks instead
+namespace Test
+{
+	typedef void(*TestFunction)();
+
+	struct TestCase
+	{
+		const char*		name;
+		TestFunction	function;
+		bool			benchmark;
+	};
+
+	std::vector<TestCase>& getTestCases();
+
+	struct Registrar
+	{
+		Registrar(const char* name, TestFunction function, bool benchmark) { getTestCases().push_back({ name, function, benchmark }); }
+	};
+
+	[[noreturn]] void fail(const char* file, int line, const std::string& message);
+
+	// Creates an empty folder for the running test, removed when the test ends
+	std::string getTempPath();
+}
+
+#define TEST(name) \
+	static void test_##name(); \
+	static Test::Registrar registrar_##name(#name, test_##name, false); \
+	static void test_##name()
+
+#define BENCHMARK(name) \
+	static void benchmark_##name(); \
+	static Test::Registrar registrar_##name(#name, benchmark_##name, true); \
+	static void benchmark_##name()
+
+#define CHECK(condition) \
+	do { if (!(condition)) Test::fail(__FILE__, __LINE__, #condition); } while (0)
+
+#define CHECK_EQUAL(expected, actual) \
+	do \
+	{ \
+		auto _expected = (expected); \
+		auto _actual = (actual); \
+		if (!(_expected == _actual)) \
+		{ \
+			std::stringstream _message; \
+			_message << #actual << " is " << _actual << ", expected " << _expected; \
+			Test::fail(__FILE__, __LINE__, _message.str()); \
+		} \
+	} while (0)
+
+#endif // ES_CORE_TESTS_TEST_H
@@ -0,0 +1,196 @@
+#include "Test.h"
+
+#include "anim/ThemeAnimation.h"
+#include "anim/ThemeStoryboard.h"
+#include "utils/FileSystemUtil.h"
+#include "Paths.h"
+#include "Settings.h"
+#include "ThemeData.h"
+#include <chrono>
+#include <fstream>
+#include <set>
+#include <thread>
+
+static const char* sThemeXml =
+	"<theme>"
+	"  <formatVersion>7</formatVersion>"
+	"  <view name=\"system\">"
+	"    <image name=\"logo\">"
+	"      <pos>0.1 0.2</pos>"
+	"      <size>0.5 0.25</size>"
+	"      <path>./logo.png</path>"
+	"      <color>FF8000C0</color>"
+	"      <padding>0.01 0.02 0.03 0.04</padding>"
+	"      <visible>true</visible>"
+	"      <storyboard event=\"activate\" repeat=\"2\">"
+	"        <animation property=\"opacity\" from=\"0\" to=\"1\" duration=\"300\" begin=\"50\" mode=\"easeOut\" />"
+	"        <animation property=\"pos\" from=\"0 0\" to=\"0.1 0.2\" duration=\"200\" autoReverse=\"true\" />"
+	"        <animation property=\"color\" from=\"FFFFFF00\" to=\"FF8000C0\" duration=\"100\" />"
+	"      </storyboard>"
+	"    </image>"
+	"    <text name=\"title, subtitle\">"
+	"      <text>Hello</text>"
+	"      <fontSize>0.05</fontSize>"
+	"      <alignment>center</alignment>"
+	"    </text>"
+	"  </view>"
+	"  <view name=\"basic, detailed\">"
+	"    <text name=\"md_name\">"
+	"      <pos>0.5 0.5</pos>"
+	"      <forceUppercase>true</forceUppercase>"
+	"    </text>"
+	"  </view>"
+	"  <customView name=\"mine\" inherits=\"basic\">"
+	"    <image name=\"background\">"
+	"      <path>./logo.png</path>"
+	"      <rotation>45</rotation>"
+	"    </image>"
+	"  </customView>"
+	"</theme>";
+
+static std::string toString(const ThemeData::ThemeElement::Property& property)
+{
+	typedef ThemeData::ThemeElement::Property Property;
+
+	std::stringstream ss;
+	switch (property.type)
+	{
+	case Property::PropertyType::String: ss << "string " << property.s; break;
+	case Property::PropertyType::Int: ss << "int " << property.i; break;
+	case Property::PropertyType::Float: ss << "float " << property.f; break;
+	case Property::PropertyType::Bool: ss << "bool " << property.b; break;
+	case Property::PropertyType::Pair: ss << "pair " << property.v.x() << " " << property.v.y(); break;
+	case Property::PropertyType::Rect: ss << "rect " << property.r.x() << " " << property.r.y() << " " << property.r.z() << " " << property.r.w(); break;
+	default: ss << "unknown"; break;
+	}
+
+	return ss.str();
+}
+
+// Describes everything an element holds, so that two elements can be compared as strings
+static std::string toString(const ThemeData::ThemeElement& element)
+{
+	std::stringstream ss;
+	ss << element.type << " extra=" << element.extra << "\n";
+
+	for (auto& property : element.properties)
+		ss << "  " << ThemeData::ThemeElement::getPropertyName(property.first) << " = " << toString(property.second) << "\n";
+
+	for (auto& storyboard : element.mStoryBoards)
+	{
+		ss << "  storyboard " << storyboard.first << " event=" << storyboard.second->eventName << " repeat=" << storyboard.second->repeat << " repeatAt=" << storyboard.second->repeatAt << "\n";
+
+		for (auto anim : storyboard.second->animations)
+		{
+			ss << "    " << anim->propertyName << " id=" << anim->propertyId << " duration=" << anim->duration << " begin=" << anim->begin
+				<< " autoReverse=" << anim->autoReverse << " repeat=" << anim->repeat << " easing=" << (int)anim->easingMode
+				<< " from=" << toString(anim->from) << " to=" << toString(anim->to) << "\n";
+		}
+	}
+
+	return ss.str();
+}
+
+static void checkSameViews(ThemeData& expected, ThemeData& actual)
+{
+	for (auto view : { "system", "basic", "detailed", "mine", "video" })
+	{
+		CHECK_EQUAL(expected.hasView(view), actual.hasView(view));
+		CHECK_EQUAL(expected.isCustomView(view), actual.isCustomView(view));
+		CHECK_EQUAL(expected.getCustomViewBaseType(view), actual.getCustomViewBaseType(view));
+
+		for (auto type : { "image", "text" })
+		{
+			auto names = expected.getElementNames(view, type);
+			CHECK(names == actual.getElementNames(view, type));
+
+			for (auto name : names)
+				CHECK_EQUAL(toString(*expected.getElement(view, name, type)), toString(*actual.getElement(view, name, type)));
+		}
+	}
+}
+
+TEST(ThemeData_compiledThemeMatchesXml)
+{
+	std::string root = Test::getTempPath();
+	std::string themePath = root + "/theme.xml";
+	std::string compiledFolder = Paths::getUserEmulationStationPath() + "/cache/themes";
+
+	std::ofstream(themePath) << sThemeXml;
+	std::ofstream(root + "/logo.png");
+
+	Utils::FileSystem::deleteDirectoryFiles(compiledFolder);
+
+	Settings::getInstance()->setBool("CompiledThemeCache", false);
+
+	ThemeData xmlTheme;
+	xmlTheme.loadFile("test", std::map<std::string, std::string>(), themePath);
+
+	CHECK(xmlTheme.hasView("system"));
+	CHECK(xmlTheme.isCustomView("mine"));
+	CHECK(xmlTheme.getElement("system", "logo", "image") != nullptr);
+	CHECK(xmlTheme.getElement("system", "logo", "image")->mStoryBoards.size() == 1);
+
+	// The first load with the cache parses the xml & saves the compiled theme, the second one reads it
+	Settings::getInstance()->setBool("CompiledThemeCache", true);
+
+	ThemeData savedTheme;
+	savedTheme.loadFile("test", std::map<std::string, std::string>(), themePath);
+
+	auto compiledFiles = Utils::FileSystem::getDirContent(compiledFolder);
+	CHECK_EQUAL(1, (int)compiledFiles.size());
+
+	std::string compiledPath = compiledFiles.front();
+	auto compiledTime = Utils::FileSystem::getFileModificationDate(compiledPath).getTime();
+	std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+
+	ThemeData compiledTheme;
+	compiledTheme.loadFile("test", std::map<std::string, std::string>(), themePath);
+
+	// Not written again : the compiled theme was used
+	CHECK_EQUAL(compiledTime, Utils::FileSystem::getFileModificationDate(compiledPath).getTime());
+
+	checkSameViews(xmlTheme, savedTheme);
+	checkSameViews(xmlTheme, compiledTheme);
+}
+
+// Components switch on the ThemeProperty ids : the names must be interned to exactly these values
+TEST(ThemeData_storyboardPropertyIds)
+{
+	std::set<std::string> names;
+
+	for (unsigned int id = 1; id < ThemeProperty::COUNT; id++)
+	{
+		std::string name = ThemeData::ThemeElement::getPropertyName(id);
+
+		CHECK(!name.empty());
+		CHECK(names.insert(name).second);
+		CHECK_EQUAL(id, ThemeData::ThemeElement::registerPropertyName(name));
+	}
+
+	CHECK_EQUAL((unsigned int)ThemeProperty::POS, ThemeData::ThemeElement::registerPropertyName("pos"));
+	CHECK_EQUAL((unsigned int)ThemeProperty::OPACITY, ThemeData::ThemeElement::registerPropertyName("opacity"));
+	CHECK_EQUAL((unsigned int)ThemeProperty::VALUE, ThemeData::ThemeElement::registerPropertyName("value"));
+
+	// Animations get their id when the storyboard is read
+	std::string root = Test::getTempPath();
+	std::string themePath = root + "/theme.xml";
+
+	std::ofstream(themePath) << sThemeXml;
+	std::ofstream(root + "/logo.png");
+
+	Settings::getInstance()->setBool("CompiledThemeCache", false);
+
+	ThemeData theme;
+	theme.loadFile("test", std::map<std::string, std::string>(), themePath);
+
+	auto logo = theme.getElement("system", "logo", "image");
+	CHECK(logo != nullptr);
+	CHECK_EQUAL(1, (int)logo->mStoryBoards.size());
+
+	auto& animations = logo->mStoryBoards.begin()->second->animations;
+	CHECK_EQUAL(3, (int)animations.size());
+	CHECK_EQUAL((unsigned int)ThemeProperty::OPACITY, animations[0]->propertyId);
+	CHECK_EQUAL((unsigned int)ThemeProperty::POS, animations[1]->propertyId);
+	CHECK_EQUAL((unsigned int)ThemeProperty::COLOR, animations[2]->propertyId);
+}
@@ -0,0 +1,117 @@
+#include "Test.h"
+
+#include "components/VideoVlcComponent.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// The planes handed to VLC, the pitches & lines it is told and the textures uploaded all come from VideoContext::getPlanes
+TEST(VideoVlc_planarSurfaceLayout)
+{
+	VideoContext context;
+
+	for (auto size : { std::make_pair(2u, 2u), std::make_pair(320u, 240u), std::make_pair(642u, 362u), std::make_pair(1920u, 1080u) })
+	{
+		context.width = size.first;
+		context.height = size.second;
+
+		context.planar = false;
+		CHECK_EQUAL((size_t)size.first * size.second * 4, context.getSurfaceSize());
+
+		context.planar = true;
+		CHECK_EQUAL((size_t)size.first * size.second * 3 / 2, context.getSurfaceSize());
+
+		std::vector<unsigned char> surface(context.getSurfaceSize());
+
+		unsigned char* planes[3];
+		unsigned int widths[3], heights[3];
+		context.getPlanes(surface.data(), planes, widths, heights);
+
+		CHECK_EQUAL(size.first, widths[0]);
+		CHECK_EQUAL(size.second, heights[0]);
+
+		// Chroma planes are half sized, and the three planes fill the surface without overlapping
+		unsigned char* end = surface.data();
+
+		for (int i = 0; i < 3; i++)
+		{
+			if (i > 0)
+			{
+				CHECK_EQUAL(size.first / 2, widths[i]);
+				CHECK_EQUAL(size.second / 2, heights[i]);
+			}
+
+			CHECK(planes[i] == end);
+			end += (size_t)widths[i] * heights[i];
+		}
+
+		CHECK(end == surface.data() + surface.size());
+	}
+}
+
+// Converts an I420 frame to RGBA with the BT.601 limited range equations of the YUV shader
+static void convertI420ToRGBA(unsigned char** planes, unsigned int width, unsigned int height, unsigned char* dst)
+{
+	auto clamp = [](float value) { return (unsigned char)std::min(255.0f, std::max(0.0f, value)); };
+
+	for (unsigned int y = 0; y < height; y++)
+	{
+		const unsigned char* py = planes[0] + y * width;
+		const unsigned char* pu = planes[1] + (y / 2) * (width / 2);
+		const unsigned char* pv = planes[2] + (y / 2) * (width / 2);
+
+		for (unsigned int x = 0; x < width; x++)
+		{
+			float l = 1.1643f * (py[x] - 16.0f);
+			float u = pu[x / 2] - 128.0f;
+			float v = pv[x / 2] - 128.0f;
+
+			unsigned char* px = dst + (y * width + x) * 4;
+			px[0] = clamp(l + 1.5958f * v);
+			px[1] = clamp(l - 0.39173f * u - 0.8129f * v);
+			px[2] = clamp(l + 2.017f * u);
+			px[3] = 255;
+		}
+	}
+}
+
+// What a frame costs the CPU before the upload : a RGBA conversion like the one VLC made, against handing the planes as they are
+BENCHMARK(VideoVlc_planarFrame)
+{
+	const int count = 30;
+
+	VideoContext context;
+	context.width = 1920;
+	context.height = 1080;
+
+	context.planar = true;
+	std::vector<unsigned char> decoded(context.getSurfaceSize());
+	std::vector<unsigned char> planar(context.getSurfaceSize());
+
+	for (size_t i = 0; i < decoded.size(); i++)
+		decoded[i] = (unsigned char)(i * 7);
+
+	context.planar = false;
+	std::vector<unsigned char> rgba(context.getSurfaceSize());
+
+	context.planar = true;
+
+	unsigned char* planes[3];
+	unsigned int widths[3], heights[3];
+	context.getPlanes(decoded.data(), planes, widths, heights);
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < count; i++)
+		convertI420ToRGBA(planes, context.width, context.height, rgba.data());
+
+	auto converted = std::chrono::steady_clock::now();
+	for (int i = 0; i < count; i++)
+		memcpy(planar.data(), decoded.data(), decoded.size());
+
+	auto copied = std::chrono::steady_clock::now();
+
+	std::cout << "  1920x1080 frame : RGBA conversion " << std::chrono::duration<double, std::milli>(converted - start).count() / count << " ms, " << rgba.size() << " bytes"
+		<< " / I420 planes " << std::chrono::duration<double, std::milli>(copied - converted).count() / count << " ms, " << planar.size() << " bytes" << std::endl;
+}
@@ -0,0 +1,96 @@
+#include "Test.h"
+
+#include "utils/ZipFile.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Bit by bit CRC-32 with the zlib polynomial, the definition the table driven versions must match
+static unsigned int referenceCRC(unsigned int crc, const unsigned char* data, size_t size)
+{
+	crc = ~crc;
+
+	for (size_t i = 0; i < size; i++)
+	{
+		crc ^= data[i];
+		for (int bit = 0; bit < 8; bit++)
+			crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+	}
+
+	return ~crc;
+}
+
+static std::vector<unsigned char> getRandomData(size_t size, unsigned int seed)
+{
+	std::mt19937 random(seed);
+	std::vector<unsigned char> data(size);
+
+	for (auto& value : data)
+		value = (unsigned char)random();
+
+	return data;
+}
+
+TEST(ZipFile_computeCRCKnownValues)
+{
+	CHECK_EQUAL(0u, Utils::Zip::ZipFile::computeCRC(0, "", 0));
+	CHECK_EQUAL(0xCBF43926u, Utils::Zip::ZipFile::computeCRC(0, "123456789", 9));
+	CHECK_EQUAL(0x414FA339u, Utils::Zip::ZipFile::computeCRC(0, "The quick brown fox jumps over the lazy dog", 43));
+}
+
+// The 8 bytes loop starts once the pointer is aligned : every offset & length around it must give the same result
+TEST(ZipFile_computeCRCMatchesReference)
+{
+	auto data = getRandomData(4096 + 64, 42);
+
+	for (size_t offset = 0; offset < 16; offset++)
+	{
+		for (size_t size : { 0, 1, 7, 8, 9, 15, 16, 17, 63, 64, 65, 1000, 4096 })
+		{
+			unsigned int expected = referenceCRC(0, data.data() + offset, size);
+			CHECK_EQUAL(expected, Utils::Zip::ZipFile::computeCRC(0, data.data() + offset, size));
+		}
+	}
+}
+
+// Files are hashed by chunks : updating a crc by parts must give the crc of the whole
+TEST(ZipFile_computeCRCSplitUpdates)
+{
+	auto data = getRandomData(100000, 7);
+	unsigned int expected = referenceCRC(0, data.data(), data.size());
+
+	std::mt19937 random(3);
+
+	for (int run = 0; run < 20; run++)
+	{
+		unsigned int crc = 0;
+
+		size_t position = 0;
+		while (position < data.size())
+		{
+			size_t size = std::min(data.size() - position, (size_t)(random() % 5000));
+			crc = Utils::Zip::ZipFile::computeCRC(crc, data.data() + position, size);
+			position += size;
+		}
+
+		CHECK_EQUAL(expected, crc);
+	}
+}
+
+BENCHMARK(ZipFile_computeCRC)
+{
+	auto data = getRandomData(64 * 1024 * 1024, 1);
+
+	auto start = std::chrono::steady_clock::now();
+	unsigned int crc = Utils::Zip::ZipFile::computeCRC(0, data.data(), data.size());
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	unsigned int reference = referenceCRC(0, data.data(), data.size());
+	double referenceSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	CHECK_EQUAL(reference, crc);
+
+	std::cout << "  computeCRC : " << (int)(64 / seconds) << " MB/s, bitwise reference : " << (int)(64 / referenceSeconds) << " MB/s" << std::endl;
+}
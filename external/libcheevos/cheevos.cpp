@@ -200,3 +200,61 @@ bool generateHashFromFile(char hash[33], int console_id, const char* path)
 
 	return false;
 }
+
+bool canGenerateHashFromBuffer(int console_id)
+{
+	// Cartridge based consoles supported by rc_hash_generate_from_buffer
+	switch (console_id)
+	{
+	case RC_CONSOLE_AMSTRAD_PC:
+	case RC_CONSOLE_APPLE_II:
+	case RC_CONSOLE_ARDUBOY:
+	case RC_CONSOLE_ATARI_2600:
+	case RC_CONSOLE_ATARI_7800:
+	case RC_CONSOLE_ATARI_JAGUAR:
+	case RC_CONSOLE_ATARI_LYNX:
+	case RC_CONSOLE_COLECOVISION:
+	case RC_CONSOLE_GAMEBOY:
+	case RC_CONSOLE_GAMEBOY_ADVANCE:
+	case RC_CONSOLE_GAMEBOY_COLOR:
+	case RC_CONSOLE_GAME_GEAR:
+	case RC_CONSOLE_INTELLIVISION:
+	case RC_CONSOLE_MAGNAVOX_ODYSSEY2:
+	case RC_CONSOLE_MASTER_SYSTEM:
+	case RC_CONSOLE_MEGA_DRIVE:
+	case RC_CONSOLE_MEGADUCK:
+	case RC_CONSOLE_MSX:
+	case RC_CONSOLE_NEOGEO_POCKET:
+	case RC_CONSOLE_NINTENDO:
+	case RC_CONSOLE_NINTENDO_64:
+	case RC_CONSOLE_NINTENDO_DS:
+	case RC_CONSOLE_ORIC:
+	case RC_CONSOLE_PC8800:
+	case RC_CONSOLE_PC_ENGINE:
+	case RC_CONSOLE_POKEMON_MINI:
+	case RC_CONSOLE_SEGA_32X:
+	case RC_CONSOLE_SG1000:
+	case RC_CONSOLE_SUPER_NINTENDO:
+	case RC_CONSOLE_SUPERVISION:
+	case RC_CONSOLE_TIC80:
+	case RC_CONSOLE_VECTREX:
+	case RC_CONSOLE_VIRTUAL_BOY:
+	case RC_CONSOLE_WONDERSWAN:
+		return true;
+	}
+
+	return false;
+}
+
+bool generateHashFromBuffer(char hash[33], int console_id, const unsigned char* buffer, size_t size)
+{
+	try
+	{
+		return rc_hash_generate_from_buffer(hash, console_id, buffer, size) != 0;
+	}
+	catch (...)
+	{
+	}
+
+	return false;
+}
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <stddef.h>
 #include "rcheevos/include/rc_consoles.h"
 
 bool generateHashFromFile(char hash[33], int console_id, const char* path);
+
+// Roms of cartridge based consoles can be hashed from memory
+bool canGenerateHashFromBuffer(int console_id);
+bool generateHashFromBuffer(char hash[33], int console_id, const unsigned char* buffer, size_t size);